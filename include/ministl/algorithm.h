@@ -1,22 +1,204 @@
+#pragma once
 #include <ministl/iterator.h>
+#include <ministl/reverse_iterator.h>
+#include <ministl/functional.h>
 #include <ministl/log.h>
 #include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 namespace ministl
 {
 
+/**
+ * contiguous ranges reached through a wrapper, a class iterator or a
+ * reverse_iterator over contiguous memory, are unwrapped to raw pointers
+ * before fill, reverse, find and sort, so they take the same bulk paths as
+ * plain pointers in either direction.
+ */
+namespace contiguous_detail
+{
+
+template<typename Iter>
+struct is_reversed : ministl::false_type {};
+
+template<typename Iter>
+struct is_reversed<ministl::reverse_iterator<Iter>> {
+    constexpr static bool value = ministl::is_contiguous_iterator<Iter>::value;
+};
+
+// reverse_iterator over contiguous memory
+template<typename Iter>
+constexpr bool is_reversed_v = is_reversed<Iter>::value;
+
+// contiguous class iterator
+template<typename Iter>
+constexpr bool is_wrapped_v = ministl::is_contiguous_iterator<Iter>::value && !std::is_pointer_v<Iter>;
+
+template<typename Iter>
+using element_t = std::remove_cv_t<std::remove_pointer_t<Iter>>;
+
+// pointer to 2, 4 or 8 byte integers, searched 32 bytes at a time
+template<typename Iter, typename ValueType>
+constexpr bool is_simd_find_v = std::is_pointer_v<Iter> && std::is_integral_v<element_t<Iter>> &&
+    !std::is_same_v<element_t<Iter>, bool> && std::is_integral_v<ValueType> &&
+    (sizeof (element_t<Iter>) == 2 || sizeof (element_t<Iter>) == 4 || sizeof (element_t<Iter>) == 8);
+
+// pointer to trivially copyable 1, 2, 4 or 8 byte elements, reversed 32 bytes at a time
+template<typename Iter>
+constexpr bool is_simd_reverse_v = std::is_pointer_v<Iter> && !std::is_const_v<std::remove_pointer_t<Iter>> &&
+    std::is_trivially_copyable_v<element_t<Iter>> &&
+    (sizeof (element_t<Iter>) == 1 || sizeof (element_t<Iter>) == 2 ||
+     sizeof (element_t<Iter>) == 4 || sizeof (element_t<Iter>) == 8);
+
+/**
+ * whether some element can equal target. compared the way *i == target
+ * compares, after promotion: a short -1 never equals a uint16_t 0xffff
+ */
+template<typename T, typename ValueType>
+bool representable(const ValueType& target) {
+    return static_cast<T>(target) == target;
+}
+
+#if defined(__x86_64__)
+
+inline bool has_avx2() {
+    static const bool res = __builtin_cpu_supports("avx2");
+    return res;
+}
+
+template<size_t Size>
+__attribute__((target("avx2")))
+inline __m256i broadcast(uint64_t val) {
+    if constexpr (Size == 2) return _mm256_set1_epi16(short(val));
+    else if constexpr (Size == 4) return _mm256_set1_epi32(int(val));
+    else return _mm256_set1_epi64x((long long)(val));
+}
+
+// byte mask of the lanes of block equal to needle
+template<size_t Size>
+__attribute__((target("avx2")))
+inline uint32_t match_mask(const void* block, __m256i needle) {
+    auto val = _mm256_loadu_si256(static_cast<const __m256i*>(block));
+    if constexpr (Size == 2) return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi16(val, needle)));
+    else if constexpr (Size == 4) return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi32(val, needle)));
+    else return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi64(val, needle)));
+}
+
+/**
+ * first match in [first, last), or last. two blocks are tested per
+ * iteration with a single branch, the scalar tail finishes the rest.
+ */
+template<typename T>
+__attribute__((target("avx2")))
+const T* find_avx2(const T* first, const T* last, T target) {
+    constexpr ptrdiff_t lanes = 32 / sizeof (T);
+    auto needle = broadcast<sizeof (T)>(uint64_t(target));
+    for (; last - first >= lanes * 2; first += lanes * 2) {
+        auto lo = match_mask<sizeof (T)>(first, needle), hi = match_mask<sizeof (T)>(first + lanes, needle);
+        if (lo | hi) {
+            if (lo) return first + __builtin_ctz(lo) / sizeof (T);
+            return first + lanes + __builtin_ctz(hi) / sizeof (T);
+        }
+    }
+    for (; first != last; first ++ ) {
+        if (*first == target) return first;
+    }
+    return last;
+}
+
+// last match in [first, last), or last
+template<typename T>
+__attribute__((target("avx2")))
+const T* find_last_avx2(const T* first, const T* last, T target) {
+    constexpr ptrdiff_t lanes = 32 / sizeof (T);
+    auto needle = broadcast<sizeof (T)>(uint64_t(target));
+    auto cur = last;
+    for (; cur - first >= lanes * 2; cur -= lanes * 2) {
+        auto lo = match_mask<sizeof (T)>(cur - lanes * 2, needle), hi = match_mask<sizeof (T)>(cur - lanes, needle);
+        if (lo | hi) {
+            if (hi) return cur - lanes + (31 - __builtin_clz(hi)) / sizeof (T);
+            return cur - lanes * 2 + (31 - __builtin_clz(lo)) / sizeof (T);
+        }
+    }
+    while (cur != first) {
+        if (*( -- cur) == target) return cur;
+    }
+    return last;
+}
+
+// pshufb mask reversing the order of Size byte elements in a 16 byte lane
+template<size_t Size>
+struct reverse_table {
+    alignas(32) uint8_t mask[32];
+
+    constexpr reverse_table() : mask() {
+        for (int i = 0; i < 32; i ++ ) mask[i] = uint8_t(((15 - i % 16) / Size * Size) + i % Size);
+    }
+};
+
+template<size_t Size>
+inline constexpr reverse_table<Size> reverse_masks {};
+
+/**
+ * swaps 32 byte blocks from both ends, each reversed with an in-lane
+ * pshufb followed by a lane swap. first and last meet in the middle with
+ * less than 64 bytes left for the scalar loop.
+ */
+template<size_t Size>
+__attribute__((target("avx2")))
+void reverse_avx2(unsigned char*& first, unsigned char*& last) {
+    auto mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(reverse_masks<Size>.mask));
+    while (last - first >= 64) {
+        last -= 32;
+        auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last));
+        lo = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(lo, mask), 0x4e);
+        hi = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(hi, mask), 0x4e);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(first), hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(last), lo);
+        first += 32;
+    }
+}
+
+#endif
+
+}
+
 template<typename Iter, typename ValueType>
 void fill(Iter begin, Iter end, const ValueType& val) {
-    for (auto it = begin; it != end; it ++ ) {
-        *it = val;
+    if constexpr (contiguous_detail::is_reversed_v<Iter>) {
+        // every element gets the same value, direction does not matter
+        ministl::fill(end.base(), begin.base(), val);
+    } else if constexpr (contiguous_detail::is_wrapped_v<Iter>) {
+        if (begin == end) return;
+        auto first = ministl::to_address(begin);
+        ministl::fill(first, first + (end - begin), val);
+    } else if constexpr (std::is_pointer_v<Iter> && sizeof (contiguous_detail::element_t<Iter>) == 1 &&
+                         std::is_integral_v<contiguous_detail::element_t<Iter>> && std::is_integral_v<ValueType>) {
+        contiguous_detail::element_t<Iter> byte = val;
+        if (begin < end) std::memset(begin, static_cast<unsigned char>(byte), end - begin);
+    } else {
+        for (auto it = begin; it != end; it ++ ) {
+            *it = val;
+        }
     }
 }
 
 template<typename ValueType>
 void swap(ValueType& first, ValueType& second) {
-    auto tmp = first;
-    first = second;
-    second = tmp;
+    auto tmp = std::move(first);
+    first = std::move(second);
+    second = std::move(tmp);
 }
 
 // TODO: replace std::function with ministl ver.
@@ -24,17 +206,26 @@ template<typename Iter>
 void sort(Iter begin, Iter end, std::function<bool(
             typename ministl::iterator_traits<Iter>::value_type,
             typename ministl::iterator_traits<Iter>::value_type)> cmp) {
-    if (begin + 1 >= end) return;
-    auto left = begin - 1, right = end;
-    auto pivot = *begin; // TODO: random pivot
-    while (left < right) {
-        do left ++ ; while (cmp(*left, pivot) && *left != pivot);
-        do right -- ; while (!cmp(*right, pivot) && *right != pivot);
-        if (left < right) swap(*left, *right);
+    if constexpr (contiguous_detail::is_reversed_v<Iter>) {
+        // ascending backwards is descending forwards
+        ministl::sort(end.base(), begin.base(), [&cmp](auto first, auto second) { return cmp(second, first); });
+    } else if constexpr (contiguous_detail::is_wrapped_v<Iter>) {
+        if (begin == end) return;
+        auto first = ministl::to_address(begin);
+        ministl::sort(first, first + (end - begin), cmp);
+    } else {
+        if (begin + 1 >= end) return;
+        auto left = begin - 1, right = end;
+        auto pivot = *begin; // TODO: random pivot
+        while (left < right) {
+            do left ++ ; while (cmp(*left, pivot) && *left != pivot);
+            do right -- ; while (!cmp(*right, pivot) && *right != pivot);
+            if (left < right) swap(*left, *right);
+        }
+        right ++ ;
+        sort(begin, right, cmp);
+        sort(right, end, cmp);
     }
-    right ++ ;
-    sort(begin, right, cmp);
-    sort(right, end, cmp);
 }
 
 template<typename Iter>
@@ -44,17 +235,1200 @@ void sort(Iter begin, Iter end) {
 
 template<typename Iter>
 void reverse(Iter begin, Iter end) {
-    for (auto i = begin, j = end - 1; i < j; i ++ , j -- ) {
-        swap(*i, *j);
+    if constexpr (contiguous_detail::is_reversed_v<Iter>) {
+        // the same pairs are swapped either way
+        ministl::reverse(end.base(), begin.base());
+    } else if constexpr (contiguous_detail::is_wrapped_v<Iter>) {
+        if (begin == end) return;
+        auto first = ministl::to_address(begin);
+        ministl::reverse(first, first + (end - begin));
+    } else {
+#if defined(__x86_64__)
+        if constexpr (contiguous_detail::is_simd_reverse_v<Iter>) {
+            constexpr size_t size = sizeof (*begin);
+            if (end - begin >= ptrdiff_t(64 / size) && contiguous_detail::has_avx2()) {
+                auto first = reinterpret_cast<unsigned char*>(begin), last = reinterpret_cast<unsigned char*>(end);
+                contiguous_detail::reverse_avx2<size>(first, last);
+                begin = reinterpret_cast<Iter>(first), end = reinterpret_cast<Iter>(last);
+            }
+        }
+#endif
+        for (auto i = begin, j = end - 1; i < j; i ++ , j -- ) {
+            swap(*i, *j);
+        }
     }
 }
 
+/**
+ * byte-sized scalar behind a raw pointer.
+ * these ranges are handed to libc memchr/memcmp, which are already vectorized.
+ */
+template<typename Iter>
+constexpr bool is_byte_pointer_v = std::is_pointer_v<Iter> &&
+    std::is_integral_v<std::remove_cv_t<std::remove_pointer_t<Iter>>> &&
+    sizeof (std::remove_pointer_t<Iter>) == 1;
+
+/**
+ * unsigned byte pointers, whose order is the order of memcmp. signed and
+ * plain char (signed on x86) stay on the element-wise path
+ */
+template<typename Iter, typename Byte = std::remove_cv_t<std::remove_pointer_t<Iter>>>
+constexpr bool is_unsigned_byte_pointer_v = is_byte_pointer_v<Iter> &&
+    std::is_unsigned_v<Byte> && !std::is_same_v<Byte, bool>;
+
+template<typename Iter, typename ValueType>
+Iter find_last(Iter begin, Iter end, ValueType target);
+
 template<typename Iter, typename ValueType>
 Iter find(Iter begin, Iter end, ValueType target) {
-    for (auto i = begin; i != end; i ++ ) {
-        if (*i == target) return i;
+    if constexpr (contiguous_detail::is_reversed_v<Iter>) {
+        // the first match backwards is the last one forwards
+        auto first = end.base(), last = begin.base();
+        auto res = ministl::find_last(first, last, target);
+        return res == last ? end : Iter(++ res);
+    } else if constexpr (contiguous_detail::is_wrapped_v<Iter>) {
+        if (begin == end) return end;
+        auto first = ministl::to_address(begin);
+        return begin + (ministl::find(first, first + (end - begin), target) - first);
+    } else if constexpr (is_byte_pointer_v<Iter> && std::is_integral_v<ValueType>) {
+        using value_type = std::remove_cv_t<std::remove_pointer_t<Iter>>;
+        if (!contiguous_detail::representable<value_type>(target)) return end;
+        if (begin >= end) return end;
+        auto res = std::memchr(begin, static_cast<unsigned char>(target), end - begin);
+        return res ? static_cast<Iter>(res) : end;
+    } else {
+#if defined(__x86_64__)
+        if constexpr (contiguous_detail::is_simd_find_v<Iter, ValueType>) {
+            using value_type = contiguous_detail::element_t<Iter>;
+            if (!contiguous_detail::representable<value_type>(target)) return end;
+            if (contiguous_detail::has_avx2()) {
+                auto res = contiguous_detail::find_avx2<value_type>(begin, end, value_type(target));
+                return begin + (res - begin);
+            }
+        }
+#endif
+        for (auto i = begin; i != end; i ++ ) {
+            if (*i == target) return i;
+        }
+        return end;
+    }
+}
+
+/**
+ * last element equal to target, or end if there is none.
+ * needs a bidirectional range, contiguous ones are searched backwards in
+ * blocks like find.
+ */
+template<typename Iter, typename ValueType>
+Iter find_last(Iter begin, Iter end, ValueType target) {
+    if constexpr (contiguous_detail::is_reversed_v<Iter>) {
+        auto first = end.base(), last = begin.base();
+        auto res = ministl::find(first, last, target);
+        return res == last ? end : Iter(++ res);
+    } else if constexpr (contiguous_detail::is_wrapped_v<Iter>) {
+        if (begin == end) return end;
+        auto first = ministl::to_address(begin);
+        return begin + (ministl::find_last(first, first + (end - begin), target) - first);
+    } else if constexpr (is_byte_pointer_v<Iter> && std::is_integral_v<ValueType>) {
+        using value_type = std::remove_cv_t<std::remove_pointer_t<Iter>>;
+        if (!contiguous_detail::representable<value_type>(target)) return end;
+        if (begin >= end) return end;
+        auto res = ::memrchr(begin, static_cast<unsigned char>(target), end - begin);
+        return res ? static_cast<Iter>(res) : end;
+    } else {
+#if defined(__x86_64__)
+        if constexpr (contiguous_detail::is_simd_find_v<Iter, ValueType>) {
+            using value_type = contiguous_detail::element_t<Iter>;
+            if (!contiguous_detail::representable<value_type>(target)) return end;
+            if (contiguous_detail::has_avx2()) {
+                auto res = contiguous_detail::find_last_avx2<value_type>(begin, end, value_type(target));
+                return begin + (res - begin);
+            }
+        }
+#endif
+        for (auto i = end; i != begin; ) {
+            if (*( -- i) == target) return i;
+        }
+        return end;
+    }
+}
+
+/**
+ * compare [first1, last1) with the range starting at first2
+ */
+template<typename Iter1, typename Iter2>
+bool equal(Iter1 first1, Iter1 last1, Iter2 first2) {
+    if constexpr (is_byte_pointer_v<Iter1> && is_byte_pointer_v<Iter2>) {
+        return first1 >= last1 || std::memcmp(first1, first2, last1 - first1) == 0;
+    } else {
+        for (; first1 != last1; ++ first1, ++ first2) {
+            if (!(*first1 == *first2)) return false;
+        }
+        return true;
+    }
+}
+
+/**
+ * three way lexicographical compare, returns <0, 0 or >0.
+ * elements compare with operator<, unsigned bytes through memcmp
+ */
+template<typename Iter1, typename Iter2>
+int lexicographical_compare_three_way(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    auto len1 = ministl::distance(first1, last1), len2 = ministl::distance(first2, last2);
+    auto n = len1 < len2 ? len1 : len2;
+    if constexpr (is_unsigned_byte_pointer_v<Iter1> && is_unsigned_byte_pointer_v<Iter2>) {
+        int res = n > 0 ? std::memcmp(first1, first2, n) : 0;
+        if (res) return res;
+    } else {
+        for (decltype(n) i = 0; i < n; i ++ , ++ first1, ++ first2) {
+            if (*first1 < *first2) return -1;
+            if (*first2 < *first1) return 1;
+        }
+    }
+    return len1 < len2 ? -1 : (len1 > len2 ? 1 : 0);
+}
+
+template<typename Iter1, typename Iter2>
+bool lexicographical_compare(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    return lexicographical_compare_three_way(first1, last1, first2, last2) < 0;
+}
+
+/**
+ * find the first occurrence of [s_first, s_last) in [first, last).
+ * byte ranges scan for the first needle byte with memchr and verify with memcmp
+ */
+template<typename Iter1, typename Iter2>
+Iter1 search(Iter1 first, Iter1 last, Iter2 s_first, Iter2 s_last) {
+    if (s_first == s_last) return first;
+    if constexpr (is_byte_pointer_v<Iter1> && is_byte_pointer_v<Iter2>) {
+        auto n = s_last - s_first;
+        if (last - first < n) return last;
+        auto stop = last - n + 1; // last possible start position + 1
+        for (auto cur = first; cur < stop; cur ++ ) {
+            cur = ministl::find(cur, stop, *s_first);
+            if (cur == stop) return last;
+            if (std::memcmp(cur + 1, s_first + 1, n - 1) == 0) return cur;
+        }
+        return last;
+    } else {
+        for (; ; ++ first) {
+            auto it = first;
+            for (auto s_it = s_first; ; ++ it, ++ s_it) {
+                if (s_it == s_last) return first;
+                if (it == last) return last;
+                if (!(*it == *s_it)) break;
+            }
+        }
+    }
+}
+
+/**
+ * heap operations. the range is a max heap with respect to cmp,
+ * i.e. *first is the element that is not less than any other
+ */
+template<typename Iter, typename DistanceType, typename Compare>
+void sift_down(Iter first, DistanceType len, DistanceType idx, Compare cmp) {
+    auto val = *(first + idx);
+    while (true) {
+        auto child = 2 * idx + 1;
+        if (child >= len) break;
+        if (child + 1 < len && cmp(*(first + child), *(first + child + 1))) child ++ ;
+        if (!cmp(val, *(first + child))) break;
+        *(first + idx) = *(first + child);
+        idx = child;
+    }
+    *(first + idx) = val;
+}
+
+template<typename Iter, typename Compare>
+void make_heap(Iter first, Iter last, Compare cmp) {
+    auto len = last - first;
+    for (auto i = len / 2; i -- > 0; ) ministl::sift_down(first, len, i, cmp);
+}
+
+template<typename Iter>
+void make_heap(Iter first, Iter last) {
+    ministl::make_heap(first, last, ministl::less<> {});
+}
+
+// the new element is *(last - 1)
+template<typename Iter, typename Compare>
+void push_heap(Iter first, Iter last, Compare cmp) {
+    auto idx = last - first - 1;
+    if (idx <= 0) return;
+    auto val = *(first + idx);
+    while (idx > 0) {
+        auto parent = (idx - 1) / 2;
+        if (!cmp(*(first + parent), val)) break;
+        *(first + idx) = *(first + parent);
+        idx = parent;
     }
-    return end;
+    *(first + idx) = val;
+}
+
+template<typename Iter>
+void push_heap(Iter first, Iter last) {
+    ministl::push_heap(first, last, ministl::less<> {});
+}
+
+// move the top to *(last - 1) and restore the heap on [first, last - 1)
+template<typename Iter, typename Compare>
+void pop_heap(Iter first, Iter last, Compare cmp) {
+    auto len = last - first;
+    if (len <= 1) return;
+    ministl::swap(*first, *(last - 1));
+    ministl::sift_down(first, len - 1, decltype(len) {0}, cmp);
+}
+
+template<typename Iter>
+void pop_heap(Iter first, Iter last) {
+    ministl::pop_heap(first, last, ministl::less<> {});
+}
+
+template<typename Iter, typename Compare>
+void sort_heap(Iter first, Iter last, Compare cmp) {
+    for (; last - first > 1; -- last) ministl::pop_heap(first, last, cmp);
+}
+
+template<typename Iter>
+void sort_heap(Iter first, Iter last) {
+    ministl::sort_heap(first, last, ministl::less<> {});
+}
+
+/**
+ * selection algorithms
+ */
+
+template<typename Iter, typename Compare>
+void insertion_sort(Iter first, Iter last, Compare cmp) {
+    if (first == last) return;
+    for (auto i = first + 1; i < last; i ++ ) {
+        auto val = *i;
+        auto j = i;
+        for (; j > first && cmp(val, *(j - 1)); j -- ) *j = *(j - 1);
+        *j = val;
+    }
+}
+
+/**
+ * partition around the pivot stored at *first, then move the pivot to its
+ * final position and return it. elements equal to the pivot stop both
+ * scans, so runs of duplicates still split in the middle
+ */
+template<typename Iter, typename Compare>
+Iter partition_pivot(Iter first, Iter last, Compare cmp) {
+    auto i = first, j = last;
+    while (true) {
+        do i ++ ; while (i < last && cmp(*i, *first));
+        do j -- ; while (cmp(*first, *j));
+        if (i >= j) break;
+        ministl::swap(*i, *j);
+    }
+    ministl::swap(*first, *j);
+    return j;
+}
+
+template<typename Iter, typename Compare>
+Iter median_of_three(Iter a, Iter b, Iter c, Compare cmp) {
+    if (cmp(*a, *b)) {
+        if (cmp(*b, *c)) return b;
+        return cmp(*a, *c) ? c : a;
+    }
+    if (cmp(*a, *c)) return a;
+    return cmp(*b, *c) ? c : b;
+}
+
+template<typename Iter, typename Compare>
+void select_median_of_medians(Iter first, Iter nth, Iter last, Compare cmp);
+
+/**
+ * median of medians: sort groups of 5, gather their medians at the front
+ * and select the median of those. the pivot is guaranteed to be greater
+ * than ~30% of the range and less than another ~30%
+ */
+template<typename Iter, typename Compare>
+Iter pivot_median_of_medians(Iter first, Iter last, Compare cmp) {
+    auto len = last - first;
+    if (len <= 5) {
+        ministl::insertion_sort(first, last, cmp);
+        return first + len / 2;
+    }
+    auto medians = first;
+    for (auto group = first; last - group >= 5; group += 5) {
+        ministl::insertion_sort(group, group + 5, cmp);
+        ministl::swap(*(group + 2), *medians);
+        medians ++ ;
+    }
+    auto mid = first + (medians - first) / 2;
+    ministl::select_median_of_medians(first, mid, medians, cmp);
+    return mid;
+}
+
+template<typename Iter, typename Compare>
+void select_median_of_medians(Iter first, Iter nth, Iter last, Compare cmp) {
+    while (last - first > 16) {
+        auto pivot = ministl::pivot_median_of_medians(first, last, cmp);
+        ministl::swap(*first, *pivot);
+        auto mid = ministl::partition_pivot(first, last, cmp);
+        if (mid == nth) return;
+        if (nth < mid) last = mid;
+        else first = mid + 1;
+    }
+    ministl::insertion_sort(first, last, cmp);
+}
+
+/**
+ * introselect: quickselect with median-of-3 pivots, switching to the linear
+ * worst case median of medians once the partitions stop shrinking.
+ * after the call *nth is the element a full sort would put there,
+ * nothing before it is greater and nothing after it is less.
+ */
+template<typename Iter, typename Compare>
+void nth_element(Iter first, Iter nth, Iter last, Compare cmp) {
+    if (nth >= last || last - first <= 1) return;
+    int depth_limit = 0;
+    for (auto n = last - first; n > 1; n >>= 1) depth_limit += 2;
+
+    while (last - first > 16) {
+        if (depth_limit -- == 0) {
+            ministl::select_median_of_medians(first, nth, last, cmp);
+            return;
+        }
+        auto pivot = ministl::median_of_three(first, first + (last - first) / 2, last - 1, cmp);
+        ministl::swap(*first, *pivot);
+        auto mid = ministl::partition_pivot(first, last, cmp);
+        if (mid == nth) return;
+        if (nth < mid) last = mid;
+        else first = mid + 1;
+    }
+    ministl::insertion_sort(first, last, cmp);
+}
+
+template<typename Iter>
+void nth_element(Iter first, Iter nth, Iter last) {
+    ministl::nth_element(first, nth, last, ministl::less<> {});
+}
+
+/**
+ * sort the smallest (middle - first) elements into [first, middle),
+ * the rest is left in unspecified order. O(n log k)
+ */
+template<typename Iter, typename Compare>
+void partial_sort(Iter first, Iter middle, Iter last, Compare cmp) {
+    if (first == middle) return;
+    ministl::make_heap(first, middle, cmp);
+    auto len = middle - first;
+    for (auto i = middle; i < last; i ++ ) {
+        if (cmp(*i, *first)) {
+            ministl::swap(*i, *first);
+            ministl::sift_down(first, len, decltype(len) {0}, cmp);
+        }
+    }
+    ministl::sort_heap(first, middle, cmp);
+}
+
+template<typename Iter>
+void partial_sort(Iter first, Iter middle, Iter last) {
+    ministl::partial_sort(first, middle, last, ministl::less<> {});
+}
+
+/**
+ * copy the smallest min(last - first, r_last - r_first) elements of
+ * [first, last) in sorted order into [r_first, ...), return the end of the copy
+ */
+template<typename InputIter, typename Iter, typename Compare>
+Iter partial_sort_copy(InputIter first, InputIter last, Iter r_first, Iter r_last, Compare cmp) {
+    auto r_it = r_first;
+    for (; first != last && r_it != r_last; ++ first, ++ r_it) *r_it = *first;
+    auto len = r_it - r_first;
+    if (len == 0) return r_it;
+    ministl::make_heap(r_first, r_it, cmp);
+    for (; first != last; ++ first) {
+        if (cmp(*first, *r_first)) {
+            *r_first = *first;
+            ministl::sift_down(r_first, len, decltype(len) {0}, cmp);
+        }
+    }
+    ministl::sort_heap(r_first, r_it, cmp);
+    return r_it;
+}
+
+template<typename InputIter, typename Iter>
+Iter partial_sort_copy(InputIter first, InputIter last, Iter r_first, Iter r_last) {
+    return ministl::partial_sort_copy(first, last, r_first, r_last, ministl::less<> {});
+}
+
+/**
+ * copy / move ranges
+ */
+template<typename InputIter, typename OutIter>
+OutIter copy(InputIter first, InputIter last, OutIter out) {
+    for (; first != last; ++ first, ++ out) *out = *first;
+    return out;
+}
+
+template<typename InputIter, typename OutIter>
+OutIter move(InputIter first, InputIter last, OutIter out) {
+    for (; first != last; ++ first, ++ out) *out = std::move(*first);
+    return out;
+}
+
+// fill [.., out_last) backwards, safe when out_last is inside [first, last)
+template<typename Iter, typename OutIter>
+OutIter move_backward(Iter first, Iter last, OutIter out_last) {
+    while (first != last) *( -- out_last) = std::move(*( -- last));
+    return out_last;
+}
+
+/**
+ * swap [first, middle) and [middle, last), return the new position of *first
+ */
+template<typename Iter>
+Iter rotate(Iter first, Iter middle, Iter last) {
+    if (first == middle) return last;
+    if (middle == last) return first;
+    ministl::reverse(first, middle);
+    ministl::reverse(middle, last);
+    ministl::reverse(first, last);
+    return first + (last - middle);
+}
+
+/**
+ * binary search
+ */
+
+// first element for which pred is false, pred must be true on a prefix
+template<typename Iter, typename Predicate>
+Iter partition_point(Iter first, Iter last, Predicate pred) {
+    auto len = ministl::distance(first, last);
+    while (len > 0) {
+        auto half = len / 2;
+        auto mid = first;
+        ministl::advance(mid, half);
+        if (pred(*mid)) {
+            first = ++ mid;
+            len -= half + 1;
+        } else {
+            len = half;
+        }
+    }
+    return first;
+}
+
+template<typename Iter, typename ValueType, typename Compare>
+Iter lower_bound(Iter first, Iter last, const ValueType& val, Compare cmp) {
+    return ministl::partition_point(first, last, [&](const auto& x) { return cmp(x, val); });
+}
+
+template<typename Iter, typename ValueType>
+Iter lower_bound(Iter first, Iter last, const ValueType& val) {
+    return ministl::lower_bound(first, last, val, ministl::less<> {});
+}
+
+template<typename Iter, typename ValueType, typename Compare>
+Iter upper_bound(Iter first, Iter last, const ValueType& val, Compare cmp) {
+    return ministl::partition_point(first, last, [&](const auto& x) { return !cmp(val, x); });
+}
+
+template<typename Iter, typename ValueType>
+Iter upper_bound(Iter first, Iter last, const ValueType& val) {
+    return ministl::upper_bound(first, last, val, ministl::less<> {});
+}
+
+/**
+ * galloping (exponential) search, cheaper than plain binary search when
+ * the answer is close to the end we start from. O(log k) for an answer at
+ * distance k. gallop_left probes first, first + 2, first + 6, first + 14 ...,
+ * gallop_right probes last - 1, last - 3, last - 7 ...
+ */
+template<typename Iter, typename Predicate>
+Iter gallop_left(Iter first, Iter last, Predicate pred) {
+    auto len = last - first;
+    decltype(len) prev = 0, ofs = 1;
+    while (ofs <= len && pred(*(first + (ofs - 1)))) {
+        prev = ofs;
+        ofs = ofs * 2 + 1;
+    }
+    auto hi = ofs <= len ? ofs - 1 : len;
+    return ministl::partition_point(first + prev, first + hi, pred);
+}
+
+template<typename Iter, typename Predicate>
+Iter gallop_right(Iter first, Iter last, Predicate pred) {
+    auto len = last - first;
+    decltype(len) prev = 0, ofs = 1;
+    while (ofs <= len && !pred(*(last - ofs))) {
+        prev = ofs;
+        ofs = ofs * 2 + 1;
+    }
+    auto lo = ofs <= len ? len - ofs + 1 : 0;
+    return ministl::partition_point(first + lo, last - prev, pred);
+}
+
+/**
+ * merge two sorted ranges into out. stable: on ties the first range wins
+ */
+template<typename Iter1, typename Iter2, typename OutIter, typename Compare>
+OutIter merge(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out, Compare cmp) {
+    while (first1 != last1 && first2 != last2) {
+        if (cmp(*first2, *first1)) {
+            *out = *first2;
+            ++ first2;
+        } else {
+            *out = *first1;
+            ++ first1;
+        }
+        ++ out;
+    }
+    out = ministl::copy(first1, last1, out);
+    return ministl::copy(first2, last2, out);
+}
+
+template<typename Iter1, typename Iter2, typename OutIter>
+OutIter merge(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out) {
+    return ministl::merge(first1, last1, first2, last2, out, ministl::less<> {});
+}
+
+/**
+ * scratch storage of constructed elements for merging.
+ * asks for the requested length and halves it until the allocation succeeds,
+ * so callers get as much as memory allows (possibly nothing).
+ * trivial types are left uninitialized. anything else is constructed by a
+ * chain of moves that starts and ends at seed, so T only has to be movable
+ * and seed keeps its value; if a move throws, the buffer is released again.
+ */
+template<typename T>
+class temporary_buffer {
+private:
+    T* buf;
+    size_t len;
+
+    void release() noexcept {
+        for (size_t i = 0; i < len; i ++ ) buf[i].~T();
+        ::operator delete(buf);
+        buf = nullptr, len = 0;
+    }
+
+public:
+    temporary_buffer(size_t requested, T& seed) : buf(nullptr), len(0) {
+        while (requested > 0) {
+            buf = static_cast<T*>(::operator new(requested * sizeof (T), std::nothrow));
+            if (buf) break;
+            requested >>= 1;
+        }
+        if (!buf) return;
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>) {
+            len = requested;
+        } else {
+            try {
+                ::new (buf) T(std::move(seed));
+                for (len = 1; len < requested; len ++ ) ::new (buf + len) T(std::move(buf[len - 1]));
+                seed = std::move(buf[len - 1]);
+            } catch (...) {
+                if (len) seed = std::move(buf[len - 1]);
+                release();
+                throw;
+            }
+        }
+    }
+
+    temporary_buffer(const temporary_buffer&) = delete;
+
+    temporary_buffer& operator=(const temporary_buffer&) = delete;
+
+    ~temporary_buffer() { release(); }
+
+    T* begin() const noexcept { return buf; }
+
+    T* end() const noexcept { return buf + len; }
+
+    size_t size() const noexcept { return len; }
+};
+
+/**
+ * stable merge of [first, middle) and [middle, last) helpers.
+ * merge_lo moves the left run into buffer and merges forward,
+ * merge_hi moves the right run into buffer and merges backward.
+ * when one side keeps winning (min_gallop times in a row) they switch to
+ * galloping and move whole blocks found by exponential search, like TimSort.
+ */
+constexpr int min_gallop = 7;
+
+template<typename Iter, typename Pointer, typename Compare>
+void merge_lo(Iter first, Iter middle, Iter last, Pointer buffer, Compare cmp) {
+    auto buf_first = buffer, buf_last = ministl::move(first, middle, buffer);
+    auto out = first, right = middle;
+    while (buf_first != buf_last && right != last) {
+        int count_left = 0, count_right = 0;
+        while (buf_first != buf_last && right != last) {
+            if (cmp(*right, *buf_first)) {
+                *out = std::move(*right);
+                ++ out, ++ right;
+                count_left = 0;
+                if ( ++ count_right >= min_gallop) break;
+            } else {
+                *out = std::move(*buf_first);
+                ++ out, ++ buf_first;
+                count_right = 0;
+                if ( ++ count_left >= min_gallop) break;
+            }
+        }
+        while (buf_first != buf_last && right != last) {
+            auto& right_val = *right;
+            auto buf_stop = ministl::gallop_left(buf_first, buf_last,
+                    [&](const auto& x) { return !cmp(right_val, x); });
+            count_left = buf_stop - buf_first;
+            out = ministl::move(buf_first, buf_stop, out);
+            buf_first = buf_stop;
+            if (buf_first == buf_last) break;
+
+            auto& left_val = *buf_first;
+            auto right_stop = ministl::gallop_left(right, last,
+                    [&](const auto& x) { return cmp(x, left_val); });
+            count_right = right_stop - right;
+            out = ministl::move(right, right_stop, out);
+            right = right_stop;
+            if (count_left < min_gallop && count_right < min_gallop) break;
+        }
+    }
+    // whatever is left of the right run is already in place
+    ministl::move(buf_first, buf_last, out);
+}
+
+template<typename Iter, typename Pointer, typename Compare>
+void merge_hi(Iter first, Iter middle, Iter last, Pointer buffer, Compare cmp) {
+    auto buf_first = buffer, buf_last = ministl::move(middle, last, buffer);
+    auto out = last, left = middle;
+    while (buf_first != buf_last && left != first) {
+        int count_left = 0, count_right = 0;
+        while (buf_first != buf_last && left != first) {
+            if (cmp(*(buf_last - 1), *(left - 1))) {
+                *( -- out) = std::move(*( -- left));
+                count_right = 0;
+                if ( ++ count_left >= min_gallop) break;
+            } else {
+                *( -- out) = std::move(*( -- buf_last));
+                count_left = 0;
+                if ( ++ count_right >= min_gallop) break;
+            }
+        }
+        while (buf_first != buf_last && left != first) {
+            auto& right_val = *(buf_last - 1);
+            auto left_stop = ministl::gallop_right(first, left,
+                    [&](const auto& x) { return !cmp(right_val, x); });
+            count_left = left - left_stop;
+            out = ministl::move_backward(left_stop, left, out);
+            left = left_stop;
+            if (left == first) break;
+
+            auto& left_val = *(left - 1);
+            auto buf_stop = ministl::gallop_right(buf_first, buf_last,
+                    [&](const auto& x) { return cmp(x, left_val); });
+            count_right = buf_last - buf_stop;
+            out = ministl::move_backward(buf_stop, buf_last, out);
+            buf_last = buf_stop;
+            if (count_left < min_gallop && count_right < min_gallop) break;
+        }
+    }
+    // whatever is left of the left run is already in place
+    ministl::move_backward(buf_first, buf_last, out);
+}
+
+/**
+ * stable merge of the adjacent sorted runs [first, middle) and [middle, last).
+ * uses the buffer when the shorter run fits in it, otherwise splits both runs
+ * and rotates the middle pieces (O(n log n) moves, no extra memory).
+ */
+template<typename Iter, typename Pointer, typename Compare>
+void merge_adaptive(Iter first, Iter middle, Iter last,
+        Pointer buffer, ptrdiff_t buffer_size, Compare cmp) {
+    if (first == middle || middle == last) return;
+    // elements of the left run not greater than *middle are already in place,
+    // so are elements of the right run not less than *(middle - 1)
+    auto& right_first = *middle;
+    first = ministl::gallop_left(first, middle, [&](const auto& x) { return !cmp(right_first, x); });
+    if (first == middle) return;
+    auto& left_last = *(middle - 1);
+    last = ministl::gallop_right(middle, last, [&](const auto& x) { return cmp(x, left_last); });
+
+    auto len1 = middle - first, len2 = last - middle;
+    if (len1 + len2 == 2) {
+        if (cmp(*middle, *first)) ministl::swap(*first, *middle);
+    } else if (len1 <= len2 && len1 <= buffer_size) {
+        ministl::merge_lo(first, middle, last, buffer, cmp);
+    } else if (len2 <= buffer_size) {
+        ministl::merge_hi(first, middle, last, buffer, cmp);
+    } else {
+        Iter cut1, cut2;
+        if (len1 > len2) {
+            cut1 = first + len1 / 2;
+            cut2 = ministl::lower_bound(middle, last, *cut1, cmp);
+        } else {
+            cut2 = middle + len2 / 2;
+            cut1 = ministl::upper_bound(first, middle, *cut2, cmp);
+        }
+        auto new_middle = ministl::rotate(cut1, middle, cut2);
+        ministl::merge_adaptive(first, cut1, new_middle, buffer, buffer_size, cmp);
+        ministl::merge_adaptive(new_middle, cut2, last, buffer, buffer_size, cmp);
+    }
+}
+
+/**
+ * stable in place merge. grabs a temporary buffer for the shorter run and
+ * falls back to the rotation based merge when memory is not available
+ */
+template<typename Iter, typename Compare>
+void inplace_merge(Iter first, Iter middle, Iter last, Compare cmp) {
+    if (first == middle || middle == last) return;
+    using value_type = typename ministl::iterator_traits<Iter>::value_type;
+    auto len1 = middle - first, len2 = last - middle;
+    temporary_buffer<value_type> buf(len1 < len2 ? len1 : len2, *first);
+    ministl::merge_adaptive(first, middle, last, buf.begin(), ptrdiff_t(buf.size()), cmp);
+}
+
+template<typename Iter>
+void inplace_merge(Iter first, Iter middle, Iter last) {
+    ministl::inplace_merge(first, middle, last, ministl::less<> {});
+}
+
+/**
+ * stable sort
+ */
+
+// [first, sorted) is sorted, insert the rest one by one
+template<typename Iter, typename Compare>
+void binary_insertion_sort(Iter first, Iter sorted, Iter last, Compare cmp) {
+    for (auto i = sorted; i < last; i ++ ) {
+        auto pos = ministl::upper_bound(first, i, *i, cmp);
+        if (pos == i) continue;
+        auto val = std::move(*i);
+        ministl::move_backward(pos, i, i + 1);
+        *pos = std::move(val);
+    }
+}
+
+// length of the run starting at first; a strictly descending run is reversed
+template<typename Iter, typename Compare>
+Iter count_run_and_make_ascending(Iter first, Iter last, Compare cmp) {
+    auto run_end = first + 1;
+    if (run_end == last) return run_end;
+    if (cmp(*run_end, *first)) {
+        while (run_end != last && cmp(*run_end, *(run_end - 1))) run_end ++ ;
+        ministl::reverse(first, run_end);
+    } else {
+        while (run_end != last && !cmp(*run_end, *(run_end - 1))) run_end ++ ;
+    }
+    return run_end;
+}
+
+// n < 64 returns n, otherwise a value in [32, 64] so that n / minrun is
+// close to but not above a power of two
+inline ptrdiff_t compute_min_run(ptrdiff_t n) {
+    ptrdiff_t r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+/**
+ * adaptive merge sort in the style of TimSort: natural runs are detected
+ * (descending ones reversed), short runs are extended to minrun by binary
+ * insertion and runs are merged under the TimSort stack invariants, so
+ * presorted input costs O(n).
+ *
+ * buffer/buffer_size is caller-owned scratch of constructed elements.
+ * buffer_size >= (last - first) / 2 means no merge ever falls back to
+ * rotations; a smaller (even empty) buffer is still correct, only slower.
+ * reusing one buffer across calls avoids any allocation.
+ */
+template<typename Iter, typename Pointer, typename Compare>
+void stable_sort(Iter first, Iter last, Pointer buffer, size_t buffer_size, Compare cmp) {
+    auto n = last - first;
+    if (n < 2) return;
+
+    struct run {
+        Iter base;
+        decltype(n) len;
+    };
+    // the invariants keep run lengths growing at least like fibonacci numbers
+    run stack[128];
+    int top = 0;
+
+    auto merge_at = [&](int i) {
+        ministl::merge_adaptive(stack[i].base, stack[i + 1].base, stack[i + 1].base + stack[i + 1].len,
+                buffer, ptrdiff_t(buffer_size), cmp);
+        stack[i].len += stack[i + 1].len;
+        if (i + 2 < top) stack[i + 1] = stack[i + 2];
+        top -- ;
+    };
+
+    auto min_run = ministl::compute_min_run(n);
+    for (auto cur = first; cur != last; ) {
+        auto run_len = ministl::count_run_and_make_ascending(cur, last, cmp) - cur;
+        if (run_len < min_run) {
+            auto force = last - cur < min_run ? last - cur : min_run;
+            ministl::binary_insertion_sort(cur, cur + run_len, cur + force, cmp);
+            run_len = force;
+        }
+        stack[top ++ ] = {cur, run_len};
+        cur += run_len;
+
+        while (top > 1) {
+            int i = top - 2;
+            if ((i > 0 && stack[i - 1].len <= stack[i].len + stack[i + 1].len) ||
+                    (i > 1 && stack[i - 2].len <= stack[i - 1].len + stack[i].len)) {
+                if (stack[i - 1].len < stack[i + 1].len) i -- ;
+            } else if (stack[i].len > stack[i + 1].len) {
+                break;
+            }
+            merge_at(i);
+        }
+    }
+    while (top > 1) {
+        int i = top - 2;
+        if (i > 0 && stack[i - 1].len < stack[i + 1].len) i -- ;
+        merge_at(i);
+    }
+}
+
+template<typename Iter, typename Compare>
+void stable_sort(Iter first, Iter last, Compare cmp) {
+    if (last - first < 2) return;
+    using value_type = typename ministl::iterator_traits<Iter>::value_type;
+    temporary_buffer<value_type> buf((last - first) / 2, *first);
+    ministl::stable_sort(first, last, buf.begin(), buf.size(), cmp);
+}
+
+template<typename Iter>
+void stable_sort(Iter first, Iter last) {
+    ministl::stable_sort(first, last, ministl::less<> {});
+}
+
+/**
+ * sorted ranges
+ */
+
+// drop consecutive duplicates, return the new end
+template<typename Iter, typename BinaryPredicate>
+Iter unique(Iter first, Iter last, BinaryPredicate pred) {
+    if (first == last) return last;
+    auto res = first;
+    while ( ++ first != last) {
+        if (!pred(*res, *first) && ++ res != first) *res = std::move(*first);
+    }
+    return ++ res;
+}
+
+template<typename Iter>
+Iter unique(Iter first, Iter last) {
+    return ministl::unique(first, last, [](const auto& lhs, const auto& rhs) { return lhs == rhs; });
+}
+
+/**
+ * output iterator that only counts what is written to it, so a set
+ * operation can report its result size without materializing it:
+ * ministl::set_intersection(..., count_output_iterator {}).count()
+ */
+class count_output_iterator {
+public:
+    using iterator_category = ministl::output_iterator_tag;
+    using value_type = void;
+    using pointer = void;
+    using reference = void;
+    using difference_type = ptrdiff_t;
+
+private:
+    size_t n = 0;
+
+public:
+    size_t count() const noexcept { return n; }
+
+    count_output_iterator& operator*() noexcept { return *this; }
+
+    template<typename T>
+    count_output_iterator& operator=(const T&) noexcept {
+        n ++ ;
+        return *this;
+    }
+
+    count_output_iterator& operator++() noexcept { return *this; }
+
+    count_output_iterator& operator++(int) noexcept { return *this; }
+
+    // bulk count, used by the simd kernels
+    void add(size_t k) noexcept { n += k; }
+};
+
+namespace set_detail
+{
+
+// one side this many times longer than the other switches merging to galloping
+constexpr ptrdiff_t gallop_ratio = 32;
+
+template<typename Iter1, typename Iter2>
+constexpr bool random_access_v = ministl::is_random_access_iterator<Iter1>::value &&
+    ministl::is_random_access_iterator<Iter2>::value;
+
+template<typename Iter, typename Compare>
+constexpr bool is_u32_pointer_v = std::is_pointer_v<Iter> &&
+    std::is_same_v<std::remove_cv_t<std::remove_pointer_t<Iter>>, uint32_t> &&
+    (std::is_same_v<Compare, ministl::less<>> || std::is_same_v<Compare, ministl::less<uint32_t>>);
+
+#if defined(__x86_64__)
+
+// pshufb masks that pack the lanes selected by a 4 bit mask to the front
+struct compact_table {
+    alignas(16) uint8_t masks[16][16];
+
+    constexpr compact_table() : masks() {
+        for (int mask = 0; mask < 16; mask ++ ) {
+            int k = 0;
+            for (int lane = 0; lane < 4; lane ++ ) {
+                if (!(mask >> lane & 1)) continue;
+                for (int byte = 0; byte < 4; byte ++ ) masks[mask][k ++ ] = uint8_t(lane * 4 + byte);
+            }
+            while (k < 16) masks[mask][k ++ ] = 0x80;
+        }
+    }
+};
+
+inline constexpr compact_table compact_masks {};
+
+inline bool has_ssse3() {
+    static const bool res = __builtin_cpu_supports("ssse3");
+    return res;
+}
+
+/**
+ * block intersection of strictly increasing uint32 lists (Schlegel et al.):
+ * a block of 4 from each side is compared all against all with 4 lane
+ * rotations, matches are packed with pshufb, then the block with the
+ * smaller maximum advances. duplicates inside a list break the one match
+ * per value assumption, so each block is checked for them first and the
+ * kernel stops there, leaving a and b where the scalar merge can resume.
+ *
+ * packed matches always go to a small staging buffer with a full 16 byte
+ * store, a branch on "any match" mispredicts on real posting lists. the
+ * staging buffer is flushed to out when nearly full.
+ */
+template<typename OutIter>
+__attribute__((target("ssse3")))
+OutIter intersect_u32(const uint32_t*& a, const uint32_t* a_end,
+        const uint32_t*& b, const uint32_t* b_end, OutIter out) {
+    constexpr bool count_only = std::is_same_v<OutIter, count_output_iterator>;
+    constexpr int stage_size = count_only ? 4 : 64;
+    alignas(16) uint32_t stage[stage_size];
+    int staged = 0;
+    size_t counted = 0;
+    // one element past the block is read for the duplicate check
+    while (a_end - a > 4 && b_end - b > 4) {
+        auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        auto next_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 1));
+        auto next_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 1));
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi32(va, next_a), _mm_cmpeq_epi32(vb, next_b)))) break;
+
+        auto eq = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                    _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                    _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        if constexpr (count_only) {
+            counted += __builtin_popcount(mask);
+        } else {
+            auto shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(compact_masks.masks[mask]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(stage + staged), _mm_shuffle_epi8(va, shuffle));
+            staged += __builtin_popcount(mask);
+            if (staged > stage_size - 4) {
+                out = ministl::copy(stage, stage + staged, out);
+                staged = 0;
+            }
+        }
+        auto a_max = a[3], b_max = b[3];
+        if (a_max <= b_max) a += 4;
+        if (b_max <= a_max) b += 4;
+    }
+    if constexpr (count_only) {
+        out.add(counted);
+        return out;
+    } else {
+        return ministl::copy(stage, stage + staged, out);
+    }
+}
+
+#endif
+
+}
+
+/**
+ * elements of the sorted range 1 that also appear in the sorted range 2.
+ * with repeated values the result has min(count1, count2) copies, taken
+ * from range 1.
+ *
+ * when one range is gallop_ratio times longer than the other the longer
+ * one is skipped through with galloping search, O(m log(n / m)). for
+ * uint32_t arrays under the default order a simd block kernel does the
+ * merge of similar sized inputs.
+ */
+template<typename Iter1, typename Iter2, typename OutIter, typename Compare>
+OutIter set_intersection(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out, Compare cmp) {
+    if constexpr (set_detail::random_access_v<Iter1, Iter2>) {
+        auto len1 = last1 - first1, len2 = last2 - first2;
+        if (len1 > len2 * set_detail::gallop_ratio || len2 > len1 * set_detail::gallop_ratio) {
+            while (first1 != last1 && first2 != last2) {
+                if (cmp(*first1, *first2)) {
+                    auto& val = *first2;
+                    first1 = ministl::gallop_left(first1, last1, [&](const auto& x) { return cmp(x, val); });
+                } else if (cmp(*first2, *first1)) {
+                    auto& val = *first1;
+                    first2 = ministl::gallop_left(first2, last2, [&](const auto& x) { return cmp(x, val); });
+                } else {
+                    *out = *first1;
+                    ++ out, ++ first1, ++ first2;
+                }
+            }
+            return out;
+        }
+#if defined(__x86_64__)
+        if constexpr (set_detail::is_u32_pointer_v<Iter1, Compare> && set_detail::is_u32_pointer_v<Iter2, Compare>) {
+            if (set_detail::has_ssse3()) {
+                const uint32_t* a = first1;
+                const uint32_t* b = first2;
+                out = set_detail::intersect_u32(a, last1, b, last2, out);
+                first1 += a - first1, first2 += b - first2;
+            }
+        }
+#endif
+    }
+    while (first1 != last1 && first2 != last2) {
+        if (cmp(*first1, *first2)) {
+            ++ first1;
+        } else if (cmp(*first2, *first1)) {
+            ++ first2;
+        } else {
+            *out = *first1;
+            ++ out, ++ first1, ++ first2;
+        }
+    }
+    return out;
+}
+
+template<typename Iter1, typename Iter2, typename OutIter>
+OutIter set_intersection(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out) {
+    return ministl::set_intersection(first1, last1, first2, last2, out, ministl::less<> {});
+}
+
+/**
+ * every value of either sorted range; a value repeated in both appears
+ * max(count1, count2) times, the copies shared with range 1 taken from it
+ */
+template<typename Iter1, typename Iter2, typename OutIter, typename Compare>
+OutIter set_union(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out, Compare cmp) {
+    while (first1 != last1 && first2 != last2) {
+        if (cmp(*first1, *first2)) {
+            *out = *first1;
+            ++ first1;
+        } else if (cmp(*first2, *first1)) {
+            *out = *first2;
+            ++ first2;
+        } else {
+            *out = *first1;
+            ++ first1, ++ first2;
+        }
+        ++ out;
+    }
+    out = ministl::copy(first1, last1, out);
+    return ministl::copy(first2, last2, out);
+}
+
+template<typename Iter1, typename Iter2, typename OutIter>
+OutIter set_union(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out) {
+    return ministl::set_union(first1, last1, first2, last2, out, ministl::less<> {});
+}
+
+/**
+ * elements of sorted range 1 not in sorted range 2, a repeated value is
+ * kept max(count1 - count2, 0) times. a much longer range 2 is galloped over
+ */
+template<typename Iter1, typename Iter2, typename OutIter, typename Compare>
+OutIter set_difference(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out, Compare cmp) {
+    bool gallop = false;
+    if constexpr (set_detail::random_access_v<Iter1, Iter2>) {
+        gallop = last2 - first2 > (last1 - first1) * set_detail::gallop_ratio;
+    }
+    while (first1 != last1 && first2 != last2) {
+        if (cmp(*first1, *first2)) {
+            *out = *first1;
+            ++ out, ++ first1;
+        } else if (cmp(*first2, *first1)) {
+            if constexpr (set_detail::random_access_v<Iter1, Iter2>) {
+                if (gallop) {
+                    auto& val = *first1;
+                    first2 = ministl::gallop_left(first2, last2, [&](const auto& x) { return cmp(x, val); });
+                    continue;
+                }
+            }
+            ++ first2;
+        } else {
+            ++ first1, ++ first2;
+        }
+    }
+    return ministl::copy(first1, last1, out);
+}
+
+template<typename Iter1, typename Iter2, typename OutIter>
+OutIter set_difference(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out) {
+    return ministl::set_difference(first1, last1, first2, last2, out, ministl::less<> {});
+}
+
+/**
+ * whether sorted range 2 is a sub-multiset of sorted range 1.
+ * a much longer range 1 is galloped over
+ */
+template<typename Iter1, typename Iter2, typename Compare>
+bool includes(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, Compare cmp) {
+    bool gallop = false;
+    if constexpr (set_detail::random_access_v<Iter1, Iter2>) {
+        if (last2 - first2 > last1 - first1) return false;
+        gallop = last1 - first1 > (last2 - first2) * set_detail::gallop_ratio;
+    }
+    for (; first2 != last2; ++ first1, ++ first2) {
+        if constexpr (set_detail::random_access_v<Iter1, Iter2>) {
+            if (gallop) {
+                auto& val = *first2;
+                first1 = ministl::gallop_left(first1, last1, [&](const auto& x) { return cmp(x, val); });
+            }
+        }
+        while (first1 != last1 && cmp(*first1, *first2)) ++ first1;
+        if (first1 == last1 || cmp(*first2, *first1)) return false;
+    }
+    return true;
+}
+
+template<typename Iter1, typename Iter2>
+bool includes(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    return ministl::includes(first1, last1, first2, last2, ministl::less<> {});
+}
+
+/**
+ * result sizes without materializing the output
+ */
+template<typename Iter1, typename Iter2>
+size_t set_intersection_size(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    return ministl::set_intersection(first1, last1, first2, last2, count_output_iterator {}).count();
+}
+
+template<typename Iter1, typename Iter2>
+size_t set_union_size(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    return ministl::set_union(first1, last1, first2, last2, count_output_iterator {}).count();
+}
+
+template<typename Iter1, typename Iter2>
+size_t set_difference_size(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2) {
+    return ministl::set_difference(first1, last1, first2, last2, count_output_iterator {}).count();
 }
 
 }
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace ministl
+{
+
+/**
+ * allocators hand out raw bytes for containers. they are stateless, every
+ * member is static, and deallocate gets the same byte count as allocate.
+ * uninitialized_fill lets an allocator decide how fresh memory is first
+ * touched (see large_page_allocator.h).
+ */
+struct default_allocator {
+    using byte = uint8_t;
+
+    static void* allocate(size_t bytes) {
+        return ::new byte[bytes];
+    }
+
+    static void deallocate(void* ptr, [[maybe_unused]] size_t bytes) noexcept {
+        ::delete[] static_cast<byte *>(ptr);
+    }
+
+    template<typename T>
+    static void uninitialized_fill(T* first, size_t n, const T& val) {
+        for (size_t i = 0; i < n; i ++ ) ::new (first + i) T(val);
+    }
+};
+
+}
@@ -0,0 +1,448 @@
+#pragma once
+#include <ministl/functional.h>
+#include <ministl/vector.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+namespace ministl
+{
+
+namespace concurrent_detail
+{
+
+enum slot_state : uint8_t { empty_slot, full_slot, deleted_slot };
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+}
+
+inline size_t round_up_pow2(size_t n) {
+    size_t res = 1;
+    while (res < n) res <<= 1;
+    return res;
+}
+
+}
+
+/**
+ * hash map shared by many threads.
+ *
+ * keys are spread over independent shards by the high bits of their hash.
+ * every shard is an open addressing table (linear probing) with a writer
+ * mutex and a sequence counter:
+ *
+ * - find never locks. it reads the shard optimistically and retries when
+ *   the sequence counter shows that a writer ran meanwhile (a seqlock).
+ *   Key and Value must therefore be trivially copyable: a reader may copy
+ *   bytes a writer is changing, and throws them away afterwards.
+ * - insert / insert_or_assign / upsert / erase take only their shard's lock.
+ * - a shard that gets too full grows incrementally: a new table of twice
+ *   the live entries (plus the inserts the migration may see) is
+ *   installed and every later write to the shard also moves a few dozen
+ *   slots over, until the old table is empty. lookups consult both
+ *   tables meanwhile. no operation ever rehashes a whole shard, and other
+ *   shards are not affected at all.
+ *
+ * a drained table can still be in use by concurrent readers. every find
+ * counts itself in its shard while it holds table pointers, and the writer
+ * frees the shard's drained tables at the first write that sees no reader
+ * there. a shard that is never quiet keeps them until reclaim() (with no
+ * concurrent access) or the destructor.
+ */
+template<typename Key, typename Value, typename Hash = ministl::hash<Key>, typename KeyEqual = ministl::equal_to<Key>>
+class concurrent_hash_map {
+    static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>,
+            "optimistic readers copy keys and values while they may be written");
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+
+private:
+    using slot_state = concurrent_detail::slot_state;
+
+    struct slot {
+        Key key;
+        Value value;
+    };
+
+    struct table {
+        size_type capacity; // power of two
+        std::atomic<uint8_t>* states;
+        slot* slots;
+
+        explicit table(size_type capacity) : capacity(capacity) {
+            states = new std::atomic<uint8_t>[capacity];
+            for (size_type i = 0; i < capacity; i ++ ) states[i].store(concurrent_detail::empty_slot, std::memory_order_relaxed);
+            slots = static_cast<slot*>(::operator new(capacity * sizeof (slot), std::align_val_t(alignof (slot))));
+        }
+
+        ~table() {
+            delete[] states;
+            ::operator delete(slots, std::align_val_t(alignof (slot)));
+        }
+    };
+
+    // slots moved from the old table on every write while a shard grows
+    constexpr static size_type migrate_batch = 64;
+    constexpr static size_type min_capacity = 16;
+
+    struct alignas(64) shard {
+        std::mutex lock;
+        std::atomic<uint64_t> seq {0};
+        std::atomic<table*> current {nullptr};
+        std::atomic<table*> old {nullptr};
+        std::atomic<size_type> count {0};
+        // finds currently holding table pointers of this shard
+        std::atomic<uint32_t> readers {0};
+        // writer side only
+        size_type used = 0; // full and deleted slots of current
+        size_type migrate_pos = 0;
+        ministl::vector<table*> retired;
+    };
+
+    shard* shards;
+    size_type shard_num;
+    unsigned shard_shift;
+    Hash hasher;
+    KeyEqual key_equal;
+
+    shard& shard_for(size_t hash) const noexcept {
+        return shards[shard_shift >= 64 ? 0 : hash >> shard_shift];
+    }
+
+    /**
+     * slot index of key in t, or t->capacity. writers call it under the
+     * lock; readers call it racily and validate the result with the seqlock
+     */
+    size_type find_index(const table* t, const Key& key, size_t hash) const {
+        auto mask = t->capacity - 1;
+        for (size_type i = hash & mask, probes = 0; probes < t->capacity; i = (i + 1) & mask, probes ++ ) {
+            auto state = t->states[i].load(std::memory_order_relaxed);
+            if (state == concurrent_detail::empty_slot) break;
+            if (state != concurrent_detail::full_slot) continue;
+            alignas(Key) unsigned char key_bytes[sizeof (Key)];
+            std::memcpy(key_bytes, &t->slots[i].key, sizeof (Key));
+            if (key_equal(*reinterpret_cast<const Key*>(key_bytes), key)) return i;
+        }
+        return t->capacity;
+    }
+
+    // a free slot for a key known to be absent, or t->capacity when t is full
+    static size_type free_index(const table* t, size_t hash) {
+        auto mask = t->capacity - 1;
+        for (size_type i = hash & mask, probes = 0; probes < t->capacity; i = (i + 1) & mask, probes ++ ) {
+            if (t->states[i].load(std::memory_order_relaxed) != concurrent_detail::full_slot) return i;
+        }
+        return t->capacity;
+    }
+
+    static void write_slot(table* t, size_type i, const Key& key, const Value& value) {
+        std::memcpy(&t->slots[i].key, &key, sizeof (Key));
+        std::memcpy(&t->slots[i].value, &value, sizeof (Value));
+    }
+
+    void place(shard& s, const Key& key, const Value& value, size_t hash) {
+        auto t = s.current.load(std::memory_order_relaxed);
+        auto i = free_index(t, hash);
+        // reserve_one keeps current below 3/4 load, so this is a broken invariant
+        if (i == t->capacity) throw std::length_error("concurrent_hash_map shard is full");
+        if (t->states[i].load(std::memory_order_relaxed) == concurrent_detail::empty_slot) s.used ++ ;
+        write_slot(t, i, key, value);
+        t->states[i].store(concurrent_detail::full_slot, std::memory_order_relaxed);
+    }
+
+    // move slot i of the old table into the current one
+    void move_slot(shard& s, table* from, size_type i) {
+        auto& cur = from->slots[i];
+        place(s, cur.key, cur.value, hasher(cur.key));
+        from->states[i].store(concurrent_detail::deleted_slot, std::memory_order_relaxed);
+    }
+
+    void migrate_step(shard& s, size_type budget) {
+        auto from = s.old.load(std::memory_order_relaxed);
+        if (!from) return;
+        for (; budget && s.migrate_pos < from->capacity; budget -- , s.migrate_pos ++ ) {
+            if (from->states[s.migrate_pos].load(std::memory_order_relaxed) == concurrent_detail::full_slot) {
+                move_slot(s, from, s.migrate_pos);
+            }
+        }
+        if (s.migrate_pos == from->capacity) {
+            // seq_cst pairs with the readers count, see free_retired
+            s.old.store(nullptr, std::memory_order_seq_cst);
+            s.retired.push_back(from);
+        }
+    }
+
+    /**
+     * a find registers in readers before it loads current and old; both
+     * sides are seq_cst, so when the count is zero here every later find
+     * sees that the retired tables are unlinked and none can reach them
+     */
+    static void free_retired(shard& s) noexcept {
+        if (s.retired.empty() || s.readers.load(std::memory_order_seq_cst) != 0) return;
+        while (!s.retired.empty()) {
+            delete s.retired[s.retired.size() - 1];
+            s.retired.pop_back();
+        }
+    }
+
+    // keep the load of current below 3/4, counting deleted slots
+    void reserve_one(shard& s) {
+        auto cur = s.current.load(std::memory_order_relaxed);
+        if ((s.used + 1) * 4 <= cur->capacity * 3) return;
+        // the new table is sized below so that a migration always ends
+        // before current fills up; finishing one here is only a safeguard
+        if (s.old.load(std::memory_order_relaxed)) migrate_step(s, ~size_type(0));
+        // room for the live entries plus one insert for each of the writes
+        // the migration takes, at under half load: after heavy erasing the
+        // new table is much smaller than the one it drains
+        auto live = s.count.load(std::memory_order_relaxed);
+        auto capacity = concurrent_detail::round_up_pow2((live + cur->capacity / migrate_batch + 1) * 2);
+        if (capacity < min_capacity) capacity = min_capacity;
+        s.old.store(cur, std::memory_order_relaxed);
+        s.current.store(new table(capacity), std::memory_order_seq_cst);
+        s.migrate_pos = 0;
+        s.used = 0;
+        migrate_step(s, migrate_batch);
+    }
+
+    /**
+     * writer side: lock the shard and make it odd for readers while fn runs
+     */
+    template<typename Fn>
+    auto write(shard& s, Fn fn) {
+        std::lock_guard<std::mutex> guard(s.lock);
+        s.seq.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        struct end_write {
+            shard& s;
+            ~end_write() { s.seq.fetch_add(1, std::memory_order_release); }
+        } guard_seq {s};
+        migrate_step(s, migrate_batch);
+        free_retired(s);
+        return fn();
+    }
+
+    // slot of key in current, moving it over from the old table if needed
+    size_type locate_for_write(shard& s, const Key& key, size_t hash) {
+        auto cur = s.current.load(std::memory_order_relaxed);
+        auto i = find_index(cur, key, hash);
+        if (i != cur->capacity) return i;
+        auto from = s.old.load(std::memory_order_relaxed);
+        if (!from) return cur->capacity;
+        auto j = find_index(from, key, hash);
+        if (j == from->capacity) return cur->capacity;
+        move_slot(s, from, j);
+        return find_index(cur, key, hash);
+    }
+
+public:
+    /**
+     * Constructor: shard_count 0 picks four shards per hardware thread
+     */
+    explicit concurrent_hash_map(size_type shard_count = 0, size_type initial_capacity = 0) {
+        if (shard_count == 0) shard_count = 4 * (std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 4);
+        shard_num = concurrent_detail::round_up_pow2(shard_count);
+        shard_shift = 64;
+        for (auto n = shard_num; n > 1; n >>= 1) shard_shift -- ;
+        shards = new shard[shard_num];
+        auto per_shard = concurrent_detail::round_up_pow2(initial_capacity / shard_num * 2);
+        if (per_shard < min_capacity) per_shard = min_capacity;
+        for (size_type i = 0; i < shard_num; i ++ ) shards[i].current.store(new table(per_shard));
+    }
+
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+    ~concurrent_hash_map() {
+        reclaim();
+        for (size_type i = 0; i < shard_num; i ++ ) {
+            delete shards[i].current.load();
+            delete shards[i].old.load();
+        }
+        delete[] shards;
+    }
+
+    /**
+     * Operation
+     */
+
+    // lock free; copies the value into out and returns true when key is present
+    bool find(const Key& key, Value& out) const {
+        auto hash = hasher(key);
+        auto& s = shard_for(hash);
+        alignas(Value) unsigned char value_bytes[sizeof (Value)];
+        s.readers.fetch_add(1, std::memory_order_seq_cst);
+        struct end_read {
+            shard& s;
+            ~end_read() { s.readers.fetch_sub(1, std::memory_order_release); }
+        } guard_readers {s};
+        while (true) {
+            auto before = s.seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                concurrent_detail::cpu_relax();
+                continue;
+            }
+            bool found = false;
+            for (auto t : {s.current.load(std::memory_order_seq_cst), s.old.load(std::memory_order_seq_cst)}) {
+                if (!t) continue;
+                auto i = find_index(t, key, hash);
+                if (i == t->capacity) continue;
+                std::memcpy(value_bytes, &t->slots[i].value, sizeof (Value));
+                found = true;
+                break;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) != before) continue;
+            if (found) std::memcpy(&out, value_bytes, sizeof (Value));
+            return found;
+        }
+    }
+
+    bool contains(const Key& key) const {
+        alignas(Value) unsigned char ignored[sizeof (Value)];
+        return find(key, *reinterpret_cast<Value*>(ignored));
+    }
+
+    // insert when absent, returns whether it did
+    bool insert(const Key& key, const Value& value) {
+        auto hash = hasher(key);
+        auto& s = shard_for(hash);
+        return write(s, [&] {
+            if (locate_for_write(s, key, hash) != s.current.load(std::memory_order_relaxed)->capacity) return false;
+            reserve_one(s);
+            place(s, key, value, hash);
+            s.count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        });
+    }
+
+    // returns true when key was inserted, false when an existing value was replaced
+    bool insert_or_assign(const Key& key, const Value& value) {
+        return upsert(key, value, [&value](Value& cur) { cur = value; });
+    }
+
+    /**
+     * insert init when key is absent, otherwise call fn(Value&) on the stored
+     * value under the shard lock. returns whether key was inserted.
+     * fn must not call back into the map
+     */
+    template<typename Fn>
+    bool upsert(const Key& key, const Value& init, Fn fn) {
+        auto hash = hasher(key);
+        auto& s = shard_for(hash);
+        return write(s, [&] {
+            auto cur = s.current.load(std::memory_order_relaxed);
+            auto i = locate_for_write(s, key, hash);
+            if (i != cur->capacity) {
+                fn(cur->slots[i].value);
+                return false;
+            }
+            reserve_one(s);
+            place(s, key, init, hash);
+            s.count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        });
+    }
+
+    bool erase(const Key& key) {
+        auto hash = hasher(key);
+        auto& s = shard_for(hash);
+        return write(s, [&] {
+            auto cur = s.current.load(std::memory_order_relaxed);
+            auto i = locate_for_write(s, key, hash);
+            if (i == cur->capacity) return false;
+            cur->states[i].store(concurrent_detail::deleted_slot, std::memory_order_relaxed);
+            s.count.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        });
+    }
+
+    // exact when no writer runs concurrently
+    size_type size() const noexcept {
+        size_type res = 0;
+        for (size_type i = 0; i < shard_num; i ++ ) res += shards[i].count.load(std::memory_order_relaxed);
+        return res;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    size_type shard_count() const noexcept { return shard_num; }
+
+    /**
+     * fn(const Key&, const Value&) for every entry, one shard locked at a
+     * time. fn must not call back into the map
+     */
+    template<typename Fn>
+    void for_each(Fn fn) const {
+        for (size_type k = 0; k < shard_num; k ++ ) {
+            auto& s = shards[k];
+            std::lock_guard<std::mutex> guard(s.lock);
+            for (auto t : {s.current.load(std::memory_order_relaxed), s.old.load(std::memory_order_relaxed)}) {
+                if (!t) continue;
+                for (size_type i = 0; i < t->capacity; i ++ ) {
+                    if (t->states[i].load(std::memory_order_relaxed) == concurrent_detail::full_slot) {
+                        fn(const_cast<const Key&>(t->slots[i].key), const_cast<const Value&>(t->slots[i].value));
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * fn(const Key&, Value&) for every entry, changing values in place. runs
+     * as a write on one shard at a time, so finds retry instead of copying a
+     * value fn is changing. fn must not call back into the map
+     */
+    template<typename Fn>
+    void update_each(Fn fn) {
+        for (size_type k = 0; k < shard_num; k ++ ) {
+            auto& s = shards[k];
+            write(s, [&] {
+                for (auto t : {s.current.load(std::memory_order_relaxed), s.old.load(std::memory_order_relaxed)}) {
+                    if (!t) continue;
+                    for (size_type i = 0; i < t->capacity; i ++ ) {
+                        if (t->states[i].load(std::memory_order_relaxed) == concurrent_detail::full_slot) {
+                            fn(const_cast<const Key&>(t->slots[i].key), t->slots[i].value);
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    // drained tables waiting for their shard to have no reader
+    size_type retired_tables() {
+        size_type res = 0;
+        for (size_type k = 0; k < shard_num; k ++ ) {
+            std::lock_guard<std::mutex> guard(shards[k].lock);
+            res += shards[k].retired.size();
+        }
+        return res;
+    }
+
+    /**
+     * free drained tables regardless of readers. no other thread may use
+     * the map during the call
+     */
+    void reclaim() {
+        for (size_type k = 0; k < shard_num; k ++ ) {
+            for (auto t : shards[k].retired) delete t;
+            shards[k].retired = ministl::vector<table*>();
+        }
+    }
+};
+
+}
@@ -0,0 +1,462 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/allocator.h>
+#include <ministl/iterator.h>
+#include <ministl/reverse_iterator.h>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace ministl
+{
+
+namespace deque_detail
+{
+
+// elements per chunk: about 4KiB, at least 16, a power of two so positions split with a shift
+template<typename T>
+constexpr size_t chunk_size = sizeof (T) >= 256 ? 16 : std::bit_floor(4096 / sizeof (T));
+
+/**
+ * random access iterator over a block map: the map slot of the chunk and
+ * the offset inside it. the slot is only read on dereference, so end() may
+ * sit on a slot that has no chunk yet.
+ */
+template<typename T, bool Const>
+class deque_iterator {
+public:
+    using iterator_category = ministl::random_access_iterator_tag;
+    using value_type = T;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+    using difference_type = ptrdiff_t;
+
+private:
+    constexpr static difference_type chunk = chunk_size<T>;
+
+    T** node;
+    difference_type offset;
+
+public:
+    deque_iterator() : node(nullptr), offset(0) {}
+
+    deque_iterator(T** node, difference_type offset) : node(node), offset(offset) {}
+
+    // iterator -> const_iterator
+    template<bool RhsConst, typename = std::enable_if_t<Const && !RhsConst>>
+    deque_iterator(const deque_iterator<T, RhsConst>& rhs) : node(rhs.map_node()), offset(rhs.chunk_offset()) {}
+
+    T** map_node() const noexcept { return node; }
+
+    difference_type chunk_offset() const noexcept { return offset; }
+
+    reference operator*() const { return (*node)[offset]; }
+
+    pointer operator->() const { return *node + offset; }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    deque_iterator& operator++() {
+        if ( ++ offset == chunk) node ++ , offset = 0;
+        return *this;
+    }
+
+    deque_iterator operator++(int) {
+        auto res = *this;
+        ++ *this;
+        return res;
+    }
+
+    deque_iterator& operator--() {
+        if (offset -- == 0) node -- , offset = chunk - 1;
+        return *this;
+    }
+
+    deque_iterator operator--(int) {
+        auto res = *this;
+        -- *this;
+        return res;
+    }
+
+    deque_iterator& operator+=(difference_type n) {
+        // floor division, n may be negative
+        auto pos = offset + n;
+        auto step = pos >= 0 ? pos / chunk : -((-pos - 1) / chunk) - 1;
+        node += step;
+        offset = pos - step * chunk;
+        return *this;
+    }
+
+    deque_iterator& operator-=(difference_type n) { return *this += -n; }
+
+    deque_iterator operator+(difference_type n) const {
+        auto res = *this;
+        return res += n;
+    }
+
+    friend deque_iterator operator+(difference_type n, const deque_iterator& iter) { return iter + n; }
+
+    deque_iterator operator-(difference_type n) const {
+        auto res = *this;
+        return res -= n;
+    }
+
+    difference_type operator-(const deque_iterator& rhs) const {
+        return (node - rhs.node) * chunk + (offset - rhs.offset);
+    }
+
+    friend bool operator==(const deque_iterator& lhs, const deque_iterator& rhs) {
+        return lhs.node == rhs.node && lhs.offset == rhs.offset;
+    }
+
+    friend bool operator!=(const deque_iterator& lhs, const deque_iterator& rhs) { return !(lhs == rhs); }
+
+    friend bool operator<(const deque_iterator& lhs, const deque_iterator& rhs) {
+        return lhs.node < rhs.node || (lhs.node == rhs.node && lhs.offset < rhs.offset);
+    }
+
+    friend bool operator>(const deque_iterator& lhs, const deque_iterator& rhs) { return rhs < lhs; }
+
+    friend bool operator<=(const deque_iterator& lhs, const deque_iterator& rhs) { return !(rhs < lhs); }
+
+    friend bool operator>=(const deque_iterator& lhs, const deque_iterator& rhs) { return !(lhs < rhs); }
+};
+
+}
+
+/**
+ * double ended queue over a block map of fixed size chunks (about 4KiB
+ * each). push and pop at both ends are O(1) amortized and never move
+ * elements, only the map of chunk pointers grows or recentres.
+ *
+ * element i lives at absolute position start + i of the map, i.e. chunk
+ * (start + i) / chunk_size, and only chunks holding elements are mapped.
+ * a chunk that empties goes to a free list and is handed out again by the
+ * next push, so a queue churning at a steady size stops calling the
+ * allocator. shrink_to_fit returns the free chunks and trims the map.
+ */
+template<typename T, typename Alloc = ministl::default_allocator>
+class deque {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = deque_detail::deque_iterator<T, false>;
+    using const_iterator = deque_detail::deque_iterator<T, true>;
+
+    constexpr static size_type chunk_size = deque_detail::chunk_size<T>;
+
+private:
+    constexpr static size_type chunk_shift = std::countr_zero(chunk_size);
+    constexpr static size_type min_map_size = 8;
+
+    // a free chunk stores the link to the next one in its first bytes
+    static_assert(chunk_size * sizeof (T) >= sizeof (void*));
+
+    T** map;
+    size_type map_size;
+    size_type start;
+    size_type count;
+    void* free_chunks;
+    size_type free_count;
+
+    T* allocate_chunk() {
+        if (free_chunks) {
+            void* res = free_chunks;
+            std::memcpy(&free_chunks, res, sizeof (void*));
+            free_count -- ;
+            return static_cast<T*>(res);
+        }
+        return static_cast<T*>(Alloc::allocate(chunk_size * sizeof (T)));
+    }
+
+    void recycle_chunk(T*& chunk) noexcept {
+        std::memcpy(static_cast<void*>(chunk), &free_chunks, sizeof (void*));
+        free_chunks = chunk;
+        free_count ++ ;
+        chunk = nullptr;
+    }
+
+    void release_free_chunks() noexcept {
+        while (free_chunks) {
+            void* next;
+            std::memcpy(&next, free_chunks, sizeof (void*));
+            Alloc::deallocate(free_chunks, chunk_size * sizeof (T));
+            free_chunks = next;
+        }
+        free_count = 0;
+    }
+
+    T& at_position(size_type pos) const noexcept {
+        return map[pos >> chunk_shift][pos & (chunk_size - 1)];
+    }
+
+    // first and one past the last mapped chunk
+    size_type first_chunk() const noexcept { return start >> chunk_shift; }
+
+    size_type last_chunk() const noexcept { return count ? ((start + count - 1) >> chunk_shift) + 1 : first_chunk(); }
+
+    /**
+     * make the map hold its used chunks plus at least one free slot at
+     * each end: recentre the pointers when the map is at most half full,
+     * otherwise move them into a map twice as large. a non zero used_size
+     * moves them into a map of exactly that many slots instead.
+     */
+    void remap(size_type used_size) {
+        size_type first = first_chunk(), used = last_chunk() - first;
+        T** target = map;
+        size_type target_size = map_size;
+        if (used_size || used * 2 + 2 > map_size) {
+            target_size = used_size ? used_size : std::max(min_map_size, map_size * 2);
+            target = static_cast<T**>(Alloc::allocate(target_size * sizeof (T*)));
+            std::memset(target, 0, target_size * sizeof (T*));
+        }
+        size_type new_first = (target_size - used) / 2;
+        if (used) std::memmove(target + new_first, map + first, used * sizeof (T*));
+        if (target == map) {
+            // clear the slots the move left behind
+            if (new_first < first) {
+                auto from = std::max(new_first + used, first);
+                std::memset(map + from, 0, (first + used - from) * sizeof (T*));
+            } else {
+                auto to = std::min(new_first, first + used);
+                std::memset(map + first, 0, (to - first) * sizeof (T*));
+            }
+        } else {
+            if (map) Alloc::deallocate(map, map_size * sizeof (T*));
+            map = target, map_size = target_size;
+        }
+        if (count) start = new_first * chunk_size + (start & (chunk_size - 1));
+        else restart();
+    }
+
+    // map a chunk at the unmapped slot of position pos
+    void map_chunk(size_type pos) {
+        auto& chunk = map[pos >> chunk_shift];
+        assert(!chunk);
+        chunk = allocate_chunk();
+    }
+
+    // an empty deque restarts mid map and mid chunk so it can grow either way;
+    // without a map it stays at 0, where both ends take the remap path
+    void restart() noexcept {
+        start = map ? map_size / 2 * chunk_size + chunk_size / 2 : 0;
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    deque() noexcept : map(nullptr), map_size(0), start(0), count(0), free_chunks(nullptr), free_count(0) {}
+
+    deque(size_type n, const value_type& val) : deque() {
+        for (size_type i = 0; i < n; i ++ ) push_back(val);
+    }
+
+    deque(const std::initializer_list<value_type>& init) : deque() {
+        for (auto& val : init) push_back(val);
+    }
+
+    deque(const deque& rhs) : deque() {
+        for (auto& val : rhs) push_back(val);
+    }
+
+    deque(deque&& rhs) noexcept : deque() {
+        swap(rhs);
+    }
+
+    deque& operator=(const deque& rhs) {
+        if (this == &rhs) return *this;
+        auto tmp = rhs;
+        swap(tmp);
+        return *this;
+    }
+
+    deque& operator=(deque&& rhs) noexcept {
+        if (this == &rhs) return *this;
+        clear();
+        swap(rhs);
+        return *this;
+    }
+
+    ~deque() {
+        clear();
+        release_free_chunks();
+        if (map) Alloc::deallocate(map, map_size * sizeof (T*));
+    }
+
+    bool operator==(const deque& rhs) const {
+        return count == rhs.count && ministl::equal(begin(), end(), rhs.begin());
+    }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return count; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    // chunks waiting in the free list
+    size_type idle_chunks() const noexcept { return free_count; }
+
+    /**
+     * the next slot sits in a chunk that is already mapped unless the
+     * deque is empty or the slot opens a new chunk, only then is the map
+     * checked for room and a chunk taken. if the constructor throws the
+     * fresh chunk goes back to the free list.
+     */
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        auto pos = start + count;
+        if (count == 0 || (pos & (chunk_size - 1)) == 0) [[unlikely]] {
+            if (pos == map_size * chunk_size) remap(0), pos = start + count;
+            map_chunk(pos);
+            try {
+                ::new (&at_position(pos)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                recycle_chunk(map[pos >> chunk_shift]);
+                throw;
+            }
+        } else {
+            ::new (&at_position(pos)) T(std::forward<Args>(args)...);
+        }
+        count ++ ;
+        return at_position(pos);
+    }
+
+    template<typename... Args>
+    reference emplace_front(Args&&... args) {
+        if (count == 0 || (start & (chunk_size - 1)) == 0) [[unlikely]] {
+            if (start == 0) remap(0);
+            map_chunk(start - 1);
+            try {
+                ::new (&at_position(start - 1)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                recycle_chunk(map[(start - 1) >> chunk_shift]);
+                throw;
+            }
+        } else {
+            ::new (&at_position(start - 1)) T(std::forward<Args>(args)...);
+        }
+        start -- , count ++ ;
+        return at_position(start);
+    }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+
+    void push_front(const value_type& val) { emplace_front(val); }
+
+    void push_front(value_type&& val) { emplace_front(std::move(val)); }
+
+    void pop_back() {
+        assert(count);
+        auto pos = start + count - 1;
+        at_position(pos).~T();
+        count -- ;
+        if (count == 0 || (pos & (chunk_size - 1)) == 0) recycle_chunk(map[pos >> chunk_shift]);
+        if (count == 0) restart();
+    }
+
+    void pop_front() {
+        assert(count);
+        auto pos = start;
+        at_position(pos).~T();
+        start ++ , count -- ;
+        if (count == 0 || (start & (chunk_size - 1)) == 0) recycle_chunk(map[pos >> chunk_shift]);
+        if (count == 0) restart();
+    }
+
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < count; i ++ ) at_position(start + i).~T();
+        }
+        for (size_type c = first_chunk(); c < last_chunk(); c ++ ) recycle_chunk(map[c]);
+        count = 0;
+        restart();
+    }
+
+    /**
+     * give the free chunks back to the allocator and shrink the map to the
+     * chunks in use; an empty deque drops its map too.
+     */
+    void shrink_to_fit() {
+        release_free_chunks();
+        if (!map) return;
+        if (count == 0) {
+            Alloc::deallocate(map, map_size * sizeof (T*));
+            map = nullptr, map_size = 0, start = 0;
+            return;
+        }
+        size_type used = last_chunk() - first_chunk();
+        if (used + 2 < map_size) remap(used + 2);
+    }
+
+    void swap(deque& rhs) noexcept {
+        ministl::swap(map, rhs.map);
+        ministl::swap(map_size, rhs.map_size);
+        ministl::swap(start, rhs.start);
+        ministl::swap(count, rhs.count);
+        ministl::swap(free_chunks, rhs.free_chunks);
+        ministl::swap(free_count, rhs.free_count);
+    }
+
+    reference operator[](size_type idx) { return at_position(start + idx); }
+
+    const_reference operator[](size_type idx) const { return at_position(start + idx); }
+
+    reference at(size_type idx) {
+        return const_cast<reference>(static_cast<const deque*>(this)->at(idx));
+    }
+
+    const_reference at(size_type idx) const {
+        if (idx >= count)
+            throw std::out_of_range("index outof bound");
+        return at_position(start + idx);
+    }
+
+    reference front() { return at_position(start); }
+
+    const_reference front() const { return at_position(start); }
+
+    reference back() { return at_position(start + count - 1); }
+
+    const_reference back() const { return at_position(start + count - 1); }
+
+    /**
+     * Iterator
+     */
+    iterator begin() noexcept { return iterator(map + (start >> chunk_shift), start & (chunk_size - 1)); }
+
+    iterator end() noexcept {
+        auto pos = start + count;
+        return iterator(map + (pos >> chunk_shift), pos & (chunk_size - 1));
+    }
+
+    const_iterator begin() const noexcept { return const_cast<deque*>(this)->begin(); }
+
+    const_iterator end() const noexcept { return const_cast<deque*>(this)->end(); }
+
+    ministl::reverse_iterator<iterator> rbegin() noexcept { return ministl::reverse_iterator<iterator>(end()); }
+
+    ministl::reverse_iterator<iterator> rend() noexcept { return ministl::reverse_iterator<iterator>(begin()); }
+
+    ministl::reverse_iterator<const_iterator> rbegin() const noexcept {
+        return ministl::reverse_iterator<const_iterator>(end());
+    }
+
+    ministl::reverse_iterator<const_iterator> rend() const noexcept {
+        return ministl::reverse_iterator<const_iterator>(begin());
+    }
+};
+
+}
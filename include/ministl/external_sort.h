@@ -0,0 +1,509 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/functional.h>
+#include <ministl/vector.h>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ministl
+{
+
+struct external_sort_options {
+    // bytes of record buffers the sort may hold at once
+    size_t memory_budget = size_t(256) << 20;
+    // directory of the spilled runs; nullptr means $TMPDIR, then /tmp
+    const char* temp_dir = nullptr;
+};
+
+struct external_sort_stats {
+    size_t elements = 0;
+    size_t runs = 0;         // sorted runs spilled by the first pass
+    size_t merge_passes = 0; // k-way merge passes over the data
+};
+
+namespace external_detail
+{
+
+[[noreturn]] inline void fail(const std::string& what) {
+    throw std::runtime_error("external_sort: " + what + ": " + std::strerror(errno));
+}
+
+/**
+ * an open file descriptor, closed on destruction
+ */
+class file {
+private:
+    int fd;
+
+public:
+    explicit file(int fd = -1) : fd(fd) {}
+
+    file(const file&) = delete;
+
+    file& operator=(const file&) = delete;
+
+    file(file&& rhs) noexcept : fd(rhs.fd) { rhs.fd = -1; }
+
+    file& operator=(file&& rhs) noexcept {
+        if (this == &rhs) return *this;
+        if (fd >= 0) ::close(fd);
+        fd = rhs.fd;
+        rhs.fd = -1;
+        return *this;
+    }
+
+    ~file() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    int get() const noexcept { return fd; }
+
+    static file open_read(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) fail(std::string("open ") + path);
+        return file(fd);
+    }
+
+    static file open_write(const char* path) {
+        int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) fail(std::string("create ") + path);
+        return file(fd);
+    }
+
+    // anonymous temporary file, gone once closed
+    static file temporary(const char* dir) {
+        std::string base = dir ? dir : (std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp");
+        std::string path = base + "/ministl_run_XXXXXX";
+        int fd = ::mkstemp(path.data());
+        if (fd < 0) fail("mkstemp in " + base);
+        ::unlink(path.c_str());
+        return file(fd);
+    }
+
+    size_t size() const {
+        struct stat st;
+        if (::fstat(fd, &st) != 0) fail("fstat");
+        return size_t(st.st_size);
+    }
+
+    void read_at(void* buf, size_t bytes, size_t offset) const {
+        auto dst = static_cast<char*>(buf);
+        while (bytes) {
+            auto got = ::pread(fd, dst, bytes, off_t(offset));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {
+                if (got == 0) errno = EIO;
+                fail("read");
+            }
+            dst += got, bytes -= size_t(got), offset += size_t(got);
+        }
+    }
+
+    void write_at(const void* buf, size_t bytes, size_t offset) const {
+        auto src = static_cast<const char*>(buf);
+        while (bytes) {
+            auto put = ::pwrite(fd, src, bytes, off_t(offset));
+            if (put < 0 && errno == EINTR) continue;
+            if (put < 0) fail("write");
+            src += put, bytes -= size_t(put), offset += size_t(put);
+        }
+    }
+};
+
+/**
+ * background thread running i/o jobs in submission order, so reads of the
+ * next block and writes of the last one overlap with sorting and merging
+ */
+class io_queue {
+private:
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<std::packaged_task<void()>> jobs;
+    bool stopping = false;
+    std::thread worker;
+
+    void run() {
+        while (true) {
+            std::packaged_task<void()> job;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+public:
+    io_queue() : worker([this] { run(); }) {}
+
+    io_queue(const io_queue&) = delete;
+
+    io_queue& operator=(const io_queue&) = delete;
+
+    ~io_queue() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    template<typename Fn>
+    std::future<void> submit(Fn fn) {
+        std::packaged_task<void()> job(std::move(fn));
+        auto res = job.get_future();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_one();
+        return res;
+    }
+};
+
+inline void wait(std::future<void>& pending) {
+    if (pending.valid()) pending.get();
+}
+
+// a sorted run: count records at byte offset of a pass's spill file
+struct run {
+    size_t offset;
+    size_t count;
+};
+
+/**
+ * sequential reader of one run, double buffered: while the merge consumes
+ * one block the io thread fills the other
+ */
+template<typename T>
+class run_reader {
+private:
+    const file* src;
+    size_t next_offset, remaining; // not yet requested
+    ministl::vector<T> blocks[2];
+    size_t block_len[2] = {0, 0};
+    std::future<void> pending;
+    int active = 0;
+    size_t pos = 0;
+    io_queue* io;
+
+    void request(int idx) {
+        auto n = remaining < blocks[idx].size() ? remaining : blocks[idx].size();
+        block_len[idx] = n;
+        if (n == 0) return;
+        auto dst = blocks[idx].begin();
+        auto offset = next_offset;
+        next_offset += n * sizeof (T);
+        remaining -= n;
+        pending = io->submit([this, dst, n, offset] { src->read_at(dst, n * sizeof (T), offset); });
+    }
+
+public:
+    run_reader(const file& src, const run& r, size_t block_elems, io_queue& io) :
+        src(&src), next_offset(r.offset), remaining(r.count), io(&io) {
+        blocks[0] = ministl::vector<T>(block_elems);
+        blocks[1] = ministl::vector<T>(block_elems);
+        request(0);
+        wait(pending);
+        request(1);
+    }
+
+    run_reader(const run_reader&) = delete;
+
+    ~run_reader() {
+        // the io thread may still be writing into our buffer
+        try {
+            wait(pending);
+        } catch (...) {}
+    }
+
+    // current element, nullptr once the run is exhausted
+    const T* head() const noexcept { return pos < block_len[active] ? blocks[active].begin() + pos : nullptr; }
+
+    void advance() {
+        if ( ++ pos < block_len[active]) return;
+        wait(pending);
+        active ^= 1;
+        pos = 0;
+        request(active ^ 1);
+    }
+};
+
+/**
+ * sequential writer, double buffered: a full block is handed to the io
+ * thread and filling continues in the other one
+ */
+template<typename T>
+class run_writer {
+private:
+    const file* dst;
+    size_t offset;
+    ministl::vector<T> blocks[2];
+    size_t fill = 0;
+    int active = 0;
+    std::future<void> pending;
+    io_queue* io;
+
+public:
+    run_writer(const file& dst, size_t offset, size_t block_elems, io_queue& io) : dst(&dst), offset(offset), io(&io) {
+        blocks[0] = ministl::vector<T>(block_elems);
+        blocks[1] = ministl::vector<T>(block_elems);
+    }
+
+    run_writer(const run_writer&) = delete;
+
+    ~run_writer() {
+        try {
+            wait(pending);
+        } catch (...) {}
+    }
+
+    void push(const T& val) {
+        blocks[active][fill ++ ] = val;
+        if (fill == blocks[active].size()) flush_block();
+    }
+
+    void flush_block() {
+        wait(pending);
+        if (fill == 0) return;
+        auto src = blocks[active].begin();
+        auto bytes = fill * sizeof (T);
+        auto at = offset;
+        pending = io->submit([this, src, bytes, at] { dst->write_at(src, bytes, at); });
+        offset += bytes;
+        active ^= 1;
+        fill = 0;
+    }
+
+    void finish() {
+        flush_block();
+        wait(pending);
+    }
+};
+
+/**
+ * tournament tree of losers over k sources. the root holds the source with
+ * the smallest head, every inner node the loser of the match played there,
+ * so replacing the winner replays a single leaf-to-root path: log2(k)
+ * comparisons. exhausted sources lose to everything; ties go to the lower
+ * source index, which keeps the merge stable.
+ */
+template<typename T, typename Compare>
+class loser_tree {
+private:
+    ministl::vector<run_reader<T>*> sources;
+    ministl::vector<size_t> tree;
+    size_t k;
+    Compare cmp;
+
+    bool beats(size_t a, size_t b) const {
+        auto ha = sources[a]->head(), hb = sources[b]->head();
+        if (!ha) return false;
+        if (!hb) return true;
+        if (cmp(*ha, *hb)) return true;
+        if (cmp(*hb, *ha)) return false;
+        return a < b;
+    }
+
+    // winner of the subtree at node, filling losers on the way
+    size_t build(size_t node) {
+        if (node >= k) return node - k;
+        auto left = build(node * 2), right = build(node * 2 + 1);
+        if (beats(left, right)) {
+            tree[node] = right;
+            return left;
+        }
+        tree[node] = left;
+        return right;
+    }
+
+public:
+    loser_tree(const ministl::vector<run_reader<T>*>& sources, Compare cmp) :
+        sources(sources), tree(sources.size() < 2 ? 2 : sources.size(), 0), k(sources.size()), cmp(cmp) {
+        tree[0] = k == 1 ? 0 : build(1);
+    }
+
+    // smallest head over all sources, nullptr when all are exhausted
+    const T* top() const { return sources[tree[0]]->head(); }
+
+    // advance the winning source and replay its path
+    void pop() {
+        auto winner = tree[0];
+        sources[winner]->advance();
+        for (auto node = (winner + k) / 2; node > 0; node /= 2) {
+            if (beats(tree[node], winner)) ministl::swap(tree[node], winner);
+        }
+        tree[0] = winner;
+    }
+};
+
+}
+
+/**
+ * sort a binary file of trivially copyable records into another file,
+ * holding at most about options.memory_budget bytes of records.
+ *
+ * pass one reads chunks into two reusable buffers, stable sorts a chunk
+ * while the io thread reads the next one and spills the last one, and
+ * writes each chunk as a sorted run into an unlinked temporary file. later
+ * passes merge up to fan-in runs at a time through a loser tree, with
+ * every input and the output double buffered on the io thread. every pass
+ * spills into a single file, so no more than two are open at any time
+ * however many runs there are. the fan-in
+ * keeps each buffer at least 256 KiB, so reads stay sequential enough to
+ * run close to disk bandwidth. the sort is stable.
+ *
+ * i/o errors throw std::runtime_error.
+ */
+template<typename T, typename Compare>
+external_sort_stats external_sort(const char* input_path, const char* output_path,
+        Compare cmp, external_sort_options options = {}) {
+    static_assert(std::is_trivially_copyable_v<T>, "records are moved to and from disk as bytes");
+    using namespace external_detail;
+    constexpr size_t min_block_bytes = size_t(256) << 10;
+
+    external_sort_stats stats;
+    auto input = file::open_read(input_path);
+    auto input_bytes = input.size();
+    if (input_bytes % sizeof (T)) {
+        errno = EINVAL;
+        fail(std::string(input_path) + " is not a whole number of records");
+    }
+    auto n = input_bytes / sizeof (T);
+    stats.elements = n;
+
+    // two chunks plus the stable sort scratch of half a chunk
+    auto budget = options.memory_budget;
+    size_t chunk_elems = budget * 2 / 5 / sizeof (T);
+    if (chunk_elems < 1) chunk_elems = 1;
+
+    io_queue io;
+    auto output = file::open_write(output_path);
+
+    if (n <= chunk_elems) {
+        ministl::vector<T> all(n);
+        if (n) input.read_at(all.begin(), n * sizeof (T), 0);
+        ministl::stable_sort(all.begin(), all.end(), cmp);
+        if (n) output.write_at(all.begin(), n * sizeof (T), 0);
+        stats.runs = n ? 1 : 0;
+        return stats;
+    }
+
+    /**
+     * pass one: sorted runs, back to back in one spill file
+     */
+    auto spill = file::temporary(options.temp_dir);
+    ministl::vector<run> runs;
+    {
+        ministl::vector<T> chunks[2] = {ministl::vector<T>(chunk_elems), ministl::vector<T>(chunk_elems)};
+        std::future<void> reading[2], writing[2];
+        auto chunk_count = (n + chunk_elems - 1) / chunk_elems;
+        auto chunk_len = [&](size_t c) { return c + 1 < chunk_count ? chunk_elems : n - c * chunk_elems; };
+        auto read_chunk = [&](size_t c) {
+            auto dst = chunks[c % 2].begin();
+            auto bytes = chunk_len(c) * sizeof (T), offset = c * chunk_elems * sizeof (T);
+            const file* src = &input;
+            reading[c % 2] = io.submit([src, dst, bytes, offset] { src->read_at(dst, bytes, offset); });
+        };
+        for (size_t c = 0; c < chunk_count; c ++ ) runs.push_back({c * chunk_elems * sizeof (T), chunk_len(c)});
+
+        try {
+            read_chunk(0);
+            for (size_t c = 0; c < chunk_count; c ++ ) {
+                auto& chunk = chunks[c % 2];
+                wait(reading[c % 2]);
+                if (c + 1 < chunk_count) {
+                    // the other buffer is free once its run is on disk
+                    wait(writing[(c + 1) % 2]);
+                    read_chunk(c + 1);
+                }
+                ministl::stable_sort(chunk.begin(), chunk.begin() + chunk_len(c), cmp);
+                auto src = chunk.begin();
+                auto bytes = chunk_len(c) * sizeof (T), offset = runs[c].offset;
+                const file* dst = &spill;
+                writing[c % 2] = io.submit([dst, src, bytes, offset] { dst->write_at(src, bytes, offset); });
+            }
+            wait(writing[0]);
+            wait(writing[1]);
+        } catch (...) {
+            // the io thread may still use the chunks: let it finish before they go
+            for (auto pending : {&reading[0], &reading[1], &writing[0], &writing[1]}) {
+                try {
+                    wait(*pending);
+                } catch (...) {}
+            }
+            throw;
+        }
+    }
+    stats.runs = runs.size();
+
+    /**
+     * merge passes: groups of up to fan_in runs, the last pass into output
+     */
+    size_t fan_in = budget / (2 * min_block_bytes);
+    if (fan_in > 1) fan_in -= 1;
+    if (fan_in < 2) fan_in = 2;
+    while (runs.size() > 1) {
+        stats.merge_passes ++ ;
+        bool last_pass = runs.size() <= fan_in;
+        auto next_spill = last_pass ? file() : file::temporary(options.temp_dir);
+        const file& dst = last_pass ? output : next_spill;
+        ministl::vector<run> merged;
+        size_t offset = 0;
+        for (size_t first = 0; first < runs.size(); first += fan_in) {
+            auto k = runs.size() - first < fan_in ? runs.size() - first : fan_in;
+            // 2 blocks for each input and for the output
+            size_t block_elems = budget / (2 * (k + 1)) / sizeof (T);
+            if (block_elems < 1) block_elems = 1;
+
+            run target {offset, 0};
+            ministl::vector<run_reader<T>*> readers;
+            try {
+                for (size_t i = 0; i < k; i ++ ) {
+                    readers.push_back(new run_reader<T>(spill, runs[first + i], block_elems, io));
+                    target.count += runs[first + i].count;
+                }
+                loser_tree<T, Compare> tree(readers, cmp);
+                run_writer<T> writer(dst, offset, block_elems, io);
+                for (const T* top; (top = tree.top()); tree.pop()) writer.push(*top);
+                writer.finish();
+            } catch (...) {
+                for (auto reader : readers) delete reader;
+                throw;
+            }
+            for (auto reader : readers) delete reader;
+            offset += target.count * sizeof (T);
+            merged.push_back(target);
+        }
+        if (last_pass) break;
+        runs = std::move(merged);
+        spill = std::move(next_spill);
+    }
+    return stats;
+}
+
+template<typename T>
+external_sort_stats external_sort(const char* input_path, const char* output_path,
+        external_sort_options options = {}) {
+    return ministl::external_sort<T>(input_path, output_path, ministl::less<> {}, options);
+}
+
+}
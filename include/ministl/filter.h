@@ -0,0 +1,582 @@
+#pragma once
+#include <ministl/functional.h>
+#include <ministl/vector.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace ministl
+{
+
+namespace filter_detail
+{
+
+/**
+ * flat layout shared by the filters, so a serialized filter can be
+ * mmapped and queried in place (host byte order):
+ *   64 byte header: magic, u64 words, u64 items, u64 extra, zero padding
+ *   words * u64 payload
+ * with a 64 byte aligned buffer the payload stays cache line aligned.
+ */
+struct flat_header {
+    char magic[8];
+    uint64_t words;
+    uint64_t items;
+    uint64_t extra;
+    uint64_t padding[4];
+};
+
+static_assert(sizeof (flat_header) == 64);
+
+// keys per batch step: hash and prefetch them all, then probe
+constexpr size_t batch = 32;
+
+/**
+ * the words of a filter: owned (a ministl::vector, over-allocated so the
+ * first word sits on a cache line) or a read-only view of a flat buffer
+ */
+class word_storage {
+private:
+    ministl::vector<uint64_t> storage;
+    uint64_t* first;
+    size_t count;
+    bool viewed;
+
+    void allocate(size_t words) {
+        storage = ministl::vector<uint64_t>(words + 7, 0);
+        auto addr = reinterpret_cast<uintptr_t>(storage.begin());
+        first = storage.begin() + ((64 - addr % 64) % 64) / sizeof (uint64_t);
+        count = words;
+    }
+
+public:
+    word_storage() : first(nullptr), count(0), viewed(false) {}
+
+    explicit word_storage(size_t words) : viewed(false) { allocate(words); }
+
+    word_storage(const word_storage& rhs) : word_storage(rhs.count) {
+        std::memcpy(first, rhs.first, count * sizeof (uint64_t));
+    }
+
+    // the vector keeps its buffer, so first stays valid
+    word_storage(word_storage&& rhs) noexcept :
+        storage(std::move(rhs.storage)), first(rhs.first), count(rhs.count), viewed(rhs.viewed) {
+        rhs.first = nullptr, rhs.count = 0;
+    }
+
+    word_storage& operator=(word_storage rhs) noexcept {
+        storage.swap(rhs.storage);
+        ministl::swap(first, rhs.first);
+        ministl::swap(count, rhs.count);
+        ministl::swap(viewed, rhs.viewed);
+        return *this;
+    }
+
+    static word_storage view(const uint64_t* words, size_t n) {
+        word_storage res;
+        res.first = const_cast<uint64_t*>(words);
+        res.count = n;
+        res.viewed = true;
+        return res;
+    }
+
+    const uint64_t* data() const noexcept { return first; }
+
+    uint64_t* mutable_data() {
+        if (viewed) throw std::logic_error("filter is a read-only view");
+        return first;
+    }
+
+    size_t size() const noexcept { return count; }
+
+    bool is_view() const noexcept { return viewed; }
+};
+
+inline void write_flat(void* out, const char (&magic)[9], const uint64_t* words, size_t n, uint64_t items, uint64_t extra) {
+    flat_header header {};
+    std::memcpy(header.magic, magic, sizeof (header.magic));
+    header.words = n, header.items = items, header.extra = extra;
+    std::memcpy(out, &header, sizeof (header));
+    std::memcpy(static_cast<char*>(out) + sizeof (header), words, n * sizeof (uint64_t));
+}
+
+// the header of a flat buffer, checked against magic and size
+inline flat_header read_flat(const void* data, size_t size, const char (&magic)[9]) {
+    flat_header header;
+    if (size < sizeof (header)) throw std::runtime_error("filter buffer too small");
+    std::memcpy(&header, data, sizeof (header));
+    if (std::memcmp(header.magic, magic, sizeof (header.magic)) != 0) throw std::runtime_error("not a serialized filter of this type");
+    if (header.words > (size - sizeof (header)) / sizeof (uint64_t)) throw std::runtime_error("filter buffer truncated");
+    return header;
+}
+
+inline const uint64_t* flat_words(const void* data) {
+    return reinterpret_cast<const uint64_t*>(static_cast<const char*>(data) + sizeof (flat_header));
+}
+
+/**
+ * bloom block kernels. a key sets one bit in each of the 8 words of its
+ * 512 bit block; the bit in word i is the top 6 bits of
+ * uint32(hash) * salts[i] (the split block scheme of parquet / impala).
+ * the 8 products, shifts and the block test are each one vector op.
+ */
+using u32x8 [[gnu::vector_size(32)]] = uint32_t;
+using u64x8 [[gnu::vector_size(64)]] = uint64_t;
+
+constexpr u32x8 salts = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                         0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+// through a reference: returning a 512 bit vector would depend on the target's abi
+[[gnu::always_inline]] inline void block_mask(uint32_t hash, u64x8& mask) noexcept {
+    u32x8 bit = (hash * salts) >> 26;
+    mask = (u64x8 {} + 1) << __builtin_convertvector(bit, u64x8);
+}
+
+[[gnu::always_inline]] inline bool block_test(const uint64_t* block, uint32_t hash) noexcept {
+    u64x8 words, mask;
+    std::memcpy(&words, block, sizeof (words));
+    block_mask(hash, mask);
+    auto missing = mask & ~words;
+    uint64_t any = 0;
+    for (int i = 0; i < 8; i ++ ) any |= missing[i];
+    return any == 0;
+}
+
+[[gnu::always_inline]] inline void block_set(uint64_t* block, uint32_t hash) noexcept {
+    u64x8 words, mask;
+    std::memcpy(&words, block, sizeof (words));
+    block_mask(hash, mask);
+    words |= mask;
+    std::memcpy(block, &words, sizeof (words));
+}
+
+// block of a 64 bit hash: its high half scaled onto [0, blocks)
+inline size_t block_of(uint64_t hash, size_t blocks) noexcept {
+    return size_t((hash >> 32) * blocks >> 32);
+}
+
+[[gnu::always_inline]] inline size_t test_blocks_body(const uint64_t* words, size_t blocks, const uint64_t* hashes, size_t n, bool* out) {
+    size_t found = 0;
+    for (size_t i = 0; i < n; i ++ ) {
+        out[i] = block_test(words + block_of(hashes[i], blocks) * 8, uint32_t(hashes[i]));
+        found += out[i];
+    }
+    return found;
+}
+
+#if defined(__x86_64__)
+
+// 2: avx-512, 1: avx2, 0: none
+inline int simd_level() {
+    static const int res = __builtin_cpu_supports("avx512f") ? 2 : __builtin_cpu_supports("avx2") ? 1 : 0;
+    return res;
+}
+
+__attribute__((target("avx512f")))
+inline size_t test_blocks_avx512(const uint64_t* words, size_t blocks, const uint64_t* hashes, size_t n, bool* out) {
+    return test_blocks_body(words, blocks, hashes, n, out);
+}
+
+__attribute__((target("avx2")))
+inline size_t test_blocks_avx2(const uint64_t* words, size_t blocks, const uint64_t* hashes, size_t n, bool* out) {
+    return test_blocks_body(words, blocks, hashes, n, out);
+}
+
+#endif
+
+// out[i]: whether the block of hashes[i] has all its bits set; returns how many do
+inline size_t test_blocks(const uint64_t* words, size_t blocks, const uint64_t* hashes, size_t n, bool* out) {
+#if defined(__x86_64__)
+    if (simd_level() == 2) return test_blocks_avx512(words, blocks, hashes, n, out);
+    if (simd_level() == 1) return test_blocks_avx2(words, blocks, hashes, n, out);
+#endif
+    return test_blocks_body(words, blocks, hashes, n, out);
+}
+
+/**
+ * cuckoo buckets: 4 fingerprints of 16 bits in one u64, 0 is an empty
+ * slot. lanes are compared all at once with the has-zero-lane trick.
+ */
+constexpr uint64_t lane_low = 0x0001000100010001ULL;
+constexpr uint64_t lane_high = 0x8000800080008000ULL;
+
+// high bit of every lane that is zero; lanes above the lowest zero lane may be flagged spuriously
+inline uint64_t zero_lanes(uint64_t bucket) noexcept {
+    return (bucket - lane_low) & ~bucket & lane_high;
+}
+
+inline bool bucket_has(uint64_t bucket, uint16_t fp) noexcept {
+    return zero_lanes(bucket ^ (fp * lane_low)) != 0;
+}
+
+inline uint64_t round_up_pow2(uint64_t n) {
+    uint64_t res = 1;
+    while (res < n) res <<= 1;
+    return res;
+}
+
+}
+
+/**
+ * bloom filter where every key lives in a single 64 byte block, so an
+ * insert or a lookup touches one cache line whatever the number of bits
+ * per key. no false negatives; with the default 10 bits per key about 1%
+ * of absent keys are reported present. no deletion, see cuckoo_filter.
+ *
+ * insert_batch / contains_batch hash a group of keys and prefetch their
+ * blocks before touching any, so the cache misses overlap.
+ *
+ * serialize writes a flat buffer that view() can query in place (e.g. an
+ * mmapped file) or load() copies. both sides must use the same Hash.
+ */
+template<typename Key, typename Hash = ministl::hash<Key>>
+class blocked_bloom_filter {
+public:
+    using key_type = Key;
+    using size_type = size_t;
+
+private:
+    constexpr static char magic[9] = "MSTLBLM1";
+
+    filter_detail::word_storage words;
+    size_type blocks;
+    size_type items;
+    Hash hasher;
+
+    blocked_bloom_filter(filter_detail::word_storage&& storage, size_type items) :
+        words(std::move(storage)), blocks(words.size() / 8), items(items) {}
+
+    uint64_t hash_of(const Key& key) const { return uint64_t(hasher(key)); }
+
+public:
+    /**
+     * Constructor: room for expected_items keys at bits_per_key bits each,
+     * rounded up to whole blocks
+     */
+    explicit blocked_bloom_filter(size_type expected_items, double bits_per_key = 10) :
+        blocks(std::max(size_type(1), size_type(expected_items * bits_per_key + 511) / 512)), items(0) {
+        words = filter_detail::word_storage(blocks * 8);
+    }
+
+    /**
+     * Operation
+     */
+    void insert(const Key& key) {
+        auto hash = hash_of(key);
+        filter_detail::block_set(words.mutable_data() + filter_detail::block_of(hash, blocks) * 8, uint32_t(hash));
+        items ++ ;
+    }
+
+    // false: key was never inserted. true: it probably was
+    bool contains(const Key& key) const {
+        auto hash = hash_of(key);
+        return filter_detail::block_test(words.data() + filter_detail::block_of(hash, blocks) * 8, uint32_t(hash));
+    }
+
+    template<typename Iter>
+    void insert_batch(Iter first, Iter last) {
+        auto data = words.mutable_data();
+        uint64_t hashes[filter_detail::batch];
+        while (first != last) {
+            size_t n = 0;
+            for (; n < filter_detail::batch && first != last; ++ first, n ++ ) {
+                hashes[n] = hash_of(*first);
+                __builtin_prefetch(data + filter_detail::block_of(hashes[n], blocks) * 8, 1);
+            }
+            for (size_t i = 0; i < n; i ++ ) {
+                filter_detail::block_set(data + filter_detail::block_of(hashes[i], blocks) * 8, uint32_t(hashes[i]));
+            }
+            items += n;
+        }
+    }
+
+    // *out++ = contains(key) for every key, returns how many were true
+    template<typename Iter, typename OutIter>
+    size_type contains_batch(Iter first, Iter last, OutIter out) const {
+        auto data = words.data();
+        uint64_t hashes[filter_detail::batch];
+        bool found[filter_detail::batch];
+        size_type res = 0;
+        while (first != last) {
+            size_t n = 0;
+            for (; n < filter_detail::batch && first != last; ++ first, n ++ ) {
+                hashes[n] = hash_of(*first);
+                __builtin_prefetch(data + filter_detail::block_of(hashes[n], blocks) * 8);
+            }
+            res += filter_detail::test_blocks(data, blocks, hashes, n, found);
+            for (size_t i = 0; i < n; i ++ ) *out ++ = found[i];
+        }
+        return res;
+    }
+
+    void clear() {
+        std::memset(words.mutable_data(), 0, words.size() * sizeof (uint64_t));
+        items = 0;
+    }
+
+    // inserts so far, repeats included
+    size_type size() const noexcept { return items; }
+
+    size_type block_count() const noexcept { return blocks; }
+
+    size_type memory_bytes() const noexcept { return blocks * 64; }
+
+    bool is_view() const noexcept { return words.is_view(); }
+
+    size_type serialized_size() const noexcept { return sizeof (filter_detail::flat_header) + blocks * 64; }
+
+    // writes serialized_size() bytes to out
+    void serialize(void* out) const {
+        filter_detail::write_flat(out, magic, words.data(), words.size(), items, 0);
+    }
+
+    /**
+     * a read-only filter over a serialized buffer, nothing is copied: data
+     * must outlive it, and should be 64 byte aligned to keep one block per
+     * cache line. insert and clear throw std::logic_error
+     */
+    static blocked_bloom_filter view(const void* data, size_type size) {
+        auto header = filter_detail::read_flat(data, size, magic);
+        if (header.words == 0 || header.words % 8) throw std::runtime_error("filter buffer corrupted");
+        return blocked_bloom_filter(filter_detail::word_storage::view(filter_detail::flat_words(data), header.words), header.items);
+    }
+
+    // a writable copy of a serialized filter
+    static blocked_bloom_filter load(const void* data, size_type size) {
+        auto res = view(data, size);
+        res.words = filter_detail::word_storage(res.words);
+        return res;
+    }
+};
+
+/**
+ * cuckoo filter: 16 bit fingerprints in buckets of 4 (one u64 each), a key
+ * may sit in one of two buckets, the second derived from the first and
+ * the fingerprint alone. unlike a bloom filter it supports erase, and at
+ * the same memory has a lower false positive rate (about 1 in 8000) at
+ * loads up to 95%.
+ *
+ * a lookup reads two buckets. insert moves fingerprints between their two
+ * buckets to make room; when that fails after max_kicks moves the last
+ * displaced fingerprint is kept aside and the filter is full: later
+ * inserts return false. erase must only be called for inserted keys,
+ * otherwise it may remove another key's fingerprint.
+ *
+ * batches, serialize, view and load work as for blocked_bloom_filter.
+ */
+template<typename Key, typename Hash = ministl::hash<Key>>
+class cuckoo_filter {
+public:
+    using key_type = Key;
+    using size_type = size_t;
+
+private:
+    constexpr static char magic[9] = "MSTLCKO1";
+    constexpr static int max_kicks = 500;
+    // extra: bit 63 set when a victim is kept, the bucket in bits 16..62, the fingerprint in 0..15
+    constexpr static uint64_t victim_flag = uint64_t(1) << 63;
+
+    filter_detail::word_storage buckets;
+    size_type mask;
+    size_type items;
+    uint64_t victim;
+    uint64_t rng;
+    Hash hasher;
+
+    cuckoo_filter(filter_detail::word_storage&& storage, size_type items, uint64_t victim) :
+        buckets(std::move(storage)), mask(buckets.size() - 1), items(items), victim(victim), rng(0x9e3779b97f4a7c15ULL) {}
+
+    struct slot_ref {
+        size_type bucket;
+        uint16_t fp;
+    };
+
+    slot_ref locate(const Key& key) const {
+        auto hash = uint64_t(hasher(key));
+        auto fp = uint16_t(hash >> 48);
+        return {size_type(hash) & mask, fp ? fp : uint16_t(1)};
+    }
+
+    size_type alternate(size_type bucket, uint16_t fp) const noexcept {
+        return (bucket ^ size_type(fp * 0x5bd1e995ULL)) & mask;
+    }
+
+    bool victim_is(size_type bucket, uint16_t fp) const noexcept {
+        if (!(victim & victim_flag)) return false;
+        auto stored = size_type(victim >> 16 & ~(victim_flag >> 16));
+        return uint16_t(victim) == fp && (stored == bucket || stored == alternate(bucket, fp));
+    }
+
+    static bool try_place(uint64_t& bucket, uint16_t fp) noexcept {
+        auto free = filter_detail::zero_lanes(bucket);
+        if (!free) return false;
+        bucket |= uint64_t(fp) << (__builtin_ctzll(free) & ~15);
+        return true;
+    }
+
+    static bool try_remove(uint64_t& bucket, uint16_t fp) noexcept {
+        auto hit = filter_detail::zero_lanes(bucket ^ (fp * filter_detail::lane_low));
+        if (!hit) return false;
+        bucket &= ~(uint64_t(0xffff) << (__builtin_ctzll(hit) & ~15));
+        return true;
+    }
+
+    bool lookup(size_type bucket, uint16_t fp) const noexcept {
+        auto data = buckets.data();
+        return filter_detail::bucket_has(data[bucket], fp) ||
+               filter_detail::bucket_has(data[alternate(bucket, fp)], fp) || victim_is(bucket, fp);
+    }
+
+    bool place(size_type bucket, uint16_t fp) {
+        auto data = buckets.mutable_data();
+        if (try_place(data[bucket], fp)) return true;
+        bucket = alternate(bucket, fp);
+        if (try_place(data[bucket], fp)) return true;
+        // evict a random fingerprint and move it to its other bucket
+        for (int kick = 0; kick < max_kicks; kick ++ ) {
+            rng ^= rng << 13, rng ^= rng >> 7, rng ^= rng << 17;
+            auto shift = (rng & 3) * 16;
+            auto evicted = uint16_t(data[bucket] >> shift);
+            data[bucket] = (data[bucket] & ~(uint64_t(0xffff) << shift)) | (uint64_t(fp) << shift);
+            fp = evicted;
+            bucket = alternate(bucket, fp);
+            if (try_place(data[bucket], fp)) return true;
+        }
+        victim = victim_flag | uint64_t(bucket) << 16 | fp;
+        return true;
+    }
+
+public:
+    /**
+     * Constructor: room for capacity keys at a load of at most 95%, the
+     * bucket count is rounded up to a power of two
+     */
+    explicit cuckoo_filter(size_type capacity) :
+        mask(filter_detail::round_up_pow2(std::max(size_type(1), (capacity * 100 + 379) / 380)) - 1),
+        items(0), victim(0), rng(0x9e3779b97f4a7c15ULL) {
+        buckets = filter_detail::word_storage(mask + 1);
+    }
+
+    /**
+     * Operation
+     */
+
+    // false when the filter is full, the key is then not added
+    bool insert(const Key& key) {
+        if (victim & victim_flag) return false;
+        auto [bucket, fp] = locate(key);
+        place(bucket, fp);
+        items ++ ;
+        return true;
+    }
+
+    // false: key is absent. true: it probably is present
+    bool contains(const Key& key) const {
+        auto [bucket, fp] = locate(key);
+        return lookup(bucket, fp);
+    }
+
+    // removes one copy of key's fingerprint, returns whether there was one
+    bool erase(const Key& key) {
+        auto [bucket, fp] = locate(key);
+        auto data = buckets.mutable_data();
+        if (victim_is(bucket, fp)) {
+            victim = 0;
+        } else if (!try_remove(data[bucket], fp) && !try_remove(data[alternate(bucket, fp)], fp)) {
+            return false;
+        } else if (victim & victim_flag) {
+            // a slot opened up, give the kept fingerprint another try
+            auto kept = victim;
+            victim = 0;
+            place(size_type(kept >> 16 & ~(victim_flag >> 16)), uint16_t(kept));
+        }
+        items -- ;
+        return true;
+    }
+
+    // inserts keys until the filter is full, returns how many went in
+    template<typename Iter>
+    size_type insert_batch(Iter first, Iter last) {
+        auto data = buckets.mutable_data();
+        slot_ref refs[filter_detail::batch];
+        size_type res = 0;
+        while (first != last) {
+            size_t n = 0;
+            for (; n < filter_detail::batch && first != last; ++ first, n ++ ) {
+                refs[n] = locate(*first);
+                __builtin_prefetch(data + refs[n].bucket, 1);
+                __builtin_prefetch(data + alternate(refs[n].bucket, refs[n].fp), 1);
+            }
+            for (size_t i = 0; i < n; i ++ ) {
+                if (victim & victim_flag) return res;
+                place(refs[i].bucket, refs[i].fp);
+                items ++ , res ++ ;
+            }
+        }
+        return res;
+    }
+
+    // *out++ = contains(key) for every key, returns how many were true
+    template<typename Iter, typename OutIter>
+    size_type contains_batch(Iter first, Iter last, OutIter out) const {
+        auto data = buckets.data();
+        slot_ref refs[filter_detail::batch];
+        size_type res = 0;
+        while (first != last) {
+            size_t n = 0;
+            for (; n < filter_detail::batch && first != last; ++ first, n ++ ) {
+                refs[n] = locate(*first);
+                __builtin_prefetch(data + refs[n].bucket);
+                __builtin_prefetch(data + alternate(refs[n].bucket, refs[n].fp));
+            }
+            for (size_t i = 0; i < n; i ++ ) {
+                bool found = lookup(refs[i].bucket, refs[i].fp);
+                *out ++ = found;
+                res += found;
+            }
+        }
+        return res;
+    }
+
+    void clear() {
+        std::memset(buckets.mutable_data(), 0, buckets.size() * sizeof (uint64_t));
+        items = 0, victim = 0;
+    }
+
+    size_type size() const noexcept { return items; }
+
+    // fingerprint slots, 4 per bucket
+    size_type capacity() const noexcept { return buckets.size() * 4; }
+
+    double load_factor() const noexcept { return double(items) / double(capacity()); }
+
+    bool full() const noexcept { return victim & victim_flag; }
+
+    size_type memory_bytes() const noexcept { return buckets.size() * sizeof (uint64_t); }
+
+    bool is_view() const noexcept { return buckets.is_view(); }
+
+    size_type serialized_size() const noexcept { return sizeof (filter_detail::flat_header) + memory_bytes(); }
+
+    void serialize(void* out) const {
+        filter_detail::write_flat(out, magic, buckets.data(), buckets.size(), items, victim);
+    }
+
+    static cuckoo_filter view(const void* data, size_type size) {
+        auto header = filter_detail::read_flat(data, size, magic);
+        if (header.words == 0 || (header.words & (header.words - 1))) throw std::runtime_error("filter buffer corrupted");
+        return cuckoo_filter(filter_detail::word_storage::view(filter_detail::flat_words(data), header.words),
+                             header.items, header.extra);
+    }
+
+    static cuckoo_filter load(const void* data, size_type size) {
+        auto res = view(data, size);
+        res.buckets = filter_detail::word_storage(res.buckets);
+        return res;
+    }
+};
+
+}
@@ -0,0 +1,387 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/iterator.h>
+#include <ministl/node_pool.h>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+namespace ministl
+{
+
+/**
+ * link of a singly linked list. the list object owns a sentinel link that
+ * sits before the first element, so end() is nullptr.
+ */
+struct forward_list_hook {
+    forward_list_hook* next = nullptr;
+};
+
+namespace forward_list_detail
+{
+
+/**
+ * forward iterator over hooks, Project maps a hook to its element
+ */
+template<typename T, typename Project, bool Const>
+class hook_iterator {
+public:
+    using iterator_category = ministl::forward_iterator_tag;
+    using value_type = T;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+    using difference_type = ptrdiff_t;
+
+private:
+    forward_list_hook* cur;
+
+public:
+    hook_iterator() : cur(nullptr) {}
+
+    explicit hook_iterator(const forward_list_hook* hook) : cur(const_cast<forward_list_hook*>(hook)) {}
+
+    // iterator -> const_iterator
+    template<bool RhsConst, typename = std::enable_if_t<Const && !RhsConst>>
+    hook_iterator(const hook_iterator<T, Project, RhsConst>& rhs) : cur(rhs.hook()) {}
+
+    forward_list_hook* hook() const noexcept { return cur; }
+
+    reference operator*() const { return *Project {}(cur); }
+
+    pointer operator->() const { return Project {}(cur); }
+
+    hook_iterator& operator++() {
+        cur = cur->next;
+        return *this;
+    }
+
+    hook_iterator operator++(int) {
+        auto res = *this;
+        cur = cur->next;
+        return res;
+    }
+
+    friend bool operator==(const hook_iterator& lhs, const hook_iterator& rhs) {
+        return lhs.cur == rhs.cur;
+    }
+
+    friend bool operator!=(const hook_iterator& lhs, const hook_iterator& rhs) {
+        return lhs.cur != rhs.cur;
+    }
+};
+
+}
+
+/**
+ * singly linked list with O(1) size(), nodes come from a slab pool
+ * (see node_pool.h and ministl::list for the Pool policies)
+ */
+template<typename T, typename Pool = ministl::container_pool>
+class forward_list {
+private:
+    struct node : forward_list_hook {
+        T value;
+
+        template<typename... Args>
+        node(Args&&... args) : value(std::forward<Args>(args)...) {}
+    };
+
+    struct project {
+        T* operator()(forward_list_hook* hook) const { return &static_cast<node*>(hook)->value; }
+    };
+
+    using pool_type = typename Pool::template pool<sizeof (node), alignof (node)>;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = forward_list_detail::hook_iterator<T, project, false>;
+    using const_iterator = forward_list_detail::hook_iterator<T, project, true>;
+
+private:
+    forward_list_hook head;
+    size_type count;
+    pool_type pool;
+
+    void destroy_node(forward_list_hook* hook) noexcept {
+        auto ptr = static_cast<node*>(hook);
+        ptr->~node();
+        pool.deallocate(ptr);
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    forward_list() : count(0) {}
+
+    forward_list(size_type n, const value_type& val) : forward_list() {
+        for (size_type i = 0; i < n; i ++ ) push_front(val);
+    }
+
+    forward_list(const std::initializer_list<value_type>& init) : forward_list() {
+        auto pos = before_begin();
+        for (auto& val : init) pos = insert_after(pos, val);
+    }
+
+    forward_list(const forward_list& rhs) : forward_list() {
+        auto pos = before_begin();
+        for (auto& val : rhs) pos = insert_after(pos, val);
+    }
+
+    forward_list(forward_list&& rhs) noexcept : forward_list() {
+        swap(rhs);
+    }
+
+    forward_list& operator=(const forward_list& rhs) {
+        if (this == &rhs) return *this;
+        auto tmp = rhs;
+        swap(tmp);
+        return *this;
+    }
+
+    forward_list& operator=(forward_list&& rhs) noexcept {
+        if (this == &rhs) return *this;
+        clear();
+        swap(rhs);
+        return *this;
+    }
+
+    ~forward_list() { clear(); }
+
+    bool operator==(const forward_list& rhs) const {
+        if (count != rhs.count) return false;
+        for (auto i = begin(), j = rhs.begin(); i != end(); ++ i, ++ j) {
+            if (!(*i == *j)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return count; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    reference front() { return *begin(); }
+
+    const_reference front() const { return *begin(); }
+
+    template<typename... Args>
+    iterator emplace_after(const_iterator pos, Args&&... args) {
+        void* raw = pool.allocate();
+        node* ptr;
+        try {
+            ptr = ::new (raw) node(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.deallocate(raw);
+            throw;
+        }
+        auto prev = pos.hook();
+        ptr->next = prev->next;
+        prev->next = ptr;
+        count ++ ;
+        return iterator(ptr);
+    }
+
+    iterator insert_after(const_iterator pos, const value_type& val) { return emplace_after(pos, val); }
+
+    iterator insert_after(const_iterator pos, value_type&& val) { return emplace_after(pos, std::move(val)); }
+
+    template<typename... Args>
+    void emplace_front(Args&&... args) { emplace_after(before_begin(), std::forward<Args>(args)...); }
+
+    void push_front(const value_type& val) { emplace_after(before_begin(), val); }
+
+    void push_front(value_type&& val) { emplace_after(before_begin(), std::move(val)); }
+
+    iterator erase_after(const_iterator pos) {
+        auto prev = pos.hook(), victim = prev->next;
+        assert(victim);
+        prev->next = victim->next;
+        destroy_node(victim);
+        count -- ;
+        return iterator(prev->next);
+    }
+
+    iterator erase_after(const_iterator pos, const_iterator last) {
+        while (pos.hook()->next != last.hook()) erase_after(pos);
+        return iterator(last.hook());
+    }
+
+    void pop_front() { erase_after(before_begin()); }
+
+    void clear() noexcept {
+        for (auto hook = head.next; hook; ) {
+            auto next = hook->next;
+            destroy_node(hook);
+            hook = next;
+        }
+        head.next = nullptr;
+        count = 0;
+    }
+
+    void swap(forward_list& rhs) noexcept {
+        ministl::swap(head.next, rhs.head.next);
+        ministl::swap(count, rhs.count);
+        pool.swap(rhs.pool);
+    }
+
+    /**
+     * move all of rhs after pos. nodes are relinked as in list::splice;
+     * O(size of rhs) to find its tail
+     */
+    void splice_after(const_iterator pos, forward_list& rhs) {
+        if (this == &rhs || rhs.empty()) return;
+        pool.absorb(rhs.pool);
+        auto last = rhs.head.next;
+        while (last->next) last = last->next;
+        auto prev = pos.hook();
+        last->next = prev->next;
+        prev->next = rhs.head.next;
+        count += rhs.count;
+        rhs.head.next = nullptr;
+        rhs.count = 0;
+    }
+
+    // move the element after it (in rhs) to after pos
+    void splice_after(const_iterator pos, forward_list& rhs, const_iterator it) {
+        auto prev = it.hook(), moved = prev->next;
+        if (!moved || pos.hook() == prev || pos.hook() == moved) return;
+        if (this != &rhs) pool.share(rhs.pool);
+        prev->next = moved->next;
+        moved->next = pos.hook()->next;
+        pos.hook()->next = moved;
+        if (this != &rhs) count ++ , rhs.count -- ;
+    }
+
+    void reverse() noexcept {
+        forward_list_hook* prev = nullptr;
+        for (auto cur = head.next; cur; ) {
+            auto next = cur->next;
+            cur->next = prev;
+            prev = cur;
+            cur = next;
+        }
+        head.next = prev;
+    }
+
+    /**
+     * Iterator
+     */
+    iterator before_begin() noexcept { return iterator(&head); }
+
+    const_iterator before_begin() const noexcept { return const_iterator(&head); }
+
+    iterator begin() noexcept { return iterator(head.next); }
+
+    iterator end() noexcept { return iterator(nullptr); }
+
+    const_iterator begin() const noexcept { return const_iterator(head.next); }
+
+    const_iterator end() const noexcept { return const_iterator(nullptr); }
+};
+
+/**
+ * intrusive singly linked list: elements embed a forward_list_hook member,
+ * nothing is allocated. O(1) size, push_front/pop_front and a tail pointer
+ * for O(1) push_back, which makes it a cheap FIFO of jobs.
+ */
+template<typename T, forward_list_hook T::*Hook>
+class intrusive_forward_list {
+private:
+    struct project {
+        T* operator()(forward_list_hook* hook) const {
+            return ministl::member_owner(hook, Hook);
+        }
+    };
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = forward_list_detail::hook_iterator<T, project, false>;
+    using const_iterator = forward_list_detail::hook_iterator<T, project, true>;
+
+private:
+    forward_list_hook head;
+    forward_list_hook* tail;
+    size_type count;
+
+public:
+    /**
+     * Constructor
+     */
+    intrusive_forward_list() : tail(&head), count(0) {}
+
+    intrusive_forward_list(const intrusive_forward_list&) = delete;
+
+    intrusive_forward_list& operator=(const intrusive_forward_list&) = delete;
+
+    ~intrusive_forward_list() { clear(); }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return count; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    T& front() { return *begin(); }
+
+    void push_front(T& val) noexcept {
+        auto hook = &(val.*Hook);
+        hook->next = head.next;
+        head.next = hook;
+        if (tail == &head) tail = hook;
+        count ++ ;
+    }
+
+    void push_back(T& val) noexcept {
+        auto hook = &(val.*Hook);
+        hook->next = nullptr;
+        tail->next = hook;
+        tail = hook;
+        count ++ ;
+    }
+
+    void pop_front() noexcept {
+        assert(count);
+        auto hook = head.next;
+        head.next = hook->next;
+        hook->next = nullptr;
+        if (tail == hook) tail = &head;
+        count -- ;
+    }
+
+    void clear() noexcept {
+        while (count) pop_front();
+    }
+
+    // append all of rhs in O(1)
+    void splice_back(intrusive_forward_list& rhs) noexcept {
+        if (this == &rhs || rhs.empty()) return;
+        tail->next = rhs.head.next;
+        tail = rhs.tail;
+        count += rhs.count;
+        rhs.head.next = nullptr;
+        rhs.tail = &rhs.head;
+        rhs.count = 0;
+    }
+
+    /**
+     * Iterator
+     */
+    iterator begin() noexcept { return iterator(head.next); }
+
+    iterator end() noexcept { return iterator(nullptr); }
+
+    const_iterator begin() const noexcept { return const_iterator(head.next); }
+
+    const_iterator end() const noexcept { return const_iterator(nullptr); }
+};
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+namespace ministl
+{
+
+/**
+ * comparison function objects.
+ * the void specialization is transparent and deduces argument types
+ */
+template<typename T = void>
+struct less {
+    constexpr bool operator()(const T& lhs, const T& rhs) const {
+        return lhs < rhs;
+    }
+};
+
+template<>
+struct less<void> {
+    template<typename T, typename U>
+    constexpr bool operator()(const T& lhs, const U& rhs) const {
+        return lhs < rhs;
+    }
+};
+
+template<typename T = void>
+struct greater {
+    constexpr bool operator()(const T& lhs, const T& rhs) const {
+        return rhs < lhs;
+    }
+};
+
+template<>
+struct greater<void> {
+    template<typename T, typename U>
+    constexpr bool operator()(const T& lhs, const U& rhs) const {
+        return rhs < lhs;
+    }
+};
+
+/**
+ * arithmetic function objects, transparent when void
+ */
+template<typename T = void>
+struct plus {
+    constexpr T operator()(const T& lhs, const T& rhs) const {
+        return lhs + rhs;
+    }
+};
+
+template<>
+struct plus<void> {
+    template<typename T, typename U>
+    constexpr auto operator()(const T& lhs, const U& rhs) const {
+        return lhs + rhs;
+    }
+};
+
+template<typename T = void>
+struct multiplies {
+    constexpr T operator()(const T& lhs, const T& rhs) const {
+        return lhs * rhs;
+    }
+};
+
+template<>
+struct multiplies<void> {
+    template<typename T, typename U>
+    constexpr auto operator()(const T& lhs, const U& rhs) const {
+        return lhs * rhs;
+    }
+};
+
+/**
+ * hash function object. integers and pointers go through a 64 bit
+ * finalizer (splitmix64) so every output bit depends on every input bit;
+ * containers may take the low bits for a bucket and the high bits for a
+ * shard. other types use std::hash, followed by the same finalizer.
+ */
+inline uint64_t mix_hash(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+template<typename T>
+struct hash {
+    size_t operator()(const T& val) const noexcept(noexcept(std::hash<T> {}(val))) {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            return size_t(mix_hash(uint64_t(val)));
+        } else if constexpr (std::is_pointer_v<T>) {
+            return size_t(mix_hash(uint64_t(reinterpret_cast<uintptr_t>(val))));
+        } else {
+            return size_t(mix_hash(uint64_t(std::hash<T> {}(val))));
+        }
+    }
+};
+
+template<typename T = void>
+struct equal_to {
+    constexpr bool operator()(const T& lhs, const T& rhs) const {
+        return lhs == rhs;
+    }
+};
+
+template<>
+struct equal_to<void> {
+    template<typename T, typename U>
+    constexpr bool operator()(const T& lhs, const U& rhs) const {
+        return lhs == rhs;
+    }
+};
+
+}
@@ -0,0 +1,250 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/reverse_iterator.h>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace ministl
+{
+
+/**
+ * vector with a fixed capacity N and the storage inside the object, it
+ * never touches the heap.
+ *
+ * push_back / emplace_back / insert throw std::length_error when full,
+ * try_push_back / try_emplace_back return nullptr instead. when T is
+ * trivially copyable so is inplace_vector<T, N>: it can be memcpy'd into
+ * shared memory or a ring buffer and used on the other side.
+ */
+template<typename T, size_t N>
+class inplace_vector {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using pointer = T*;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    constexpr static bool trivial = std::is_trivially_copyable_v<T>;
+
+    size_type count;
+    alignas(T) unsigned char storage[N ? N * sizeof (T) : 1];
+
+    T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+
+    const T* ptr() const noexcept { return std::launder(reinterpret_cast<const T*>(storage)); }
+
+    void check_room(size_type n) const {
+        if (n > N) throw std::length_error("inplace_vector capacity exceeded");
+    }
+
+    template<typename Iter>
+    void construct_from(Iter first, Iter last) {
+        for (; first != last; ++ first) push_back(*first);
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    inplace_vector() noexcept : count(0) {}
+
+    explicit inplace_vector(size_type n) : count(0) {
+        check_room(n);
+        for (; count < n; count ++ ) ::new (ptr() + count) T();
+    }
+
+    inplace_vector(size_type n, const value_type& val) : count(0) {
+        check_room(n);
+        for (; count < n; count ++ ) ::new (ptr() + count) T(val);
+    }
+
+    inplace_vector(const std::initializer_list<value_type>& init) : count(0) {
+        check_room(init.size());
+        construct_from(init.begin(), init.end());
+    }
+
+    template<typename Iter, typename = std::enable_if_t<!std::is_integral_v<Iter>>>
+    inplace_vector(Iter first, Iter last) : count(0) {
+        construct_from(first, last);
+    }
+
+    inplace_vector(const inplace_vector&) requires trivial = default;
+
+    inplace_vector(const inplace_vector& rhs) : count(0) {
+        construct_from(rhs.begin(), rhs.end());
+    }
+
+    inplace_vector(inplace_vector&&) requires trivial = default;
+
+    inplace_vector(inplace_vector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) : count(0) {
+        for (; count < rhs.count; count ++ ) ::new (ptr() + count) T(std::move(rhs[count]));
+    }
+
+    inplace_vector& operator=(const inplace_vector&) requires trivial = default;
+
+    inplace_vector& operator=(const inplace_vector& rhs) {
+        if (this == &rhs) return *this;
+        clear();
+        construct_from(rhs.begin(), rhs.end());
+        return *this;
+    }
+
+    inplace_vector& operator=(inplace_vector&&) requires trivial = default;
+
+    inplace_vector& operator=(inplace_vector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this == &rhs) return *this;
+        clear();
+        for (; count < rhs.count; count ++ ) ::new (ptr() + count) T(std::move(rhs[count]));
+        return *this;
+    }
+
+    ~inplace_vector() requires trivial = default;
+
+    ~inplace_vector() { clear(); }
+
+    bool operator==(const inplace_vector& rhs) const {
+        return count == rhs.count && ministl::equal(begin(), end(), rhs.begin());
+    }
+
+    /**
+     * Operation
+     */
+    constexpr static size_type capacity() noexcept { return N; }
+
+    constexpr static size_type max_size() noexcept { return N; }
+
+    size_type size() const noexcept { return count; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    bool full() const noexcept { return count == N; }
+
+    template<typename... Args>
+    T* try_emplace_back(Args&&... args) {
+        if (count == N) return nullptr;
+        auto res = ::new (ptr() + count) T(std::forward<Args>(args)...);
+        count ++ ;
+        return res;
+    }
+
+    T* try_push_back(const value_type& val) { return try_emplace_back(val); }
+
+    T* try_push_back(value_type&& val) { return try_emplace_back(std::move(val)); }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        check_room(count + 1);
+        return *try_emplace_back(std::forward<Args>(args)...);
+    }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+
+    // construct at the end, then rotate into place
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        auto idx = pos - begin();
+        emplace_back(std::forward<Args>(args)...);
+        ministl::rotate(begin() + idx, end() - 1, end());
+        return begin() + idx;
+    }
+
+    iterator insert(const_iterator pos, const value_type& val) { return emplace(pos, val); }
+
+    iterator insert(const_iterator pos, value_type&& val) { return emplace(pos, std::move(val)); }
+
+    void pop_back() {
+        assert(count);
+        ptr()[ -- count].~T();
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        auto dst = begin() + (first - begin());
+        if (first == last) return dst;
+        auto new_end = ministl::move(dst + (last - first), end(), dst);
+        while (end() != new_end) pop_back();
+        return dst;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < count; i ++ ) ptr()[i].~T();
+        }
+        count = 0;
+    }
+
+    void resize(size_type n) {
+        check_room(n);
+        while (count > n) pop_back();
+        while (count < n) emplace_back();
+    }
+
+    void swap(inplace_vector& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        auto tmp = std::move(rhs);
+        rhs = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    reference operator[](size_type idx) { return ptr()[idx]; }
+
+    const_reference operator[](size_type idx) const { return ptr()[idx]; }
+
+    reference at(size_type idx) {
+        return const_cast<reference>(static_cast<const inplace_vector*>(this)->at(idx));
+    }
+
+    const_reference at(size_type idx) const {
+        if (idx >= count)
+            throw std::out_of_range("index outof bound");
+        return ptr()[idx];
+    }
+
+    reference front() { return ptr()[0]; }
+
+    const_reference front() const { return ptr()[0]; }
+
+    reference back() { return ptr()[count - 1]; }
+
+    const_reference back() const { return ptr()[count - 1]; }
+
+    T* data() noexcept { return ptr(); }
+
+    const T* data() const noexcept { return ptr(); }
+
+    /**
+     * Iterator
+     */
+    iterator begin() noexcept { return ptr(); }
+
+    iterator end() noexcept { return ptr() + count; }
+
+    const_iterator begin() const noexcept { return ptr(); }
+
+    const_iterator end() const noexcept { return ptr() + count; }
+
+    ministl::reverse_iterator<iterator> rbegin() noexcept { return ministl::reverse_iterator<iterator>(end()); }
+
+    ministl::reverse_iterator<iterator> rend() noexcept { return ministl::reverse_iterator<iterator>(begin()); }
+
+    ministl::reverse_iterator<const_iterator> rbegin() const noexcept {
+        return ministl::reverse_iterator<const_iterator>(end());
+    }
+
+    ministl::reverse_iterator<const_iterator> rend() const noexcept {
+        return ministl::reverse_iterator<const_iterator>(begin());
+    }
+};
+
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <cassert>
+#include <cstddef>
 #include <iterator>
 #include <ministl/type_traits.h>
 #include <type_traits>
@@ -15,6 +17,12 @@ struct forward_iterator_tag : public input_iterator_tag {};
 struct bidirectional_iterator_tag : public forward_iterator_tag {};
 struct random_access_iterator_tag : public bidirectional_iterator_tag {};
 
+/**
+ * elements sit at consecutive addresses. like std, this is reported as
+ * iterator_concept, iterator_category stays random access.
+ */
+struct contiguous_iterator_tag : public random_access_iterator_tag {};
+
 /**
  * iterator traits for non-pointer
  */
@@ -40,6 +48,7 @@ struct iterator_traits<Iter, __void_t<typename Iter::iterator_category,
 template<typename T>
 struct iterator_traits<T*> {
     using iterator_category = random_access_iterator_tag;
+    using iterator_concept = contiguous_iterator_tag;
     using value_type = T;
     using reference = T&;
     using pointer = T*;
@@ -49,6 +58,7 @@ struct iterator_traits<T*> {
 template<typename T>
 struct iterator_traits<const T*> {
     using iterator_category = random_access_iterator_tag;
+    using iterator_concept = contiguous_iterator_tag;
     using value_type = T;
     using reference = const T&;
     using pointer = const T*;
@@ -93,6 +103,47 @@ struct is_bidirectional_iterator : is_iterator_helper<Iter, bidirectional_iterat
 template<typename Iter>
 struct is_random_access_iterator : is_iterator_helper<Iter, random_access_iterator_tag> {};
 
+// pointers, and class iterators declaring a contiguous iterator_concept
+template<typename Iter, typename = ministl::__void_t<>>
+struct is_contiguous_iterator : ministl::false_type {};
+
+template<typename T>
+struct is_contiguous_iterator<T*> : ministl::true_type {};
+
+template<typename Iter>
+struct is_contiguous_iterator<Iter, ministl::__void_t<typename Iter::iterator_concept>> {
+    constexpr static bool value = std::is_convertible_v<typename Iter::iterator_concept, contiguous_iterator_tag>;
+};
+
+template<typename Iter>
+concept contiguous_iterator = is_contiguous_iterator<Iter>::value;
+
+/**
+ * raw address of the element a contiguous iterator refers to,
+ * it must be dereferenceable unless it is a pointer
+ */
+template<typename Iter>
+auto to_address(const Iter& iter) noexcept {
+    if constexpr (std::is_pointer_v<Iter>) {
+        return iter;
+    } else {
+        return iter.operator->();
+    }
+}
+
+/**
+ * the T whose member (named by ptr) is at *member, for intrusive hooks.
+ * the member offset is measured on a suitably aligned static buffer,
+ * never through a null pointer
+ */
+template<typename T, typename M>
+T* member_owner(M* member, M T::*ptr) noexcept {
+    alignas(T) static unsigned char probe[sizeof (T)];
+    auto base = reinterpret_cast<T*>(probe);
+    auto offset = reinterpret_cast<char*>(&(base->*ptr)) - reinterpret_cast<char*>(base);
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(member) - offset);
+}
+
 /**
  * some other ierator traits.
  * just for practice
@@ -127,7 +178,7 @@ void advance_dispatch(Iter& iter, DistanceType n, bidirectional_iterator_tag) {
     if (n > 0) {
         for (auto i = 0; i < n; i ++ ) ++ iter;
     } else {
-        for (auto i = 0; i > -n; i -- ) -- iter;
+        for (auto i = 0; i > n; i -- ) -- iter;
     }
 }
 
@@ -146,13 +197,11 @@ void advance(Iter& iter, DistanceType n) {
  * distance operation
  */
 
-// distance for input && forward && bidirectional iterator
+// distance for input && forward && bidirectional iterator, end must be reachable from begin
 template<typename Iter>
-decltype(auto) distance_dispatch(Iter begin, Iter end, bidirectional_iterator_tag) {
+decltype(auto) distance_dispatch(Iter begin, Iter end, input_iterator_tag) {
     typename ministl::iterator_traits<Iter>::difference_type ans = 0;
-    for (auto cur_begin = begin, cur_end = end;
-            cur_begin != end && cur_end != begin;
-            ++ cur_begin, ++ cur_end, ++ ans);
+    for (auto cur = begin; cur != end; ++ cur, ++ ans);
     return ans;
 }
 
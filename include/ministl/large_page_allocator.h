@@ -0,0 +1,196 @@
+#pragma once
+#include <ministl/allocator.h>
+#include <ministl/vector.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ministl
+{
+
+/**
+ * where the pages of a large buffer live on a NUMA machine.
+ * none:       kernel default, pages land on the node of the first thread touching them
+ * interleave: pages are spread round robin over all online nodes
+ * local:      pages are bound to the node of the allocating thread
+ */
+enum class numa_policy { none, interleave, local };
+
+namespace large_page_detail
+{
+
+constexpr size_t huge_page_size = size_t(2) << 20;
+
+// below this parallel first touch is not worth a thread spawn
+constexpr size_t parallel_touch_min_bytes = size_t(64) << 20;
+
+constexpr size_t max_numa_nodes = 1024;
+
+constexpr size_t round_up(size_t bytes, size_t align) {
+    return (bytes + align - 1) / align * align;
+}
+
+#ifdef __linux__
+// mempolicy modes from <linux/mempolicy.h>, we do not depend on libnuma
+constexpr int mpol_bind = 2;
+constexpr int mpol_interleave = 3;
+
+struct node_mask {
+    unsigned long bits[max_numa_nodes / (8 * sizeof (unsigned long))] = {};
+    int count = 0;
+
+    void set(size_t node) {
+        if (node >= max_numa_nodes) return;
+        bits[node / (8 * sizeof (unsigned long))] |= 1ul << (node % (8 * sizeof (unsigned long)));
+        count ++ ;
+    }
+};
+
+/**
+ * parse /sys/devices/system/node/online, e.g. "0-3,6"
+ */
+inline node_mask online_nodes() {
+    node_mask mask;
+    FILE* file = std::fopen("/sys/devices/system/node/online", "r");
+    if (!file) return mask;
+    unsigned lo, hi;
+    while (std::fscanf(file, "%u", &lo) == 1) {
+        hi = lo;
+        int ch = std::fgetc(file);
+        if (ch == '-') {
+            if (std::fscanf(file, "%u", &hi) != 1) break;
+            ch = std::fgetc(file);
+        }
+        for (auto node = lo; node <= hi; node ++ ) mask.set(node);
+        if (ch != ',') break;
+    }
+    std::fclose(file);
+    return mask;
+}
+
+/**
+ * best effort: a failing mbind only loses the placement, never the memory
+ */
+inline void apply_numa_policy(void* ptr, size_t bytes, numa_policy policy) {
+    if (policy == numa_policy::none) return;
+    node_mask mask;
+    int mode;
+    if (policy == numa_policy::interleave) {
+        mask = online_nodes();
+        if (mask.count <= 1) return;
+        mode = mpol_interleave;
+    } else {
+        unsigned cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return;
+        mask.set(node);
+        mode = mpol_bind;
+    }
+    syscall(SYS_mbind, ptr, bytes, mode, mask.bits, max_numa_nodes, 0);
+}
+
+/**
+ * map bytes (a multiple of huge_page_size) at a 2 MiB aligned address.
+ * explicit hugetlb pages are tried first when asked for, otherwise (or when
+ * the hugetlb pool is empty) an over-sized anonymous mapping is trimmed to
+ * alignment and flagged for transparent huge pages
+ */
+inline void* map_huge(size_t bytes, bool explicit_hugetlb) {
+    constexpr int prot = PROT_READ | PROT_WRITE;
+    constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+    if (explicit_hugetlb) {
+        void* ptr = mmap(nullptr, bytes, prot, flags | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) return ptr;
+    }
+#endif
+    void* raw = mmap(nullptr, bytes + huge_page_size, prot, flags, -1, 0);
+    if (raw == MAP_FAILED) throw std::bad_alloc();
+    auto raw_addr = reinterpret_cast<uintptr_t>(raw);
+    auto addr = round_up(raw_addr, huge_page_size);
+    if (addr > raw_addr) munmap(raw, addr - raw_addr);
+    auto tail = raw_addr + bytes + huge_page_size - (addr + bytes);
+    if (tail) munmap(reinterpret_cast<void*>(addr + bytes), tail);
+#ifdef MADV_HUGEPAGE
+    madvise(reinterpret_cast<void*>(addr), bytes, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<void*>(addr);
+}
+#endif
+
+}
+
+/**
+ * opt-in allocator for very large buffers, e.g.
+ *     ministl::vector<float, ministl::large_page_allocator<ministl::numa_policy::interleave>> v(n, 0.f);
+ *
+ * buffers of at least 2 MiB are mmapped at 2 MiB alignment and backed by huge
+ * pages (explicit hugetlb when ExplicitHugetlb and the pool has pages,
+ * transparent huge pages otherwise), with the NUMA policy applied before
+ * anything touches them. uninitialized_fill touches buffers of at least
+ * ParallelTouchMinBytes from all hardware threads so first-touch placement
+ * follows the threads that will scan them. smaller buffers and non-linux
+ * targets use default_allocator.
+ */
+template<numa_policy Numa = numa_policy::none, bool ExplicitHugetlb = false,
+         size_t ParallelTouchMinBytes = large_page_detail::parallel_touch_min_bytes>
+struct large_page_allocator {
+    static void* allocate(size_t bytes) {
+#ifdef __linux__
+        if (bytes >= large_page_detail::huge_page_size) {
+            auto mapped = large_page_detail::round_up(bytes, large_page_detail::huge_page_size);
+            void* ptr = large_page_detail::map_huge(mapped, ExplicitHugetlb);
+            large_page_detail::apply_numa_policy(ptr, mapped, Numa);
+            return ptr;
+        }
+#endif
+        return default_allocator::allocate(bytes);
+    }
+
+    static void deallocate(void* ptr, size_t bytes) noexcept {
+#ifdef __linux__
+        if (bytes >= large_page_detail::huge_page_size) {
+            munmap(ptr, large_page_detail::round_up(bytes, large_page_detail::huge_page_size));
+            return;
+        }
+#endif
+        default_allocator::deallocate(ptr, bytes);
+    }
+
+    template<typename T>
+    static void uninitialized_fill(T* first, size_t n, const T& val) {
+        uninitialized_fill(first, n, val, std::thread::hardware_concurrency());
+    }
+
+    // with an explicit number of touching threads
+    template<typename T>
+    static void uninitialized_fill(T* first, size_t n, const T& val, unsigned threads) {
+        if (threads <= 1 || n * sizeof (T) < ParallelTouchMinBytes) {
+            default_allocator::uninitialized_fill(first, n, val);
+            return;
+        }
+        // slices are whole huge pages, so no page is touched by two threads
+        size_t per_page = large_page_detail::huge_page_size / sizeof (T);
+        if (per_page == 0) per_page = 1;
+        size_t pages = (n + per_page - 1) / per_page;
+        ministl::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; t ++ ) {
+            size_t lo = pages * t / threads * per_page, hi = pages * (t + 1) / threads * per_page;
+            if (hi > n) hi = n;
+            if (lo >= hi) continue;
+            workers.emplace_back([=, &val] {
+                default_allocator::uninitialized_fill(first + lo, hi - lo, val);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+    }
+};
+
+}
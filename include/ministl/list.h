@@ -0,0 +1,513 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/iterator.h>
+#include <ministl/reverse_iterator.h>
+#include <ministl/node_pool.h>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+namespace ministl
+{
+
+/**
+ * links of a doubly linked, circular list. the list object owns one
+ * sentinel link, so begin() is sentinel.next and end() is the sentinel.
+ */
+struct list_hook {
+    list_hook* prev = nullptr;
+    list_hook* next = nullptr;
+
+    bool is_linked() const noexcept { return next != nullptr; }
+};
+
+namespace list_detail
+{
+
+// insert [first, last] (a linked chain) before pos
+inline void link_range_before(list_hook* pos, list_hook* first, list_hook* last) noexcept {
+    first->prev = pos->prev;
+    last->next = pos;
+    pos->prev->next = first;
+    pos->prev = last;
+}
+
+// detach [first, last] from its list
+inline void unlink_range(list_hook* first, list_hook* last) noexcept {
+    first->prev->next = last->next;
+    last->next->prev = first->prev;
+}
+
+// take over the chain of rhs_head into the empty lhs_head
+inline void steal_chain(list_hook& lhs_head, list_hook& rhs_head) noexcept {
+    if (rhs_head.next == &rhs_head) {
+        lhs_head.prev = lhs_head.next = &lhs_head;
+        return;
+    }
+    lhs_head.next = rhs_head.next;
+    lhs_head.prev = rhs_head.prev;
+    lhs_head.next->prev = lhs_head.prev->next = &lhs_head;
+    rhs_head.prev = rhs_head.next = &rhs_head;
+}
+
+/**
+ * bidirectional iterator over hooks, Project maps a hook to its element
+ */
+template<typename T, typename Project, bool Const>
+class hook_iterator {
+public:
+    using iterator_category = ministl::bidirectional_iterator_tag;
+    using value_type = T;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+    using difference_type = ptrdiff_t;
+
+private:
+    list_hook* cur;
+
+public:
+    hook_iterator() : cur(nullptr) {}
+
+    explicit hook_iterator(const list_hook* hook) : cur(const_cast<list_hook*>(hook)) {}
+
+    // iterator -> const_iterator
+    template<bool RhsConst, typename = std::enable_if_t<Const && !RhsConst>>
+    hook_iterator(const hook_iterator<T, Project, RhsConst>& rhs) : cur(rhs.hook()) {}
+
+    list_hook* hook() const noexcept { return cur; }
+
+    reference operator*() const { return *Project {}(cur); }
+
+    pointer operator->() const { return Project {}(cur); }
+
+    hook_iterator& operator++() {
+        cur = cur->next;
+        return *this;
+    }
+
+    hook_iterator operator++(int) {
+        auto res = *this;
+        cur = cur->next;
+        return res;
+    }
+
+    hook_iterator& operator--() {
+        cur = cur->prev;
+        return *this;
+    }
+
+    hook_iterator operator--(int) {
+        auto res = *this;
+        cur = cur->prev;
+        return res;
+    }
+
+    friend bool operator==(const hook_iterator& lhs, const hook_iterator& rhs) {
+        return lhs.cur == rhs.cur;
+    }
+
+    friend bool operator!=(const hook_iterator& lhs, const hook_iterator& rhs) {
+        return lhs.cur != rhs.cur;
+    }
+};
+
+}
+
+/**
+ * doubly linked list with O(1) size().
+ *
+ * nodes come from a slab pool (see node_pool.h) instead of malloc:
+ * Pool = container_pool gives every list its own slabs, Pool = thread_pool
+ * shares one pool per thread between all lists of the same element type.
+ */
+template<typename T, typename Pool = ministl::container_pool>
+class list {
+private:
+    struct node : list_hook {
+        T value;
+
+        template<typename... Args>
+        node(Args&&... args) : value(std::forward<Args>(args)...) {}
+    };
+
+    struct project {
+        T* operator()(list_hook* hook) const { return &static_cast<node*>(hook)->value; }
+    };
+
+    using pool_type = typename Pool::template pool<sizeof (node), alignof (node)>;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = list_detail::hook_iterator<T, project, false>;
+    using const_iterator = list_detail::hook_iterator<T, project, true>;
+
+private:
+    list_hook head;
+    size_type count;
+    pool_type pool;
+
+    template<typename... Args>
+    node* create_node(Args&&... args) {
+        void* raw = pool.allocate();
+        try {
+            return ::new (raw) node(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.deallocate(raw);
+            throw;
+        }
+    }
+
+    void destroy_node(list_hook* hook) noexcept {
+        auto ptr = static_cast<node*>(hook);
+        ptr->~node();
+        pool.deallocate(ptr);
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    list() : count(0) {
+        head.prev = head.next = &head;
+    }
+
+    list(size_type n, const value_type& val) : list() {
+        for (size_type i = 0; i < n; i ++ ) push_back(val);
+    }
+
+    list(const std::initializer_list<value_type>& init) : list() {
+        for (auto& val : init) push_back(val);
+    }
+
+    list(const list& rhs) : list() {
+        for (auto& val : rhs) push_back(val);
+    }
+
+    list(list&& rhs) noexcept : list() {
+        swap(rhs);
+    }
+
+    list& operator=(const list& rhs) {
+        if (this == &rhs) return *this;
+        auto tmp = rhs;
+        swap(tmp);
+        return *this;
+    }
+
+    list& operator=(list&& rhs) noexcept {
+        if (this == &rhs) return *this;
+        clear();
+        swap(rhs);
+        return *this;
+    }
+
+    ~list() { clear(); }
+
+    bool operator==(const list& rhs) const {
+        if (count != rhs.count) return false;
+        for (auto i = begin(), j = rhs.begin(); i != end(); ++ i, ++ j) {
+            if (!(*i == *j)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return count; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    reference front() { return *begin(); }
+
+    const_reference front() const { return *begin(); }
+
+    reference back() { return *(-- end()); }
+
+    const_reference back() const { return *(-- end()); }
+
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        node* ptr = create_node(std::forward<Args>(args)...);
+        list_detail::link_range_before(pos.hook(), ptr, ptr);
+        count ++ ;
+        return iterator(ptr);
+    }
+
+    iterator insert(const_iterator pos, const value_type& val) { return emplace(pos, val); }
+
+    iterator insert(const_iterator pos, value_type&& val) { return emplace(pos, std::move(val)); }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) { emplace(end(), std::forward<Args>(args)...); }
+
+    template<typename... Args>
+    void emplace_front(Args&&... args) { emplace(begin(), std::forward<Args>(args)...); }
+
+    void push_back(const value_type& val) { emplace(end(), val); }
+
+    void push_back(value_type&& val) { emplace(end(), std::move(val)); }
+
+    void push_front(const value_type& val) { emplace(begin(), val); }
+
+    void push_front(value_type&& val) { emplace(begin(), std::move(val)); }
+
+    iterator erase(const_iterator pos) {
+        assert(pos != end());
+        auto hook = pos.hook(), next = hook->next;
+        list_detail::unlink_range(hook, hook);
+        destroy_node(hook);
+        count -- ;
+        return iterator(next);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) first = erase(first);
+        return iterator(last.hook());
+    }
+
+    void pop_back() { erase(-- end()); }
+
+    void pop_front() { erase(begin()); }
+
+    void clear() noexcept {
+        for (auto hook = head.next; hook != &head; ) {
+            auto next = hook->next;
+            destroy_node(hook);
+            hook = next;
+        }
+        head.prev = head.next = &head;
+        count = 0;
+    }
+
+    void swap(list& rhs) noexcept {
+        list_hook tmp;
+        list_detail::steal_chain(tmp, head);
+        list_detail::steal_chain(head, rhs.head);
+        list_detail::steal_chain(rhs.head, tmp);
+        ministl::swap(count, rhs.count);
+        pool.swap(rhs.pool);
+    }
+
+    /**
+     * splice: move elements of rhs before pos.
+     * nodes are always relinked, never copied, so iterators and references
+     * stay valid. with container_pool, a partial splice from another list
+     * makes this list keep rhs' slabs alive (see node_pool.h), which may
+     * allocate once per pair of lists; a whole list splice absorbs them.
+     */
+    void splice(const_iterator pos, list& rhs) {
+        if (this == &rhs || rhs.empty()) return;
+        pool.absorb(rhs.pool);
+        auto first = rhs.head.next, last = rhs.head.prev;
+        list_detail::unlink_range(first, last);
+        list_detail::link_range_before(pos.hook(), first, last);
+        count += rhs.count;
+        rhs.count = 0;
+    }
+
+    void splice(const_iterator pos, list&& rhs) { splice(pos, rhs); }
+
+    void splice(const_iterator pos, list& rhs, const_iterator it) {
+        auto next = it;
+        ++ next;
+        // already in place; relinking a node before itself would corrupt the list
+        if (pos == it || pos == next) return;
+        splice(pos, rhs, it, next);
+    }
+
+    void splice(const_iterator pos, list& rhs, const_iterator first, const_iterator last) {
+        if (first == last) return;
+        size_type n = 0;
+        if (this != &rhs) {
+            if (first == rhs.begin() && last == rhs.end()) {
+                splice(pos, rhs);
+                return;
+            }
+            pool.share(rhs.pool);
+            for (auto it = first; it != last; ++ it) n ++ ;
+        }
+        auto first_hook = first.hook(), last_hook = last.hook()->prev;
+        list_detail::unlink_range(first_hook, last_hook);
+        list_detail::link_range_before(pos.hook(), first_hook, last_hook);
+        count += n;
+        rhs.count -= n;
+    }
+
+    void reverse() noexcept {
+        auto hook = &head;
+        do {
+            ministl::swap(hook->prev, hook->next);
+            hook = hook->prev;
+        } while (hook != &head);
+    }
+
+    /**
+     * Iterator
+     */
+    iterator begin() noexcept { return iterator(head.next); }
+
+    iterator end() noexcept { return iterator(&head); }
+
+    const_iterator begin() const noexcept { return const_iterator(head.next); }
+
+    const_iterator end() const noexcept { return const_iterator(&head); }
+
+    ministl::reverse_iterator<iterator> rbegin() {
+        return reverse_iterator<iterator> (end());
+    }
+
+    ministl::reverse_iterator<iterator> rend() {
+        return reverse_iterator<iterator> (begin());
+    }
+
+    ministl::reverse_iterator<const_iterator> rbegin() const {
+        return reverse_iterator<const_iterator> (end());
+    }
+
+    ministl::reverse_iterator<const_iterator> rend() const {
+        return reverse_iterator<const_iterator> (begin());
+    }
+};
+
+/**
+ * intrusive doubly linked list: elements embed a list_hook member and the
+ * list only links them, it never allocates, copies or destroys elements.
+ *     struct job { ministl::list_hook hook; ... };
+ *     ministl::intrusive_list<job, &job::hook> jobs;
+ * an element can be in one list per hook, and must outlive its membership.
+ */
+template<typename T, list_hook T::*Hook>
+class intrusive_list {
+private:
+    struct project {
+        T* operator()(list_hook* hook) const {
+            // hook is the Hook member of some T, walk back to the T
+            return ministl::member_owner(hook, Hook);
+        }
+    };
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = list_detail::hook_iterator<T, project, false>;
+    using const_iterator = list_detail::hook_iterator<T, project, true>;
+
+private:
+    list_hook head;
+    size_type count;
+
+public:
+    /**
+     * Constructor
+     */
+    intrusive_list() : count(0) {
+        head.prev = head.next = &head;
+    }
+
+    intrusive_list(const intrusive_list&) = delete;
+
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    intrusive_list(intrusive_list&& rhs) noexcept : intrusive_list() {
+        swap(rhs);
+    }
+
+    ~intrusive_list() { clear(); }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return count; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    T& front() { return *begin(); }
+
+    T& back() { return *(-- end()); }
+
+    iterator insert(const_iterator pos, T& val) noexcept {
+        list_hook* hook = &(val.*Hook);
+        assert(!hook->is_linked());
+        list_detail::link_range_before(pos.hook(), hook, hook);
+        count ++ ;
+        return iterator(hook);
+    }
+
+    void push_back(T& val) noexcept { insert(end(), val); }
+
+    void push_front(T& val) noexcept { insert(begin(), val); }
+
+    iterator erase(const_iterator pos) noexcept {
+        auto hook = pos.hook(), next = hook->next;
+        list_detail::unlink_range(hook, hook);
+        hook->prev = hook->next = nullptr;
+        count -- ;
+        return iterator(next);
+    }
+
+    // O(1) removal of an element known to be in this list
+    void erase(T& val) noexcept { erase(iterator_to(val)); }
+
+    void pop_back() noexcept { erase(-- end()); }
+
+    void pop_front() noexcept { erase(begin()); }
+
+    void clear() noexcept {
+        while (count) pop_front();
+    }
+
+    iterator iterator_to(T& val) noexcept { return iterator(&(val.*Hook)); }
+
+    void swap(intrusive_list& rhs) noexcept {
+        list_hook tmp;
+        list_detail::steal_chain(tmp, head);
+        list_detail::steal_chain(head, rhs.head);
+        list_detail::steal_chain(rhs.head, tmp);
+        ministl::swap(count, rhs.count);
+    }
+
+    // move a single element (e.g. to the front of an LRU) in O(1)
+    void splice(const_iterator pos, intrusive_list& rhs, const_iterator it) noexcept {
+        auto hook = it.hook();
+        if (hook == pos.hook() || hook->next == pos.hook()) return;
+        list_detail::unlink_range(hook, hook);
+        list_detail::link_range_before(pos.hook(), hook, hook);
+        rhs.count -- ;
+        count ++ ;
+    }
+
+    void splice(const_iterator pos, intrusive_list& rhs) noexcept {
+        if (this == &rhs || rhs.empty()) return;
+        auto first = rhs.head.next, last = rhs.head.prev;
+        list_detail::unlink_range(first, last);
+        list_detail::link_range_before(pos.hook(), first, last);
+        count += rhs.count;
+        rhs.count = 0;
+    }
+
+    /**
+     * Iterator
+     */
+    iterator begin() noexcept { return iterator(head.next); }
+
+    iterator end() noexcept { return iterator(&head); }
+
+    const_iterator begin() const noexcept { return const_iterator(head.next); }
+
+    const_iterator end() const noexcept { return const_iterator(&head); }
+
+    ministl::reverse_iterator<iterator> rbegin() {
+        return reverse_iterator<iterator> (end());
+    }
+
+    ministl::reverse_iterator<iterator> rend() {
+        return reverse_iterator<iterator> (begin());
+    }
+};
+
+}
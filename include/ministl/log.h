@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ministl/log_backend.h>
 #include <iostream>
 #include <source_location>
 
@@ -8,23 +9,53 @@ static inline void print(const Ts&... args) {
     ((std::cout << args), ...);
 }
 
+/**
+ * compile time log level, calls below it compile to nothing.
+ * defaults to debug in DEBUG builds and info otherwise
+ */
+#ifndef MINISTL_LOG_LEVEL
 #ifdef DEBUG
-// https://stackoverflow.com/questions/14805192/c-variadic-template-function-parameter-with-default-value
-// https://stackoverflow.com/questions/40951697/what-are-template-deduction-guides-and-when-should-we-use-them
-template <typename... Ts>
-struct debug
-{
-    debug(Ts&&... args, 
-        const std::source_location& loc = std::source_location::current())
-    {
-        print(loc.function_name(), ":", loc.line());
-        print(" [", args..., "]\n");
-    }
-};
-
-template <typename... Ts>
-debug(Ts&&...args) -> debug<Ts...>;
+#define MINISTL_LOG_LEVEL debug
 #else
-template <typename... Ts>
-static inline void debug(Ts&&... args) {}
+#define MINISTL_LOG_LEVEL info
+#endif
 #endif
+
+namespace ministl
+{
+
+constexpr log_level min_log_level = log_level::MINISTL_LOG_LEVEL;
+
+}
+
+// https://stackoverflow.com/questions/14805192/c-variadic-template-function-parameter-with-default-value
+// https://stackoverflow.com/questions/40951697/what-are-template-deduction-guides-and-when-should-we-use-them
+//
+// log_info("x = ", x); records the call site and the raw arguments into the
+// async backend (see log_backend.h), formatting happens on its own thread.
+#define MINISTL_DEFINE_LOG_FRONTEND(name, level)                                        \
+template <typename... Ts>                                                               \
+struct name                                                                             \
+{                                                                                       \
+    name(Ts&&... args,                                                                  \
+        const std::source_location& loc = std::source_location::current())             \
+    {                                                                                   \
+        if constexpr (level >= ministl::min_log_level) {                                \
+            ministl::log_backend::instance().record(level, loc, args...);              \
+        }                                                                               \
+    }                                                                                   \
+};                                                                                      \
+                                                                                        \
+template <typename... Ts>                                                               \
+name(Ts&&...args) -> name<Ts...>;
+
+MINISTL_DEFINE_LOG_FRONTEND(log_trace, ministl::log_level::trace)
+MINISTL_DEFINE_LOG_FRONTEND(log_debug, ministl::log_level::debug)
+MINISTL_DEFINE_LOG_FRONTEND(log_info, ministl::log_level::info)
+MINISTL_DEFINE_LOG_FRONTEND(log_warn, ministl::log_level::warn)
+MINISTL_DEFINE_LOG_FRONTEND(log_error, ministl::log_level::error)
+
+// debug() is the historical name of log_debug()
+MINISTL_DEFINE_LOG_FRONTEND(debug, ministl::log_level::debug)
+
+#undef MINISTL_DEFINE_LOG_FRONTEND
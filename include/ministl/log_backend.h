@@ -0,0 +1,597 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace ministl
+{
+
+enum class log_level : uint8_t { trace, debug, info, warn, error, off };
+
+inline const char* log_level_name(log_level level) {
+    constexpr const char* names[] = {"trace", "debug", "info", "warn", "error", "off"};
+    return names[static_cast<int>(level)];
+}
+
+/**
+ * asynchronous logging backend.
+ *
+ * a log call only encodes its source_location and raw arguments into a
+ * per-thread lock free SPSC ring buffer. a background thread drains all
+ * rings, formats records to a text sink (std::cout by default) and/or
+ * appends them to a binary file that log_decoder reads offline.
+ *
+ * arguments are kept raw: integers, floating point, bool, char, pointers
+ * and strings (anything with data()/size() of chars, or a C string, which
+ * is copied since it may not outlive the call).
+ */
+namespace log_detail
+{
+
+enum class arg_tag : uint8_t { i64, u64, f64, boolean, ch, str, ptr };
+
+template<typename T>
+concept string_like = requires(const T& val) {
+    { val.data() } -> std::convertible_to<const char*>;
+    { val.size() } -> std::convertible_to<size_t>;
+};
+
+template<typename T>
+constexpr bool is_c_string_v = std::is_same_v<std::decay_t<T>, const char*> ||
+                               std::is_same_v<std::decay_t<T>, char*>;
+
+// a C string argument; a char array is never null, a pointer may be
+template<typename T>
+const char* c_string_of(const T& val) {
+    if constexpr (std::is_array_v<T>) return val;
+    else return val ? val : "";
+}
+
+/**
+ * bytes of val once encoded, with strings cut at max_string bytes
+ */
+template<typename T>
+size_t encoded_size(const T& val, size_t max_string) {
+    using type = std::decay_t<T>;
+    if constexpr (is_c_string_v<T>) {
+        return 1 + sizeof (uint32_t) + std::min(std::strlen(c_string_of(val)), max_string);
+    } else if constexpr (string_like<type>) {
+        return 1 + sizeof (uint32_t) + std::min(static_cast<size_t>(val.size()), max_string);
+    } else if constexpr (std::is_same_v<type, bool> || std::is_same_v<type, char>) {
+        return 2;
+    } else if constexpr (std::is_arithmetic_v<type> || std::is_pointer_v<type> || std::is_enum_v<type>) {
+        return 1 + 8;
+    } else {
+        static_assert(!sizeof (T), "unsupported log argument type");
+    }
+}
+
+inline char* put_raw(char* dst, const void* src, size_t n) {
+    std::memcpy(dst, src, n);
+    return dst + n;
+}
+
+inline char* put_str(char* dst, const char* str, uint32_t n) {
+    *dst ++ = static_cast<char>(arg_tag::str);
+    dst = put_raw(dst, &n, sizeof (n));
+    return put_raw(dst, str, n);
+}
+
+template<typename T>
+char* encode(char* dst, const T& val, size_t max_string) {
+    using type = std::decay_t<T>;
+    if constexpr (is_c_string_v<T>) {
+        auto str = c_string_of(val);
+        return put_str(dst, str, static_cast<uint32_t>(std::min(std::strlen(str), max_string)));
+    } else if constexpr (string_like<type>) {
+        return put_str(dst, val.data(), static_cast<uint32_t>(std::min(static_cast<size_t>(val.size()), max_string)));
+    } else if constexpr (std::is_same_v<type, bool>) {
+        *dst ++ = static_cast<char>(arg_tag::boolean);
+        *dst ++ = val;
+        return dst;
+    } else if constexpr (std::is_same_v<type, char>) {
+        *dst ++ = static_cast<char>(arg_tag::ch);
+        *dst ++ = val;
+        return dst;
+    } else if constexpr (std::is_floating_point_v<type>) {
+        double tmp = val;
+        *dst ++ = static_cast<char>(arg_tag::f64);
+        return put_raw(dst, &tmp, 8);
+    } else if constexpr (std::is_pointer_v<type>) {
+        auto tmp = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(val));
+        *dst ++ = static_cast<char>(arg_tag::ptr);
+        return put_raw(dst, &tmp, 8);
+    } else if constexpr (std::is_signed_v<type> || std::is_enum_v<type>) {
+        auto tmp = static_cast<int64_t>(val);
+        *dst ++ = static_cast<char>(arg_tag::i64);
+        return put_raw(dst, &tmp, 8);
+    } else {
+        auto tmp = static_cast<uint64_t>(val);
+        *dst ++ = static_cast<char>(arg_tag::u64);
+        return put_raw(dst, &tmp, 8);
+    }
+}
+
+/**
+ * decode the encoded arguments in [src, end) and print them back to back,
+ * the same way print() would have printed the original arguments
+ */
+inline const char* format_args(std::ostream& os, const char* src, const char* end, uint8_t nargs) {
+    for (uint8_t i = 0; i < nargs && src < end; i ++ ) {
+        auto tag = static_cast<arg_tag>(*src ++ );
+        switch (tag) {
+            case arg_tag::i64: {
+                int64_t val;
+                std::memcpy(&val, src, 8);
+                os << val;
+                src += 8;
+                break;
+            }
+            case arg_tag::u64: {
+                uint64_t val;
+                std::memcpy(&val, src, 8);
+                os << val;
+                src += 8;
+                break;
+            }
+            case arg_tag::f64: {
+                double val;
+                std::memcpy(&val, src, 8);
+                os << val;
+                src += 8;
+                break;
+            }
+            case arg_tag::ptr: {
+                uint64_t val;
+                std::memcpy(&val, src, 8);
+                os << reinterpret_cast<const void*>(static_cast<uintptr_t>(val));
+                src += 8;
+                break;
+            }
+            case arg_tag::boolean:
+                os << (*src ++ != 0);
+                break;
+            case arg_tag::ch:
+                os << *src ++ ;
+                break;
+            case arg_tag::str: {
+                uint32_t len;
+                std::memcpy(&len, src, sizeof (len));
+                src += sizeof (len);
+                os.write(src, len);
+                src += len;
+                break;
+            }
+        }
+    }
+    return src;
+}
+
+inline void format_record(std::ostream& os, log_level level, const char* function, uint32_t line,
+        const char* args, const char* args_end, uint8_t nargs) {
+    if (level != log_level::debug) os << "[" << log_level_name(level) << "] ";
+    os << function << ":" << line << " [";
+    format_args(os, args, args_end, nargs);
+    os << "]\n";
+}
+
+/**
+ * ring entry. size covers header + args, rounded up to 8.
+ * size == wrap_marker means the producer skipped to the start of the ring
+ */
+struct record_header {
+    uint32_t size;
+    log_level level;
+    uint8_t nargs;
+    uint32_t line;
+    uint32_t column;
+    const char* file;
+    const char* function;
+    int64_t timestamp_ns;
+};
+
+constexpr uint32_t wrap_marker = UINT32_MAX;
+
+/**
+ * single producer (the owning thread), single consumer (the backend thread)
+ */
+class ring_buffer {
+public:
+    constexpr static size_t capacity = size_t(1) << 20;
+    // a larger record could need more than the whole ring once it wraps
+    constexpr static size_t max_record = capacity / 4;
+
+private:
+    constexpr static size_t mask = capacity - 1;
+
+    alignas(64) std::atomic<uint64_t> head {0}; // written by producer
+    uint64_t cached_tail = 0;                   // producer's view of tail
+    alignas(64) std::atomic<uint64_t> tail {0}; // written by consumer
+    alignas(64) std::unique_ptr<char[]> data {new char[capacity]};
+
+public:
+    std::atomic<bool> retired {false};
+    uint32_t thread_id;
+
+    explicit ring_buffer(uint32_t thread_id) : thread_id(thread_id) {}
+
+    /**
+     * room for n <= max_record bytes, contiguous. waits (lossless) while the
+     * ring is full
+     */
+    char* reserve(size_t n, uint64_t& pos) {
+        pos = head.load(std::memory_order_relaxed);
+        size_t offset = pos & mask;
+        size_t skip = offset + n > capacity ? capacity - offset : 0;
+        while (pos + skip + n - cached_tail > capacity) [[unlikely]] {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (pos + skip + n - cached_tail > capacity) std::this_thread::yield();
+        }
+        if (skip) {
+            uint32_t marker = wrap_marker;
+            std::memcpy(data.get() + offset, &marker, sizeof (marker));
+            pos += skip;
+        }
+        return data.get() + (pos & mask);
+    }
+
+    void commit(uint64_t pos, size_t n) {
+        head.store(pos + n, std::memory_order_release);
+    }
+
+    /**
+     * consumer side: call fn(header, args, args_end) for every committed record
+     */
+    template<typename Fn>
+    size_t drain(Fn&& fn) {
+        auto cur = tail.load(std::memory_order_relaxed);
+        auto end = head.load(std::memory_order_acquire);
+        size_t count = 0;
+        while (cur < end) {
+            auto ptr = data.get() + (cur & mask);
+            uint32_t size;
+            std::memcpy(&size, ptr, sizeof (size));
+            if (size == wrap_marker) {
+                cur += capacity - (cur & mask);
+                continue;
+            }
+            record_header header;
+            std::memcpy(&header, ptr, sizeof (header));
+            fn(header, ptr + sizeof (header), ptr + size);
+            cur += size;
+            count ++ ;
+        }
+        tail.store(cur, std::memory_order_release);
+        return count;
+    }
+
+    uint64_t committed() const { return head.load(std::memory_order_acquire); }
+
+    uint64_t consumed() const { return tail.load(std::memory_order_acquire); }
+};
+
+/**
+ * binary log file layout (little endian, no padding):
+ *   magic "MSTLLOG1"
+ *   site:   'S' u32 id, u8 level, u32 line, u32 column, u16 len, file, u16 len, function
+ *   record: 'R' u32 site id, i64 timestamp_ns, u32 thread id, u8 nargs, u32 args size, args
+ * a site is written once, before the first record that refers to it.
+ */
+constexpr char file_magic[8] = {'M', 'S', 'T', 'L', 'L', 'O', 'G', '1'};
+
+}
+
+class log_backend {
+private:
+    struct site_key {
+        const char* file;
+        const char* function;
+        uint32_t line;
+        uint32_t column;
+
+        bool operator==(const site_key&) const = default;
+    };
+
+    struct site_hash {
+        size_t operator()(const site_key& key) const {
+            return std::hash<const void*> {}(key.file) ^ (std::hash<const void*> {}(key.function) << 1) ^
+                   (size_t(key.line) << 20) ^ key.column;
+        }
+    };
+
+    std::mutex rings_lock;
+    std::vector<std::shared_ptr<log_detail::ring_buffer>> rings;
+    uint32_t next_thread_id = 0;
+
+    // owned by the backend thread (and by drain_all under drain_lock)
+    std::mutex drain_lock;
+    std::ostream* text_sink = &std::cout;
+    std::FILE* binary_file = nullptr;
+    std::unordered_map<site_key, uint32_t, site_hash> sites;
+
+    std::atomic<bool> stopping {false};
+    std::thread worker;
+
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void write_binary(const log_detail::ring_buffer& ring, const log_detail::record_header& header,
+            const char* args, const char* args_end) {
+        site_key key {header.file, header.function, header.line, header.column};
+        auto [it, inserted] = sites.try_emplace(key, static_cast<uint32_t>(sites.size()));
+        auto site_id = it->second;
+        if (inserted) {
+            auto file_len = static_cast<uint16_t>(std::strlen(header.file));
+            auto function_len = static_cast<uint16_t>(std::strlen(header.function));
+            std::fputc('S', binary_file);
+            std::fwrite(&site_id, sizeof (site_id), 1, binary_file);
+            std::fwrite(&header.level, 1, 1, binary_file);
+            std::fwrite(&header.line, sizeof (header.line), 1, binary_file);
+            std::fwrite(&header.column, sizeof (header.column), 1, binary_file);
+            std::fwrite(&file_len, sizeof (file_len), 1, binary_file);
+            std::fwrite(header.file, 1, file_len, binary_file);
+            std::fwrite(&function_len, sizeof (function_len), 1, binary_file);
+            std::fwrite(header.function, 1, function_len, binary_file);
+        }
+        auto args_size = static_cast<uint32_t>(args_end - args);
+        std::fputc('R', binary_file);
+        std::fwrite(&site_id, sizeof (site_id), 1, binary_file);
+        std::fwrite(&header.timestamp_ns, sizeof (header.timestamp_ns), 1, binary_file);
+        std::fwrite(&ring.thread_id, sizeof (ring.thread_id), 1, binary_file);
+        std::fwrite(&header.nargs, 1, 1, binary_file);
+        std::fwrite(&args_size, sizeof (args_size), 1, binary_file);
+        std::fwrite(args, 1, args_size, binary_file);
+    }
+
+    size_t drain_all() {
+        std::lock_guard<std::mutex> guard(drain_lock);
+        std::vector<std::shared_ptr<log_detail::ring_buffer>> snapshot;
+        {
+            std::lock_guard<std::mutex> rings_guard(rings_lock);
+            snapshot = rings;
+        }
+        size_t count = 0;
+        for (auto& ring : snapshot) {
+            bool retired = ring->retired.load(std::memory_order_acquire);
+            count += ring->drain([&](const log_detail::record_header& header, const char* args, const char* end) {
+                if (text_sink) {
+                    log_detail::format_record(*text_sink, header.level, header.function, header.line,
+                            args, end, header.nargs);
+                }
+                if (binary_file) write_binary(*ring, header, args, end);
+            });
+            if (retired) {
+                std::lock_guard<std::mutex> rings_guard(rings_lock);
+                for (auto& slot : rings) {
+                    if (slot == ring) {
+                        slot = rings.back();
+                        rings.pop_back();
+                        break;
+                    }
+                }
+            }
+        }
+        if (count && text_sink) text_sink->flush();
+        return count;
+    }
+
+    void run() {
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (!drain_all()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        drain_all();
+    }
+
+    /**
+     * per thread ring, created on the first log call of the thread
+     */
+    struct thread_handle {
+        std::shared_ptr<log_detail::ring_buffer> ring;
+
+        ~thread_handle() {
+            if (ring) ring->retired.store(true, std::memory_order_release);
+        }
+    };
+
+    log_detail::ring_buffer& thread_ring() {
+        thread_local thread_handle handle;
+        if (!handle.ring) [[unlikely]] {
+            std::lock_guard<std::mutex> guard(rings_lock);
+            handle.ring = std::make_shared<log_detail::ring_buffer>(next_thread_id ++ );
+            rings.push_back(handle.ring);
+        }
+        return *handle.ring;
+    }
+
+public:
+    log_backend() : worker([this] { run(); }) {}
+
+    log_backend(const log_backend&) = delete;
+
+    log_backend& operator=(const log_backend&) = delete;
+
+    ~log_backend() {
+        stopping.store(true, std::memory_order_release);
+        worker.join();
+        if (binary_file) std::fclose(binary_file);
+    }
+
+    static log_backend& instance() {
+        static log_backend backend;
+        return backend;
+    }
+
+    /**
+     * hot path: encode and enqueue, no formatting, no locks. a record that
+     * would not fit in a ring has its string arguments cut short
+     */
+    template<typename... Ts>
+    void record(log_level level, const std::source_location& loc, const Ts&... args) {
+        using log_detail::ring_buffer;
+        auto& ring = thread_ring();
+        size_t max_string = SIZE_MAX;
+        size_t args_size = (size_t(0) + ... + log_detail::encoded_size(args, max_string));
+        size_t size = (sizeof (log_detail::record_header) + args_size + 7) & ~size_t(7);
+        if (size > ring_buffer::max_record) [[unlikely]] {
+            // every argument then takes at most max_string + 9 bytes
+            max_string = (ring_buffer::max_record - sizeof (log_detail::record_header)) / std::max(sizeof...(Ts), size_t(1)) - 9;
+            args_size = (size_t(0) + ... + log_detail::encoded_size(args, max_string));
+            size = (sizeof (log_detail::record_header) + args_size + 7) & ~size_t(7);
+        }
+        uint64_t pos;
+        char* dst = ring.reserve(size, pos);
+        log_detail::record_header header {static_cast<uint32_t>(size), level,
+            static_cast<uint8_t>(sizeof...(Ts)), loc.line(), loc.column(),
+            loc.file_name(), loc.function_name(), now_ns()};
+        std::memcpy(dst, &header, sizeof (header));
+        dst += sizeof (header);
+        ((dst = log_detail::encode(dst, args, max_string)), ...);
+        ring.commit(pos, size);
+    }
+
+    /**
+     * block until every record committed before the call has been written out
+     */
+    void flush() {
+        std::vector<std::pair<std::shared_ptr<log_detail::ring_buffer>, uint64_t>> targets;
+        {
+            std::lock_guard<std::mutex> guard(rings_lock);
+            for (auto& ring : rings) targets.emplace_back(ring, ring->committed());
+        }
+        drain_all();
+        for (auto& [ring, target] : targets) {
+            while (ring->consumed() < target) std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> guard(drain_lock);
+        if (binary_file) std::fflush(binary_file);
+        if (text_sink) text_sink->flush();
+    }
+
+    /**
+     * nullptr disables text output
+     */
+    void set_text_sink(std::ostream* sink) {
+        flush();
+        std::lock_guard<std::mutex> guard(drain_lock);
+        text_sink = sink;
+    }
+
+    /**
+     * start (or with nullptr stop) appending records to a binary log file
+     */
+    bool open_binary_file(const char* path) {
+        flush();
+        std::lock_guard<std::mutex> guard(drain_lock);
+        if (binary_file) std::fclose(binary_file);
+        binary_file = nullptr;
+        sites.clear();
+        if (!path) return true;
+        binary_file = std::fopen(path, "wb");
+        if (!binary_file) return false;
+        std::fwrite(log_detail::file_magic, 1, sizeof (log_detail::file_magic), binary_file);
+        return true;
+    }
+};
+
+/**
+ * offline reader of the binary log file, formats it like the text sink
+ * (with a timestamp and thread id in front)
+ */
+class log_decoder {
+private:
+    struct site {
+        log_level level;
+        uint32_t line;
+        uint32_t column;
+        std::string file;
+        std::string function;
+    };
+
+    std::FILE* file;
+    std::vector<site> sites;
+
+    bool read(void* dst, size_t n) {
+        return std::fread(dst, 1, n, file) == n;
+    }
+
+    bool read_string(std::string& str) {
+        uint16_t len;
+        if (!read(&len, sizeof (len))) return false;
+        str.resize(len);
+        return read(str.data(), len);
+    }
+
+public:
+    explicit log_decoder(const char* path) : file(std::fopen(path, "rb")) {
+        char magic[sizeof (log_detail::file_magic)];
+        if (file && (!read(magic, sizeof (magic)) ||
+                    std::memcmp(magic, log_detail::file_magic, sizeof (magic)) != 0)) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+
+    log_decoder(const log_decoder&) = delete;
+
+    log_decoder& operator=(const log_decoder&) = delete;
+
+    ~log_decoder() {
+        if (file) std::fclose(file);
+    }
+
+    bool good() const { return file != nullptr; }
+
+    /**
+     * decode every record to os, return the number of records
+     */
+    size_t decode(std::ostream& os) {
+        size_t count = 0;
+        int type;
+        while (file && (type = std::fgetc(file)) != EOF) {
+            if (type == 'S') {
+                uint32_t id;
+                site cur;
+                if (!read(&id, sizeof (id)) || !read(&cur.level, 1) || !read(&cur.line, sizeof (cur.line)) ||
+                        !read(&cur.column, sizeof (cur.column)) || !read_string(cur.file) ||
+                        !read_string(cur.function)) break;
+                if (sites.size() <= id) sites.resize(id + 1);
+                sites[id] = std::move(cur);
+            } else if (type == 'R') {
+                uint32_t id, thread_id, args_size;
+                int64_t timestamp;
+                uint8_t nargs;
+                if (!read(&id, sizeof (id)) || !read(&timestamp, sizeof (timestamp)) ||
+                        !read(&thread_id, sizeof (thread_id)) || !read(&nargs, 1) ||
+                        !read(&args_size, sizeof (args_size)) || id >= sites.size()) break;
+                std::string args(args_size, '\0');
+                if (!read(args.data(), args_size)) break;
+                auto& cur = sites[id];
+                os << timestamp << " T" << thread_id << " ";
+                log_detail::format_record(os, cur.level, cur.function.c_str(), cur.line,
+                        args.data(), args.data() + args.size(), nargs);
+                count ++ ;
+            } else {
+                break;
+            }
+        }
+        return count;
+    }
+};
+
+}
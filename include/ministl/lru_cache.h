@@ -0,0 +1,531 @@
+#pragma once
+#include <ministl/functional.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace ministl
+{
+
+/**
+ * which entry a full cache drops.
+ *
+ * - lru: the least recently used one. every hit moves the entry to the
+ *   front of the recency list.
+ * - sieve: a CLOCK-like sweep. entries are kept in insertion order and a
+ *   hit only sets the entry's visited bit. a hand walks from the oldest
+ *   entry towards the newest, clears visited bits and evicts the first
+ *   entry that was not visited. hits leave the list alone, so in a
+ *   sharded_cache they run under a shared lock.
+ */
+enum class cache_policy { lru, sieve };
+
+struct cache_stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t insertions = 0;
+    uint64_t evictions = 0;
+
+    double hit_ratio() const noexcept {
+        return hits + misses ? double(hits) / double(hits + misses) : 0;
+    }
+
+    cache_stats& operator+=(const cache_stats& rhs) noexcept {
+        hits += rhs.hits, misses += rhs.misses;
+        insertions += rhs.insertions, evictions += rhs.evictions;
+        return *this;
+    }
+};
+
+namespace cache_detail
+{
+
+constexpr uint32_t nil = ~uint32_t(0);
+
+inline size_t round_up_pow2(size_t n) {
+    size_t res = 1;
+    while (res < n) res <<= 1;
+    return res;
+}
+
+}
+
+template<typename Key, typename Value, cache_policy Policy, typename Hash, typename KeyEqual>
+class sharded_cache;
+
+/**
+ * cache of at most capacity entries, all memory allocated up front.
+ *
+ * entries live in one slot array and are found through an open
+ * addressing index of 32 bit slot numbers (linear probing, deletion by
+ * backward shift, no tombstones). the recency list is linked through
+ * slot numbers too, so an insert or an eviction never allocates.
+ *
+ * pointers returned by find stay valid until the next insert or erase.
+ */
+template<typename Key, typename Value, cache_policy Policy = cache_policy::lru,
+         typename Hash = ministl::hash<Key>, typename KeyEqual = ministl::equal_to<Key>>
+class bounded_cache {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+
+private:
+    friend class sharded_cache<Key, Value, Policy, Hash, KeyEqual>;
+
+    struct slot {
+        Key key;
+        Value value;
+        size_t hash;
+    };
+
+    struct link {
+        uint32_t prev;
+        uint32_t next;
+    };
+
+    slot* slots;
+    link* links; // capacity + 1, the last one is the list head
+    uint8_t* visited; // sieve only
+    uint32_t* index;
+    size_type index_mask;
+    uint32_t cap;
+    uint32_t count;
+    uint32_t free_head;
+    uint32_t hand; // sieve: next entry to look at, cap to start from the oldest
+    cache_stats counters;
+    Hash hasher;
+    KeyEqual key_equal;
+
+    // list, head side is the newest
+    void unlink(uint32_t s) noexcept {
+        links[links[s].prev].next = links[s].next;
+        links[links[s].next].prev = links[s].prev;
+    }
+
+    void push_front(uint32_t s) noexcept {
+        links[s].prev = cap;
+        links[s].next = links[cap].next;
+        links[links[cap].next].prev = s;
+        links[cap].next = s;
+    }
+
+    // bucket holding key, or the empty bucket that ends its probe sequence
+    size_type find_bucket(const Key& key, size_t hash) const {
+        for (auto i = hash & index_mask; ; i = (i + 1) & index_mask) {
+            auto s = index[i];
+            if (s == cache_detail::nil) return i;
+            if (slots[s].hash == hash && key_equal(slots[s].key, key)) return i;
+        }
+    }
+
+    // empty bucket i, shifting later entries of the run back into the hole
+    void unindex(size_type i) noexcept {
+        auto hole = i;
+        for (auto j = (i + 1) & index_mask; index[j] != cache_detail::nil; j = (j + 1) & index_mask) {
+            auto home = slots[index[j]].hash & index_mask;
+            if (((j - home) & index_mask) >= ((j - hole) & index_mask)) {
+                index[hole] = index[j];
+                hole = j;
+            }
+        }
+        index[hole] = cache_detail::nil;
+    }
+
+    void remove(uint32_t s) noexcept {
+        auto i = slots[s].hash & index_mask;
+        while (index[i] != s) i = (i + 1) & index_mask;
+        unindex(i);
+        if constexpr (Policy == cache_policy::sieve) {
+            if (hand == s) hand = links[s].prev;
+        }
+        unlink(s);
+        slots[s].~slot();
+        links[s].next = free_head;
+        free_head = s;
+        count -- ;
+    }
+
+    uint32_t victim() noexcept {
+        if constexpr (Policy == cache_policy::lru) {
+            return links[cap].prev;
+        } else {
+            auto s = hand == cap ? links[cap].prev : hand;
+            while (std::atomic_ref<uint8_t>(visited[s]).load(std::memory_order_relaxed)) {
+                std::atomic_ref<uint8_t>(visited[s]).store(0, std::memory_order_relaxed);
+                s = links[s].prev;
+                if (s == cap) s = links[cap].prev;
+            }
+            // remove() moves the hand on to the next older entry
+            hand = s;
+            return s;
+        }
+    }
+
+    void touch(uint32_t s) noexcept {
+        if constexpr (Policy == cache_policy::lru) {
+            if (links[cap].next != s) unlink(s), push_front(s);
+        } else {
+            // skip the store when already set, hot entries stay clean in other caches
+            std::atomic_ref<uint8_t> bit(visited[s]);
+            if (!bit.load(std::memory_order_relaxed)) bit.store(1, std::memory_order_relaxed);
+        }
+    }
+
+    Value* find_hashed(const Key& key, size_t hash) {
+        auto s = index[find_bucket(key, hash)];
+        if (s == cache_detail::nil) {
+            counters.misses ++ ;
+            return nullptr;
+        }
+        counters.hits ++ ;
+        touch(s);
+        return &slots[s].value;
+    }
+
+    // sieve: a hit only sets a visited bit, any number of these may run together
+    const Value* find_shared(const Key& key, size_t hash) const requires (Policy == cache_policy::sieve) {
+        auto s = index[find_bucket(key, hash)];
+        if (s == cache_detail::nil) return nullptr;
+        const_cast<bounded_cache*>(this)->touch(s);
+        return &slots[s].value;
+    }
+
+    template<typename K, typename V>
+    Value& assign_hashed(K&& key, V&& value, size_t hash) {
+        auto bucket = find_bucket(key, hash);
+        auto s = index[bucket];
+        if (s != cache_detail::nil) {
+            slots[s].value = std::forward<V>(value);
+            touch(s);
+            return slots[s].value;
+        }
+        if (count == cap) {
+            remove(victim());
+            counters.evictions ++ ;
+            // the backward shift may have moved the run
+            bucket = find_bucket(key, hash);
+        }
+        s = free_head;
+        ::new (&slots[s]) slot {Key(std::forward<K>(key)), Value(std::forward<V>(value)), hash};
+        free_head = links[s].next;
+        index[bucket] = s;
+        push_front(s);
+        if constexpr (Policy == cache_policy::sieve) visited[s] = 0;
+        count ++ ;
+        counters.insertions ++ ;
+        return slots[s].value;
+    }
+
+    bool erase_hashed(const Key& key, size_t hash) {
+        auto s = index[find_bucket(key, hash)];
+        if (s == cache_detail::nil) return false;
+        remove(s);
+        return true;
+    }
+
+public:
+    /**
+     * Constructor: capacity is fixed, between 1 and 2^32 - 2
+     */
+    explicit bounded_cache(size_type capacity) {
+        if (capacity == 0) throw std::invalid_argument("cache capacity must be positive");
+        if (capacity >= cache_detail::nil) throw std::length_error("cache capacity too large");
+        cap = uint32_t(capacity);
+        count = 0;
+        // index at most half full
+        auto index_size = cache_detail::round_up_pow2(capacity * 2);
+        index_mask = index_size - 1;
+        slots = static_cast<slot*>(::operator new(capacity * sizeof (slot), std::align_val_t(alignof (slot))));
+        links = new link[capacity + 1];
+        index = new uint32_t[index_size];
+        visited = Policy == cache_policy::sieve ? new uint8_t[capacity] : nullptr;
+        for (size_type i = 0; i < index_size; i ++ ) index[i] = cache_detail::nil;
+        for (uint32_t s = 0; s < cap; s ++ ) links[s].next = s + 1;
+        free_head = 0;
+        links[cap].prev = links[cap].next = cap;
+        hand = cap;
+    }
+
+    bounded_cache(const bounded_cache&) = delete;
+
+    bounded_cache& operator=(const bounded_cache&) = delete;
+
+    ~bounded_cache() {
+        clear();
+        ::operator delete(slots, std::align_val_t(alignof (slot)));
+        delete[] links;
+        delete[] index;
+        delete[] visited;
+    }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return count; }
+
+    size_type capacity() const noexcept { return cap; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    // the value of key, nullptr on a miss. a hit counts as a use of the entry
+    Value* find(const Key& key) { return find_hashed(key, hasher(key)); }
+
+    // copies the value into out on a hit
+    bool get(const Key& key, Value& out) {
+        auto val = find(key);
+        if (val) out = *val;
+        return val != nullptr;
+    }
+
+    // neither a use nor counted
+    const Value* peek(const Key& key) const {
+        auto s = index[find_bucket(key, hasher(key))];
+        return s == cache_detail::nil ? nullptr : &slots[s].value;
+    }
+
+    bool contains(const Key& key) const { return peek(key) != nullptr; }
+
+    // replaces the value of key or inserts it, evicting an entry when full
+    template<typename K, typename V>
+        requires std::is_same_v<std::remove_cvref_t<K>, Key>
+    Value& insert_or_assign(K&& key, V&& value) {
+        auto hash = hasher(key);
+        return assign_hashed(std::forward<K>(key), std::forward<V>(value), hash);
+    }
+
+    /**
+     * the cached value of key, or make() inserted as its value: the usual
+     * way to put the cache in front of a slow lookup
+     */
+    template<typename Fn>
+    Value& get_or_insert(const Key& key, Fn make) {
+        auto hash = hasher(key);
+        if (auto val = find_hashed(key, hash)) return *val;
+        return assign_hashed(key, make(), hash);
+    }
+
+    bool erase(const Key& key) { return erase_hashed(key, hasher(key)); }
+
+    void clear() noexcept {
+        while (count) remove(links[cap].next);
+        hand = cap;
+    }
+
+    /**
+     * fn(key, value) for every entry, newest first: by last use for lru,
+     * by insertion for sieve
+     */
+    template<typename Fn>
+    void for_each(Fn fn) const {
+        for (auto s = links[cap].next; s != cap; s = links[s].next) fn(slots[s].key, slots[s].value);
+    }
+
+    const cache_stats& stats() const noexcept { return counters; }
+
+    void reset_stats() noexcept { counters = cache_stats(); }
+};
+
+template<typename Key, typename Value, typename Hash = ministl::hash<Key>, typename KeyEqual = ministl::equal_to<Key>>
+using lru_cache = bounded_cache<Key, Value, cache_policy::lru, Hash, KeyEqual>;
+
+template<typename Key, typename Value, typename Hash = ministl::hash<Key>, typename KeyEqual = ministl::equal_to<Key>>
+using sieve_cache = bounded_cache<Key, Value, cache_policy::sieve, Hash, KeyEqual>;
+
+/**
+ * bounded_cache shared by many threads: keys are spread over independent
+ * shards by the high bits of their hash (the low bits index inside the
+ * shard), each a bounded_cache of capacity / shards entries behind its own
+ * lock. lru hits reorder the list and take the shard lock exclusively,
+ * sieve hits only set a visited bit and take it shared.
+ *
+ * values are returned by copy. get_or_insert calls make() without holding
+ * a lock, so two threads missing the same key may both call it; the later
+ * insert wins.
+ */
+template<typename Key, typename Value, cache_policy Policy = cache_policy::lru,
+         typename Hash = ministl::hash<Key>, typename KeyEqual = ministl::equal_to<Key>>
+class sharded_cache {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+
+private:
+    using cache_type = bounded_cache<Key, Value, Policy, Hash, KeyEqual>;
+    using lock_type = std::conditional_t<Policy == cache_policy::sieve, std::shared_mutex, std::mutex>;
+
+    struct alignas(64) shard {
+        mutable lock_type lock;
+        cache_type cache;
+        // hits and misses seen under the shared lock
+        std::atomic<uint64_t> shared_hits {0};
+        std::atomic<uint64_t> shared_misses {0};
+
+        explicit shard(size_type capacity) : cache(capacity) {}
+    };
+
+    shard* shards;
+    size_type shard_num;
+    unsigned shard_shift;
+    Hash hasher;
+
+    shard& shard_for(size_t hash) const noexcept {
+        return shards[shard_shift >= 64 ? 0 : hash >> shard_shift];
+    }
+
+    // fn(const Value&) on a hit, under the shard lock
+    template<typename Fn>
+    bool visit(const Key& key, size_t hash, Fn fn) const {
+        auto& s = shard_for(hash);
+        if constexpr (Policy == cache_policy::sieve) {
+            std::shared_lock<lock_type> guard(s.lock);
+            auto val = s.cache.find_shared(key, hash);
+            (val ? s.shared_hits : s.shared_misses).fetch_add(1, std::memory_order_relaxed);
+            if (val) fn(*val);
+            return val != nullptr;
+        } else {
+            std::lock_guard<lock_type> guard(s.lock);
+            auto val = s.cache.find_hashed(key, hash);
+            if (val) fn(*val);
+            return val != nullptr;
+        }
+    }
+
+public:
+    /**
+     * Constructor: shard_count 0 picks four shards per hardware thread,
+     * never more shards than entries. every shard holds capacity / shards
+     * entries, rounded up
+     */
+    explicit sharded_cache(size_type capacity, size_type shard_count = 0) {
+        if (capacity == 0) throw std::invalid_argument("cache capacity must be positive");
+        if (shard_count == 0) shard_count = 4 * (std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 4);
+        shard_num = cache_detail::round_up_pow2(shard_count);
+        while (shard_num > capacity) shard_num >>= 1;
+        shard_shift = 64;
+        for (auto n = shard_num; n > 1; n >>= 1) shard_shift -- ;
+        shards = static_cast<shard*>(::operator new(shard_num * sizeof (shard), std::align_val_t(alignof (shard))));
+        size_type i = 0;
+        try {
+            for (; i < shard_num; i ++ ) ::new (shards + i) shard((capacity + shard_num - 1) / shard_num);
+        } catch (...) {
+            while (i -- ) shards[i].~shard();
+            ::operator delete(shards, std::align_val_t(alignof (shard)));
+            throw;
+        }
+    }
+
+    sharded_cache(const sharded_cache&) = delete;
+
+    sharded_cache& operator=(const sharded_cache&) = delete;
+
+    ~sharded_cache() {
+        for (size_type i = 0; i < shard_num; i ++ ) shards[i].~shard();
+        ::operator delete(shards, std::align_val_t(alignof (shard)));
+    }
+
+    /**
+     * Operation
+     */
+    bool get(const Key& key, Value& out) const {
+        return visit(key, hasher(key), [&out](const Value& val) { out = val; });
+    }
+
+    bool contains(const Key& key) const {
+        auto hash = hasher(key);
+        auto& s = shard_for(hash);
+        if constexpr (Policy == cache_policy::sieve) {
+            std::shared_lock<lock_type> guard(s.lock);
+            return s.cache.peek(key) != nullptr;
+        } else {
+            std::lock_guard<lock_type> guard(s.lock);
+            return s.cache.peek(key) != nullptr;
+        }
+    }
+
+    void insert_or_assign(const Key& key, const Value& value) {
+        auto hash = hasher(key);
+        auto& s = shard_for(hash);
+        std::lock_guard<lock_type> guard(s.lock);
+        s.cache.assign_hashed(key, value, hash);
+    }
+
+    template<typename Fn>
+    Value get_or_insert(const Key& key, Fn make) {
+        auto hash = hasher(key);
+        std::optional<Value> cached;
+        if (visit(key, hash, [&cached](const Value& val) { cached.emplace(val); })) return std::move(*cached);
+        Value res = make();
+        auto& s = shard_for(hash);
+        std::lock_guard<lock_type> guard(s.lock);
+        s.cache.assign_hashed(key, res, hash);
+        return res;
+    }
+
+    bool erase(const Key& key) {
+        auto hash = hasher(key);
+        auto& s = shard_for(hash);
+        std::lock_guard<lock_type> guard(s.lock);
+        return s.cache.erase_hashed(key, hash);
+    }
+
+    void clear() {
+        for (size_type i = 0; i < shard_num; i ++ ) {
+            std::lock_guard<lock_type> guard(shards[i].lock);
+            shards[i].cache.clear();
+        }
+    }
+
+    // exact when no writer runs concurrently
+    size_type size() const {
+        size_type res = 0;
+        for (size_type i = 0; i < shard_num; i ++ ) {
+            std::lock_guard<lock_type> guard(shards[i].lock);
+            res += shards[i].cache.size();
+        }
+        return res;
+    }
+
+    size_type capacity() const noexcept { return shard_num * shards[0].cache.capacity(); }
+
+    size_type shard_count() const noexcept { return shard_num; }
+
+    // summed over the shards
+    cache_stats stats() const {
+        cache_stats res;
+        for (size_type i = 0; i < shard_num; i ++ ) {
+            std::lock_guard<lock_type> guard(shards[i].lock);
+            res += shards[i].cache.stats();
+            res.hits += shards[i].shared_hits.load(std::memory_order_relaxed);
+            res.misses += shards[i].shared_misses.load(std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+    void reset_stats() {
+        for (size_type i = 0; i < shard_num; i ++ ) {
+            std::lock_guard<lock_type> guard(shards[i].lock);
+            shards[i].cache.reset_stats();
+            shards[i].shared_hits.store(0, std::memory_order_relaxed);
+            shards[i].shared_misses.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+template<typename Key, typename Value, typename Hash = ministl::hash<Key>, typename KeyEqual = ministl::equal_to<Key>>
+using sharded_lru_cache = sharded_cache<Key, Value, cache_policy::lru, Hash, KeyEqual>;
+
+template<typename Key, typename Value, typename Hash = ministl::hash<Key>, typename KeyEqual = ministl::equal_to<Key>>
+using sharded_sieve_cache = sharded_cache<Key, Value, cache_policy::sieve, Hash, KeyEqual>;
+
+}
@@ -0,0 +1,255 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace ministl
+{
+
+/**
+ * slab allocator for fixed size nodes.
+ *
+ * nodes are carved out of slabs that grow geometrically (16 nodes first, up
+ * to ~64 KiB per slab), so neighbouring nodes of a container sit next to each
+ * other in memory. freed nodes go to an intrusive free list and are reused
+ * before any new slab is carved. slabs are only returned when the pool dies.
+ */
+class node_pool {
+private:
+    struct free_node {
+        free_node* next;
+    };
+
+    struct slab {
+        slab* next;
+    };
+
+    constexpr static size_t first_slab_nodes = 16;
+    constexpr static size_t max_slab_bytes = 64 << 10;
+
+    size_t node_size;
+    size_t node_align;
+    size_t header_size;
+    size_t next_slab_nodes;
+    slab* slabs;
+    slab* last_slab;
+    free_node* free_list;
+    char* bump_cur;
+    char* bump_end;
+
+    static size_t round_up(size_t n, size_t align) {
+        return (n + align - 1) / align * align;
+    }
+
+    void add_slab() {
+        auto bytes = header_size + node_size * next_slab_nodes;
+        auto raw = static_cast<slab*>(::operator new(bytes, std::align_val_t(node_align)));
+        raw->next = nullptr;
+        if (last_slab) last_slab->next = raw;
+        else slabs = raw;
+        last_slab = raw;
+        bump_cur = reinterpret_cast<char*>(raw) + header_size;
+        bump_end = reinterpret_cast<char*>(raw) + bytes;
+        if (node_size * next_slab_nodes * 2 <= max_slab_bytes) next_slab_nodes *= 2;
+    }
+
+    void release() noexcept {
+        while (slabs) {
+            auto next = slabs->next;
+            ::operator delete(slabs, std::align_val_t(node_align));
+            slabs = next;
+        }
+        last_slab = nullptr;
+        free_list = nullptr;
+        bump_cur = bump_end = nullptr;
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    node_pool(size_t size, size_t align) :
+        node_size(round_up(size < sizeof (free_node) ? sizeof (free_node) : size,
+                    align < alignof (free_node) ? alignof (free_node) : align)),
+        node_align(align < alignof (free_node) ? alignof (free_node) : align),
+        header_size(round_up(sizeof (slab), node_align)),
+        next_slab_nodes(first_slab_nodes),
+        slabs(nullptr), last_slab(nullptr), free_list(nullptr),
+        bump_cur(nullptr), bump_end(nullptr) {}
+
+    node_pool(const node_pool&) = delete;
+
+    node_pool& operator=(const node_pool&) = delete;
+
+    node_pool(node_pool&& rhs) noexcept : node_pool(rhs.node_size, rhs.node_align) {
+        swap(rhs);
+    }
+
+    node_pool& operator=(node_pool&& rhs) noexcept {
+        if (this == &rhs) return *this;
+        release();
+        swap(rhs);
+        return *this;
+    }
+
+    ~node_pool() { release(); }
+
+    /**
+     * Operation
+     */
+    void* allocate() {
+        if (free_list) {
+            auto res = free_list;
+            free_list = free_list->next;
+            return res;
+        }
+        if (bump_cur == bump_end) [[unlikely]] add_slab();
+        auto res = bump_cur;
+        bump_cur += node_size;
+        return res;
+    }
+
+    void deallocate(void* ptr) noexcept {
+        auto node = static_cast<free_node*>(ptr);
+        node->next = free_list;
+        free_list = node;
+    }
+
+    /**
+     * take ownership of every slab of rhs in O(1), so nodes allocated from
+     * rhs stay valid for as long as this pool lives. the free space left in
+     * rhs is not reused. both pools must serve the same node size.
+     */
+    void absorb(node_pool& rhs) noexcept {
+        if (this == &rhs || !rhs.slabs) return;
+        // keep carving from our own newest slab, so append rhs' chain behind it
+        if (last_slab) last_slab->next = rhs.slabs;
+        else slabs = rhs.slabs;
+        // the appended chain may be followed by new slabs later
+        last_slab = rhs.last_slab;
+        rhs.slabs = rhs.last_slab = nullptr;
+        rhs.free_list = nullptr;
+        rhs.bump_cur = rhs.bump_end = nullptr;
+    }
+
+    void swap(node_pool& rhs) noexcept {
+        auto tmp_size = node_size, tmp_align = node_align, tmp_header = header_size,
+             tmp_next = next_slab_nodes;
+        auto tmp_slabs = slabs, tmp_last = last_slab;
+        auto tmp_free = free_list;
+        auto tmp_cur = bump_cur, tmp_end = bump_end;
+        node_size = rhs.node_size, node_align = rhs.node_align, header_size = rhs.header_size;
+        next_slab_nodes = rhs.next_slab_nodes;
+        slabs = rhs.slabs, last_slab = rhs.last_slab, free_list = rhs.free_list;
+        bump_cur = rhs.bump_cur, bump_end = rhs.bump_end;
+        rhs.node_size = tmp_size, rhs.node_align = tmp_align, rhs.header_size = tmp_header;
+        rhs.next_slab_nodes = tmp_next;
+        rhs.slabs = tmp_slabs, rhs.last_slab = tmp_last, rhs.free_list = tmp_free;
+        rhs.bump_cur = tmp_cur, rhs.bump_end = tmp_end;
+    }
+};
+
+/**
+ * node pool policies for node based containers.
+ *
+ * container_pool: every container allocates from its own slabs. when nodes
+ *   move to another container (splice), the receiver takes a reference on
+ *   the sender's slabs, so nodes relink in O(1) and the slabs are freed once
+ *   the last container holding nodes from them dies. a node freed by the
+ *   receiver goes to the receiver's free list, wherever it was carved.
+ * thread_pool: all containers of the same node type on a thread share one
+ *   pool, so nodes relink freely between them. such containers must only be
+ *   used on the thread that created them and must not outlive it.
+ */
+struct container_pool {
+    constexpr static bool shares_nodes = false;
+
+    template<size_t Size, size_t Align>
+    class pool {
+    private:
+        // created on first use, so an empty container allocates nothing
+        std::shared_ptr<node_pool> own;
+        // slabs of other containers that nodes of this one may live in
+        std::vector<std::shared_ptr<node_pool>> kept;
+
+        void keep(const std::shared_ptr<node_pool>& arena) {
+            if (!arena || arena == own) return;
+            for (auto& cur : kept) {
+                if (cur == arena) return;
+            }
+            kept.push_back(arena);
+        }
+
+    public:
+        void* allocate() {
+            if (!own) [[unlikely]] own = std::make_shared<node_pool>(Size, Align);
+            return own->allocate();
+        }
+
+        void deallocate(void* ptr) noexcept { own->deallocate(ptr); }
+
+        /**
+         * keep every slab nodes of rhs may live in alive for as long as this
+         * pool, so some of those nodes can be relinked into our container.
+         * may allocate, call it before relinking anything.
+         */
+        void share(pool& rhs) {
+            if (this == &rhs) return;
+            if (!own) own = std::make_shared<node_pool>(Size, Align);
+            kept.reserve(kept.size() + rhs.kept.size() + 1);
+            keep(rhs.own);
+            for (auto& arena : rhs.kept) keep(arena);
+        }
+
+        // all nodes of rhs move here, rhs starts over with fresh slabs
+        void absorb(pool& rhs) {
+            if (this == &rhs || !rhs.own) return;
+            if (!own) {
+                swap(rhs);
+                return;
+            }
+            kept.reserve(kept.size() + rhs.kept.size() + 1);
+            if (rhs.own.use_count() == 1) {
+                // no other container holds nodes of rhs, take its slabs over
+                own->absorb(*rhs.own);
+            } else {
+                keep(rhs.own);
+                rhs.own.reset();
+            }
+            for (auto& arena : rhs.kept) keep(arena);
+            rhs.kept.clear();
+        }
+
+        void swap(pool& rhs) noexcept {
+            own.swap(rhs.own);
+            kept.swap(rhs.kept);
+        }
+    };
+};
+
+template<size_t Size, size_t Align>
+node_pool& thread_node_pool() {
+    thread_local node_pool pool(Size, Align);
+    return pool;
+}
+
+struct thread_pool {
+    constexpr static bool shares_nodes = true;
+
+    template<size_t Size, size_t Align>
+    class pool {
+    public:
+        void* allocate() { return thread_node_pool<Size, Align>().allocate(); }
+
+        void deallocate(void* ptr) noexcept { thread_node_pool<Size, Align>().deallocate(ptr); }
+
+        void share(pool&) noexcept {}
+
+        void absorb(pool&) noexcept {}
+
+        void swap(pool&) noexcept {}
+    };
+};
+
+}
@@ -0,0 +1,627 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/functional.h>
+#include <ministl/iterator.h>
+#include <ministl/parallel_algorithm.h>
+#include <ministl/vector.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace ministl
+{
+
+/**
+ * floating point summation modes, passed as the first argument of reduce
+ * and transform_reduce. the default already keeps dozens of partial sums,
+ * far more accurate than one running sum; kahan carries a compensation
+ * term next to every partial sum (neumaier's variant), so the error no
+ * longer grows with n;
+ * pairwise halves the range down to blocks of pairwise_block elements,
+ * so it grows with log n at the cost of almost nothing.
+ */
+struct kahan_t {
+    explicit kahan_t() = default;
+};
+
+struct pairwise_t {
+    explicit pairwise_t() = default;
+};
+
+inline constexpr kahan_t kahan {};
+inline constexpr pairwise_t pairwise {};
+
+// inclusive_scan and exclusive_scan split the work over threads from this size on
+constexpr ptrdiff_t parallel_scan_min_size = ptrdiff_t(1) << 20;
+
+namespace numeric_detail
+{
+
+constexpr size_t pairwise_block = 1024;
+
+/**
+ * element types with simd kernels. they are used when the range is
+ * contiguous, the accumulator has the element type and the operations
+ * are plus (and multiplies for dot products).
+ */
+template<typename T>
+constexpr bool is_simd_type_v = std::is_same_v<T, float> || std::is_same_v<T, double> ||
+    std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
+    std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>;
+
+template<typename Op, typename T>
+constexpr bool is_plus_v = std::is_same_v<Op, ministl::plus<>> || std::is_same_v<Op, ministl::plus<T>> ||
+    std::is_same_v<Op, std::plus<>> || std::is_same_v<Op, std::plus<T>>;
+
+template<typename Op, typename T>
+constexpr bool is_multiplies_v = std::is_same_v<Op, ministl::multiplies<>> ||
+    std::is_same_v<Op, ministl::multiplies<T>> ||
+    std::is_same_v<Op, std::multiplies<>> || std::is_same_v<Op, std::multiplies<T>>;
+
+template<typename Iter, typename T>
+constexpr bool is_simd_input_v = ministl::is_contiguous_iterator<Iter>::value && is_simd_type_v<T> &&
+    std::is_same_v<std::remove_cv_t<typename ministl::iterator_traits<Iter>::value_type>, T>;
+
+template<typename Iter, typename T>
+constexpr bool is_simd_output_v = ministl::is_contiguous_iterator<Iter>::value && is_simd_type_v<T> &&
+    std::is_same_v<typename ministl::iterator_traits<Iter>::pointer, T*>;
+
+/**
+ * kernel bodies, written with gcc vector extensions for a vector of Bytes.
+ * they are always inlined into the target specific entry points below,
+ * which compile them for sse2, avx2 or avx-512.
+ */
+
+// sum of a[i] (or a[i] * b[i]) with 4 independent vector accumulators
+template<typename T, size_t Bytes, bool Dot>
+[[gnu::always_inline]] inline T sum_body(const T* a, const T* b, size_t n) {
+    using vec [[gnu::vector_size(Bytes)]] = T;
+    constexpr size_t lanes = Bytes / sizeof (T);
+    vec acc[4] = {};
+    size_t i = 0;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+#pragma GCC unroll 4
+        for (size_t k = 0; k < 4; k ++ ) {
+            vec x;
+            std::memcpy(&x, a + i + k * lanes, Bytes);
+            if constexpr (Dot) {
+                vec y;
+                std::memcpy(&y, b + i + k * lanes, Bytes);
+                x *= y;
+            }
+            acc[k] += x;
+        }
+    }
+    for (; i + lanes <= n; i += lanes) {
+        vec x;
+        std::memcpy(&x, a + i, Bytes);
+        if constexpr (Dot) {
+            vec y;
+            std::memcpy(&y, b + i, Bytes);
+            x *= y;
+        }
+        acc[0] += x;
+    }
+    acc[0] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    T res = T();
+    for (size_t l = 0; l < lanes; l ++ ) res += acc[0][l];
+    for (; i < n; i ++ ) res += Dot ? a[i] * b[i] : a[i];
+    return res;
+}
+
+/**
+ * init plus the compensated sum of a[i] (or a[i] * b[i]), per lane.
+ * this is neumaier's variant of kahan: the rounding error is taken from
+ * whichever of sum and addend is smaller, so it also survives addends
+ * larger than the running sum, e.g. 1e16 + 1 - 1e16.
+ */
+template<typename T, size_t Bytes, bool Dot>
+[[gnu::always_inline]] inline T kahan_body(const T* a, const T* b, size_t n, T init) {
+    using vec [[gnu::vector_size(Bytes)]] = T;
+    constexpr size_t lanes = Bytes / sizeof (T);
+    vec sum[4] = {}, comp[4] = {};
+    size_t i = 0;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+#pragma GCC unroll 4
+        for (size_t k = 0; k < 4; k ++ ) {
+            vec x;
+            std::memcpy(&x, a + i + k * lanes, Bytes);
+            if constexpr (Dot) {
+                vec y;
+                std::memcpy(&y, b + i + k * lanes, Bytes);
+                x *= y;
+            }
+            vec t = sum[k] + x;
+            vec abs_sum = sum[k] < 0 ? -sum[k] : sum[k], abs_x = x < 0 ? -x : x;
+            auto sum_larger = abs_sum >= abs_x;
+            vec big = sum_larger ? sum[k] : x, small = sum_larger ? x : sum[k];
+            comp[k] += (big - t) + small;
+            sum[k] = t;
+        }
+    }
+    T s = init, c = T();
+    auto add = [&s, &c](T x) {
+        T t = s + x;
+        c += (s < 0 ? -s : s) >= (x < 0 ? -x : x) ? (s - t) + x : (x - t) + s;
+        s = t;
+    };
+    for (size_t k = 0; k < 4; k ++ ) {
+        for (size_t l = 0; l < lanes; l ++ ) add(sum[k][l]), add(comp[k][l]);
+    }
+    for (; i < n; i ++ ) add(Dot ? a[i] * b[i] : a[i]);
+    return s + c;
+}
+
+// res = x with lanes moved up by S, zeros shifted in
+template<size_t S, typename Vec, size_t... I>
+[[gnu::always_inline]] inline void shift_lanes(const Vec& x, Vec& res, std::index_sequence<I...>) {
+    constexpr size_t lanes = sizeof... (I);
+    Vec zero = {};
+    res = __builtin_shufflevector(zero, x, (I >= S ? lanes + I - S : 0)...);
+}
+
+// in register inclusive prefix sum, log2(lanes) shift and add steps
+template<typename Vec, size_t Lanes, size_t... Step>
+[[gnu::always_inline]] inline void prefix_lanes(Vec& x, std::index_sequence<Step...>) {
+    Vec shifted;
+    ((shift_lanes<size_t(1) << Step>(x, shifted, std::make_index_sequence<Lanes> {}), x += shifted), ...);
+}
+
+/**
+ * scan of a vector at a time: the prefix inside a vector does not depend
+ * on earlier elements, so only adding the carry is on the critical path.
+ * returns the carry after the last element.
+ */
+template<typename T, size_t Bytes, bool Inclusive>
+[[gnu::always_inline]] inline T scan_body(const T* in, T* out, size_t n, T carry) {
+    using vec [[gnu::vector_size(Bytes)]] = T;
+    constexpr size_t lanes = Bytes / sizeof (T);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        vec x;
+        std::memcpy(&x, in + i, Bytes);
+        prefix_lanes<vec, lanes>(x, std::make_index_sequence<__builtin_ctz(lanes)> {});
+        if constexpr (Inclusive) {
+            x += carry;
+            std::memcpy(out + i, &x, Bytes);
+            carry = x[lanes - 1];
+        } else {
+            vec excl;
+            shift_lanes<1>(x, excl, std::make_index_sequence<lanes> {});
+            excl += carry;
+            std::memcpy(out + i, &excl, Bytes);
+            carry += x[lanes - 1];
+        }
+    }
+    for (; i < n; i ++ ) {
+        T val = in[i];
+        if constexpr (Inclusive) {
+            out[i] = carry = carry + val;
+        } else {
+            out[i] = carry;
+            carry += val;
+        }
+    }
+    return carry;
+}
+
+#if defined(__x86_64__)
+
+// 2: avx-512, 1: avx2 with fma, 0: the sse2 baseline
+inline int simd_level() {
+    static const int res = __builtin_cpu_supports("avx512f") ? 2 :
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? 1 : 0;
+    return res;
+}
+
+template<typename T, bool Dot>
+__attribute__((target("avx512f")))
+T sum_avx512(const T* a, const T* b, size_t n) { return sum_body<T, 64, Dot>(a, b, n); }
+
+template<typename T, bool Dot>
+__attribute__((target("avx2,fma")))
+T sum_avx2(const T* a, const T* b, size_t n) { return sum_body<T, 32, Dot>(a, b, n); }
+
+template<typename T, bool Dot>
+__attribute__((target("avx512f")))
+T kahan_avx512(const T* a, const T* b, size_t n, T init) { return kahan_body<T, 64, Dot>(a, b, n, init); }
+
+template<typename T, bool Dot>
+__attribute__((target("avx2,fma")))
+T kahan_avx2(const T* a, const T* b, size_t n, T init) { return kahan_body<T, 32, Dot>(a, b, n, init); }
+
+template<typename T, bool Inclusive>
+__attribute__((target("avx512f")))
+T scan_avx512(const T* in, T* out, size_t n, T carry) { return scan_body<T, 64, Inclusive>(in, out, n, carry); }
+
+template<typename T, bool Inclusive>
+__attribute__((target("avx2")))
+T scan_avx2(const T* in, T* out, size_t n, T carry) { return scan_body<T, 32, Inclusive>(in, out, n, carry); }
+
+#endif
+
+template<typename T, bool Dot>
+T sum(const T* a, const T* b, size_t n) {
+#if defined(__x86_64__)
+    if (simd_level() == 2) return sum_avx512<T, Dot>(a, b, n);
+    if (simd_level() == 1) return sum_avx2<T, Dot>(a, b, n);
+#endif
+    return sum_body<T, 16, Dot>(a, b, n);
+}
+
+template<typename T, bool Dot>
+T kahan_sum(const T* a, const T* b, size_t n, T init) {
+#if defined(__x86_64__)
+    if (simd_level() == 2) return kahan_avx512<T, Dot>(a, b, n, init);
+    if (simd_level() == 1) return kahan_avx2<T, Dot>(a, b, n, init);
+#endif
+    return kahan_body<T, 16, Dot>(a, b, n, init);
+}
+
+template<typename T, bool Dot>
+T pairwise_sum(const T* a, const T* b, size_t n) {
+    if (n <= pairwise_block) return sum<T, Dot>(a, b, n);
+    auto half = n / 2;
+    return pairwise_sum<T, Dot>(a, b, half) + pairwise_sum<T, Dot>(a + half, Dot ? b + half : b, n - half);
+}
+
+template<typename T, bool Inclusive>
+T scan(const T* in, T* out, size_t n, T carry) {
+#if defined(__x86_64__)
+    if (simd_level() == 2) return scan_avx512<T, Inclusive>(in, out, n, carry);
+    if (simd_level() >= 1) return scan_avx2<T, Inclusive>(in, out, n, carry);
+#endif
+    return scan_body<T, 16, Inclusive>(in, out, n, carry);
+}
+
+/**
+ * generic reduction of fetch(0) ... fetch(n - 1) in four interleaved
+ * chains, so op latency overlaps. needs op associative and commutative.
+ */
+template<typename T, typename BinaryOp, typename Fetch>
+T reduce_chains(ptrdiff_t n, T init, BinaryOp& op, Fetch fetch) {
+    if (n < 8) {
+        for (ptrdiff_t i = 0; i < n; i ++ ) init = op(std::move(init), fetch(i));
+        return init;
+    }
+    T acc0 = op(std::move(init), fetch(0)), acc1 = fetch(1), acc2 = fetch(2), acc3 = fetch(3);
+    ptrdiff_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = op(std::move(acc0), fetch(i));
+        acc1 = op(std::move(acc1), fetch(i + 1));
+        acc2 = op(std::move(acc2), fetch(i + 2));
+        acc3 = op(std::move(acc3), fetch(i + 3));
+    }
+    for (; i < n; i ++ ) acc0 = op(std::move(acc0), fetch(i));
+    return op(op(std::move(acc0), std::move(acc1)), op(std::move(acc2), std::move(acc3)));
+}
+
+template<typename T, typename Fetch>
+T kahan_chain(ptrdiff_t n, T init, Fetch fetch) {
+    T s = init, c = T();
+    for (ptrdiff_t i = 0; i < n; i ++ ) {
+        T x = fetch(i);
+        T t = s + x;
+        c += (s < 0 ? -s : s) >= (x < 0 ? -x : x) ? (s - t) + x : (x - t) + s;
+        s = t;
+    }
+    return s + c;
+}
+
+template<typename T, typename Fetch>
+T pairwise_chain(ptrdiff_t lo, ptrdiff_t hi, Fetch& fetch) {
+    if (hi - lo <= ptrdiff_t(pairwise_block)) {
+        T res = T();
+        for (auto i = lo; i < hi; i ++ ) res += fetch(i);
+        return res;
+    }
+    auto mid = lo + (hi - lo) / 2;
+    return pairwise_chain<T>(lo, mid, fetch) + pairwise_chain<T>(mid, hi, fetch);
+}
+
+// sequential (or simd, for plus over simd types) scan, returns the end of out
+template<bool Inclusive, typename Iter, typename OutIter, typename T, typename BinaryOp>
+OutIter scan_range(Iter first, Iter last, OutIter out, T init, BinaryOp& op) {
+    if constexpr (is_simd_input_v<Iter, T> && is_simd_output_v<OutIter, T> && is_plus_v<BinaryOp, T>) {
+        auto n = last - first;
+        if (n == 0) return out;
+        numeric_detail::scan<T, Inclusive>(ministl::to_address(first), ministl::to_address(out), size_t(n), init);
+        return out + n;
+    } else {
+        for (; first != last; ++ first, ++ out) {
+            if constexpr (Inclusive) {
+                init = op(std::move(init), *first);
+                *out = init;
+            } else {
+                // read before writing, out may be first
+                T next = op(init, *first);
+                *out = std::move(init);
+                init = std::move(next);
+            }
+        }
+        return out;
+    }
+}
+
+/**
+ * two pass parallel scan: every thread but the last totals its chunk, the
+ * totals are scanned serially into per chunk carries, then every thread
+ * scans its chunk from its carry. chunks are combined in order, so op only
+ * has to be associative.
+ */
+template<bool Inclusive, typename Iter, typename OutIter, typename T, typename BinaryOp>
+OutIter parallel_scan(Iter first, Iter last, OutIter out, T init, BinaryOp& op, unsigned threads) {
+    ptrdiff_t n = last - first;
+    if (threads == 0) threads = default_thread_count();
+    if (threads <= 1 || n < parallel_min_size) return scan_range<Inclusive>(first, last, out, init, op);
+
+    ptrdiff_t chunk = (n + threads - 1) / threads;
+    ministl::vector<T> carry(threads, init);
+    parallel_for_each_index(threads, [&](unsigned t) {
+        ptrdiff_t lo = chunk * t, hi = lo + chunk < n ? lo + chunk : n;
+        if (t + 1 == threads || lo >= hi) return;
+        T total = *(first + lo);
+        if constexpr (is_simd_input_v<Iter, T> && is_plus_v<BinaryOp, T>) {
+            total += numeric_detail::sum<T, false>(ministl::to_address(first + lo) + 1, nullptr, size_t(hi - lo - 1));
+        } else {
+            for (auto i = lo + 1; i < hi; i ++ ) total = op(std::move(total), *(first + i));
+        }
+        // carry[t + 1] is only the chunk total until the serial pass below
+        carry[t + 1] = std::move(total);
+    });
+    for (unsigned t = 1; t < threads; t ++ ) {
+        if (chunk * (t - 1) < n) carry[t] = op(carry[t - 1], carry[t]);
+    }
+    parallel_for_each_index(threads, [&](unsigned t) {
+        ptrdiff_t lo = chunk * t, hi = lo + chunk < n ? lo + chunk : n;
+        if (lo < hi) scan_range<Inclusive>(first + lo, first + hi, out + lo, carry[t], op);
+    });
+    return out + n;
+}
+
+}
+
+/**
+ * left fold in order, init = op(init, *it). integer sums come out the
+ * same in any order, so those take the simd reduce.
+ */
+template<typename Iter, typename T, typename BinaryOp>
+T accumulate(Iter first, Iter last, T init, BinaryOp op) {
+    if constexpr (numeric_detail::is_simd_input_v<Iter, T> && std::is_integral_v<T> &&
+                  numeric_detail::is_plus_v<BinaryOp, T>) {
+        if (first == last) return init;
+        return init + numeric_detail::sum<T, false>(ministl::to_address(first), nullptr, size_t(last - first));
+    } else {
+        for (; first != last; ++ first) init = op(std::move(init), *first);
+        return init;
+    }
+}
+
+template<typename Iter, typename T>
+T accumulate(Iter first, Iter last, T init) {
+    return ministl::accumulate(first, last, init, ministl::plus<> {});
+}
+
+/**
+ * like accumulate, but op must be associative and commutative and the
+ * order is unspecified: independent partial results keep the pipeline
+ * full, and contiguous float, double and 32/64 bit integer sums run on
+ * runtime selected avx-512, avx2 or sse2 kernels.
+ */
+template<typename Iter, typename T, typename BinaryOp>
+T reduce(Iter first, Iter last, T init, BinaryOp op) {
+    if constexpr (numeric_detail::is_simd_input_v<Iter, T> && numeric_detail::is_plus_v<BinaryOp, T>) {
+        if (first == last) return init;
+        return init + numeric_detail::sum<T, false>(ministl::to_address(first), nullptr, size_t(last - first));
+    } else if constexpr (contiguous_detail::is_reversed_v<Iter>) {
+        // order does not matter, walk the memory forwards
+        return ministl::reduce(last.base(), first.base(), init, op);
+    } else if constexpr (ministl::is_random_access_iterator<Iter>::value) {
+        return numeric_detail::reduce_chains(last - first, std::move(init), op,
+                [first](ptrdiff_t i) -> decltype(auto) { return *(first + i); });
+    } else {
+        for (; first != last; ++ first) init = op(std::move(init), *first);
+        return init;
+    }
+}
+
+template<typename Iter, typename T>
+T reduce(Iter first, Iter last, T init) {
+    return ministl::reduce(first, last, init, ministl::plus<> {});
+}
+
+template<typename Iter>
+typename ministl::iterator_traits<Iter>::value_type reduce(Iter first, Iter last) {
+    return ministl::reduce(first, last, typename ministl::iterator_traits<Iter>::value_type {});
+}
+
+// compensated sum of a random access floating point range
+template<typename Iter, typename T>
+T reduce(kahan_t, Iter first, Iter last, T init) {
+    static_assert(std::is_floating_point_v<T>, "kahan summation is for floating point");
+    if constexpr (numeric_detail::is_simd_input_v<Iter, T>) {
+        if (first == last) return init;
+        return numeric_detail::kahan_sum<T, false>(ministl::to_address(first), nullptr, size_t(last - first), init);
+    } else {
+        return numeric_detail::kahan_chain(last - first, init,
+                [first](ptrdiff_t i) -> decltype(auto) { return *(first + i); });
+    }
+}
+
+// pairwise sum of a random access floating point range
+template<typename Iter, typename T>
+T reduce(pairwise_t, Iter first, Iter last, T init) {
+    static_assert(std::is_floating_point_v<T>, "pairwise summation is for floating point");
+    if constexpr (numeric_detail::is_simd_input_v<Iter, T>) {
+        if (first == last) return init;
+        return init + numeric_detail::pairwise_sum<T, false>(ministl::to_address(first), nullptr, size_t(last - first));
+    } else {
+        auto fetch = [first](ptrdiff_t i) -> decltype(auto) { return *(first + i); };
+        return init + numeric_detail::pairwise_chain<T>(0, last - first, fetch);
+    }
+}
+
+/**
+ * reduce(op) over transform(*it1, *it2), order unspecified. with plus and
+ * multiplies over contiguous simd types this is a vectorized dot product.
+ */
+template<typename Iter1, typename Iter2, typename T, typename ReduceOp, typename TransformOp>
+T transform_reduce(Iter1 first1, Iter1 last1, Iter2 first2, T init, ReduceOp reduce_op, TransformOp transform_op) {
+    if constexpr (numeric_detail::is_simd_input_v<Iter1, T> && numeric_detail::is_simd_input_v<Iter2, T> &&
+                  numeric_detail::is_plus_v<ReduceOp, T> && numeric_detail::is_multiplies_v<TransformOp, T>) {
+        if (first1 == last1) return init;
+        return init + numeric_detail::sum<T, true>(ministl::to_address(first1), ministl::to_address(first2),
+                size_t(last1 - first1));
+    } else if constexpr (ministl::is_random_access_iterator<Iter1>::value &&
+                         ministl::is_random_access_iterator<Iter2>::value) {
+        return numeric_detail::reduce_chains(last1 - first1, std::move(init), reduce_op,
+                [&](ptrdiff_t i) { return transform_op(*(first1 + i), *(first2 + i)); });
+    } else {
+        for (; first1 != last1; ++ first1, ++ first2) init = reduce_op(std::move(init), transform_op(*first1, *first2));
+        return init;
+    }
+}
+
+template<typename Iter1, typename Iter2, typename T>
+T transform_reduce(Iter1 first1, Iter1 last1, Iter2 first2, T init) {
+    return ministl::transform_reduce(first1, last1, first2, init, ministl::plus<> {}, ministl::multiplies<> {});
+}
+
+// reduce(op) over transform(*it)
+template<typename Iter, typename T, typename ReduceOp, typename TransformOp>
+T transform_reduce(Iter first, Iter last, T init, ReduceOp reduce_op, TransformOp transform_op) {
+    if constexpr (ministl::is_random_access_iterator<Iter>::value) {
+        return numeric_detail::reduce_chains(last - first, std::move(init), reduce_op,
+                [&](ptrdiff_t i) { return transform_op(*(first + i)); });
+    } else {
+        for (; first != last; ++ first) init = reduce_op(std::move(init), transform_op(*first));
+        return init;
+    }
+}
+
+// compensated dot product of random access ranges
+template<typename Iter1, typename Iter2, typename T>
+T transform_reduce(kahan_t, Iter1 first1, Iter1 last1, Iter2 first2, T init) {
+    static_assert(std::is_floating_point_v<T>, "kahan summation is for floating point");
+    if constexpr (numeric_detail::is_simd_input_v<Iter1, T> && numeric_detail::is_simd_input_v<Iter2, T>) {
+        if (first1 == last1) return init;
+        return numeric_detail::kahan_sum<T, true>(ministl::to_address(first1), ministl::to_address(first2),
+                size_t(last1 - first1), init);
+    } else {
+        return numeric_detail::kahan_chain(last1 - first1, init,
+                [first1, first2](ptrdiff_t i) { return T(*(first1 + i)) * T(*(first2 + i)); });
+    }
+}
+
+// pairwise dot product of random access ranges
+template<typename Iter1, typename Iter2, typename T>
+T transform_reduce(pairwise_t, Iter1 first1, Iter1 last1, Iter2 first2, T init) {
+    static_assert(std::is_floating_point_v<T>, "pairwise summation is for floating point");
+    if constexpr (numeric_detail::is_simd_input_v<Iter1, T> && numeric_detail::is_simd_input_v<Iter2, T>) {
+        if (first1 == last1) return init;
+        return init + numeric_detail::pairwise_sum<T, true>(ministl::to_address(first1), ministl::to_address(first2),
+                size_t(last1 - first1));
+    } else {
+        auto fetch = [first1, first2](ptrdiff_t i) { return T(*(first1 + i)) * T(*(first2 + i)); };
+        return init + numeric_detail::pairwise_chain<T>(0, last1 - first1, fetch);
+    }
+}
+
+/**
+ * ordered like accumulate. integer dot products are exact in any order,
+ * so those take the simd kernel.
+ */
+template<typename Iter1, typename Iter2, typename T, typename BinaryOp1, typename BinaryOp2>
+T inner_product(Iter1 first1, Iter1 last1, Iter2 first2, T init, BinaryOp1 op1, BinaryOp2 op2) {
+    if constexpr (numeric_detail::is_simd_input_v<Iter1, T> && numeric_detail::is_simd_input_v<Iter2, T> &&
+                  std::is_integral_v<T> && numeric_detail::is_plus_v<BinaryOp1, T> &&
+                  numeric_detail::is_multiplies_v<BinaryOp2, T>) {
+        if (first1 == last1) return init;
+        return init + numeric_detail::sum<T, true>(ministl::to_address(first1), ministl::to_address(first2),
+                size_t(last1 - first1));
+    } else {
+        for (; first1 != last1; ++ first1, ++ first2) init = op1(std::move(init), op2(*first1, *first2));
+        return init;
+    }
+}
+
+template<typename Iter1, typename Iter2, typename T>
+T inner_product(Iter1 first1, Iter1 last1, Iter2 first2, T init) {
+    return ministl::inner_product(first1, last1, first2, init, ministl::plus<> {}, ministl::multiplies<> {});
+}
+
+/**
+ * parallel scans, op must be associative. threads = 0 picks
+ * default_thread_count(); small inputs run on the caller.
+ */
+template<typename Iter, typename OutIter, typename BinaryOp, typename T>
+OutIter parallel_inclusive_scan(Iter first, Iter last, OutIter out, BinaryOp op, T init, unsigned threads = 0) {
+    return numeric_detail::parallel_scan<true>(first, last, out, std::move(init), op, threads);
+}
+
+template<typename Iter, typename OutIter>
+OutIter parallel_inclusive_scan(Iter first, Iter last, OutIter out) {
+    using value_type = typename ministl::iterator_traits<Iter>::value_type;
+    return ministl::parallel_inclusive_scan(first, last, out, ministl::plus<> {}, value_type {});
+}
+
+template<typename Iter, typename OutIter, typename T, typename BinaryOp>
+OutIter parallel_exclusive_scan(Iter first, Iter last, OutIter out, T init, BinaryOp op, unsigned threads = 0) {
+    return numeric_detail::parallel_scan<false>(first, last, out, std::move(init), op, threads);
+}
+
+template<typename Iter, typename OutIter, typename T>
+OutIter parallel_exclusive_scan(Iter first, Iter last, OutIter out, T init) {
+    return ministl::parallel_exclusive_scan(first, last, out, std::move(init), ministl::plus<> {});
+}
+
+/**
+ * out[i] = init op in[0] op ... op in[i]. op must be associative; plus over
+ * contiguous simd types scans a vector at a time, and random access inputs
+ * of parallel_scan_min_size or more are split over threads. out may be first.
+ */
+template<typename Iter, typename OutIter, typename BinaryOp, typename T>
+OutIter inclusive_scan(Iter first, Iter last, OutIter out, BinaryOp op, T init) {
+    if constexpr (ministl::is_random_access_iterator<Iter>::value &&
+                  ministl::is_random_access_iterator<OutIter>::value) {
+        if (last - first >= parallel_scan_min_size) {
+            return numeric_detail::parallel_scan<true>(first, last, out, std::move(init), op, 0);
+        }
+    }
+    return numeric_detail::scan_range<true>(first, last, out, std::move(init), op);
+}
+
+template<typename Iter, typename OutIter, typename BinaryOp>
+OutIter inclusive_scan(Iter first, Iter last, OutIter out, BinaryOp op) {
+    if (first == last) return out;
+    typename ministl::iterator_traits<Iter>::value_type init = *first;
+    *out = init;
+    return ministl::inclusive_scan(++ first, last, ++ out, op, std::move(init));
+}
+
+template<typename Iter, typename OutIter>
+OutIter inclusive_scan(Iter first, Iter last, OutIter out) {
+    return ministl::inclusive_scan(first, last, out, ministl::plus<> {});
+}
+
+// out[i] = init op in[0] op ... op in[i - 1], otherwise as inclusive_scan
+template<typename Iter, typename OutIter, typename T, typename BinaryOp>
+OutIter exclusive_scan(Iter first, Iter last, OutIter out, T init, BinaryOp op) {
+    if constexpr (ministl::is_random_access_iterator<Iter>::value &&
+                  ministl::is_random_access_iterator<OutIter>::value) {
+        if (last - first >= parallel_scan_min_size) {
+            return numeric_detail::parallel_scan<false>(first, last, out, std::move(init), op, 0);
+        }
+    }
+    return numeric_detail::scan_range<false>(first, last, out, std::move(init), op);
+}
+
+template<typename Iter, typename OutIter, typename T>
+OutIter exclusive_scan(Iter first, Iter last, OutIter out, T init) {
+    return ministl::exclusive_scan(first, last, out, std::move(init), ministl::plus<> {});
+}
+
+}
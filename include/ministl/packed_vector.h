@@ -0,0 +1,543 @@
+#pragma once
+#include <ministl/vector.h>
+#include <ministl/inplace_vector.h>
+#include <ministl/iterator.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace ministl
+{
+
+namespace packed_detail
+{
+
+template<unsigned Bits>
+constexpr uint64_t low_mask = Bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << Bits) - 1;
+
+// slack words after the packed bits: wide unaligned loads may run past the last value
+constexpr size_t pad_words = 4;
+
+inline uint64_t load_u64(const uint64_t* words, size_t byte) noexcept {
+    uint64_t res;
+    std::memcpy(&res, reinterpret_cast<const unsigned char*>(words) + byte, sizeof (res));
+    return res;
+}
+
+/**
+ * value idx of width Bits. up to 56 bits one unaligned load covers the
+ * value whatever its bit offset, wider values may straddle two words
+ */
+template<unsigned Bits>
+inline uint64_t get(const uint64_t* words, size_t idx) noexcept {
+    auto bit = idx * Bits;
+    if constexpr (Bits == 0) {
+        return 0;
+    } else if constexpr (Bits <= 56) {
+        return load_u64(words, bit >> 3) >> (bit & 7) & low_mask<Bits>;
+    } else {
+        auto word = bit >> 6, offset = bit & 63;
+        auto res = words[word] >> offset;
+        if (offset + Bits > 64) res |= words[word + 1] << (64 - offset);
+        return res & low_mask<Bits>;
+    }
+}
+
+template<unsigned Bits>
+inline void set(uint64_t* words, size_t idx, uint64_t val) noexcept {
+    if constexpr (Bits == 0) return;
+    val &= low_mask<Bits>;
+    auto bit = idx * Bits;
+    auto word = bit >> 6, offset = bit & 63;
+    words[word] = (words[word] & ~(low_mask<Bits> << offset)) | (val << offset);
+    if (offset + Bits > 64) {
+        auto high = Bits - (64 - offset);
+        words[word + 1] = (words[word + 1] & ~((uint64_t(1) << high) - 1)) | (val >> (64 - offset));
+    }
+}
+
+#if defined(__x86_64__)
+
+inline bool has_avx2() {
+    static const bool res = __builtin_cpu_supports("avx2");
+    return res;
+}
+
+/**
+ * shuffle and shift constants for unpacking 8 values of Bits <= 25. a
+ * group of 8 values starts on a byte boundary; the low 128 bit lane is
+ * loaded at that byte, the high lane at the byte of value 4. each value's
+ * 4 byte window is gathered into its dword with pshufb, then shifted right
+ * by its bit offset inside the first byte and masked.
+ */
+template<unsigned Bits>
+struct unpack8_constants {
+    alignas(32) uint8_t shuffle[32];
+    alignas(32) uint32_t shift[8];
+
+    constexpr unpack8_constants() : shuffle(), shift() {
+        for (int lane = 0; lane < 2; lane ++ ) {
+            unsigned lane_bit = lane * 4 * Bits;
+            unsigned lane_byte = lane_bit / 8;
+            for (int k = 0; k < 4; k ++ ) {
+                unsigned bit = (lane * 4 + k) * Bits - lane_byte * 8;
+                for (int b = 0; b < 4; b ++ ) shuffle[lane * 16 + k * 4 + b] = uint8_t(bit / 8 + b);
+                shift[lane * 4 + k] = bit % 8;
+            }
+        }
+    }
+};
+
+template<unsigned Bits>
+inline constexpr unpack8_constants<Bits> unpack8 {};
+
+// groups of 8 values starting at group index first_group
+template<unsigned Bits>
+__attribute__((target("avx2")))
+void unpack_groups_avx2(const uint64_t* words, size_t first_group, size_t groups, uint32_t* out) {
+    auto bytes = reinterpret_cast<const unsigned char*>(words);
+    auto shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(unpack8<Bits>.shuffle));
+    auto shift = _mm256_load_si256(reinterpret_cast<const __m256i*>(unpack8<Bits>.shift));
+    auto mask = _mm256_set1_epi32(int(low_mask<Bits>));
+    auto src = bytes + first_group * Bits;
+    for (size_t g = 0; g < groups; g ++ , src += Bits, out += 8) {
+        auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * Bits / 8));
+        auto v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_and_si256(_mm256_srlv_epi32(_mm256_shuffle_epi8(v, shuffle), shift), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+    }
+}
+
+#endif
+
+}
+
+/**
+ * vector of unsigned integers stored in exactly Bits bits each (1..64).
+ * values are truncated to Bits on store. 20 bit values take 20 / 64 of
+ * the memory of a vector<uint64_t>.
+ *
+ * element access is one unaligned load plus shift and mask. unpack()
+ * decodes a run of values in bulk, with an AVX2 kernel (8 values per
+ * shuffle) for Bits <= 25 on cpus that have it.
+ */
+template<unsigned Bits>
+class packed_vector {
+    static_assert(Bits >= 1 && Bits <= 64, "packed_vector holds 1 to 64 bit values");
+
+public:
+    using value_type = uint64_t;
+    using size_type = size_t;
+    constexpr static unsigned bits = Bits;
+    constexpr static value_type max_value = packed_detail::low_mask<Bits>;
+
+private:
+    ministl::vector<uint64_t> words;
+    size_type count;
+
+    static size_type words_for(size_type n) {
+        return (n * Bits + 63) / 64 + packed_detail::pad_words;
+    }
+
+    void reserve_words(size_type n) {
+        while (words.size() < words_for(n)) words.push_back(0);
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    packed_vector() : count(0) { reserve_words(0); }
+
+    packed_vector(size_type n, value_type val) : packed_vector() {
+        reserve_words(n);
+        for (size_type i = 0; i < n; i ++ ) packed_detail::set<Bits>(words.begin(), i, val);
+        count = n;
+    }
+
+    packed_vector(const std::initializer_list<value_type>& init) : packed_vector() {
+        for (auto val : init) push_back(val);
+    }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return count; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    // bytes of packed storage
+    size_type memory_bytes() const noexcept { return words.size() * sizeof (uint64_t); }
+
+    value_type operator[](size_type idx) const { return packed_detail::get<Bits>(words.begin(), idx); }
+
+    value_type at(size_type idx) const {
+        if (idx >= count)
+            throw std::out_of_range("index outof bound");
+        return (*this)[idx];
+    }
+
+    void set(size_type idx, value_type val) { packed_detail::set<Bits>(words.begin(), idx, val); }
+
+    void push_back(value_type val) {
+        reserve_words(count + 1);
+        packed_detail::set<Bits>(words.begin(), count ++ , val);
+    }
+
+    void pop_back() {
+        assert(count);
+        packed_detail::set<Bits>(words.begin(), -- count, 0);
+    }
+
+    void clear() {
+        for (auto& word : words) word = 0;
+        count = 0;
+    }
+
+    /**
+     * decode values [first, first + n) into out
+     */
+    void unpack(size_type first, size_type n, uint64_t* out) const {
+        for (size_type i = 0; i < n; i ++ ) out[i] = (*this)[first + i];
+    }
+
+    void unpack(size_type first, size_type n, uint32_t* out) const requires (Bits <= 32) {
+        size_type i = 0;
+#if defined(__x86_64__)
+        if constexpr (Bits <= 25) {
+            if (n >= 16 && packed_detail::has_avx2()) {
+                // scalar up to a group boundary, then whole groups of 8
+                for (; (first + i) % 8; i ++ ) out[i] = uint32_t((*this)[first + i]);
+                auto groups = (n - i) / 8;
+                packed_detail::unpack_groups_avx2<Bits>(words.begin(), (first + i) / 8, groups, out + i);
+                i += groups * 8;
+            }
+        }
+#endif
+        for (; i < n; i ++ ) out[i] = uint32_t((*this)[first + i]);
+    }
+
+    bool operator==(const packed_vector& rhs) const {
+        if (count != rhs.count) return false;
+        for (size_type i = 0; i < count; i ++ ) {
+            if ((*this)[i] != rhs[i]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Iterator: yields values, not references
+     */
+    class const_iterator {
+    public:
+        using iterator_category = ministl::random_access_iterator_tag;
+        using value_type = uint64_t;
+        using pointer = void;
+        using reference = uint64_t;
+        using difference_type = ptrdiff_t;
+
+    private:
+        const uint64_t* words;
+        size_type idx;
+
+    public:
+        const_iterator() : words(nullptr), idx(0) {}
+
+        const_iterator(const uint64_t* words, size_type idx) : words(words), idx(idx) {}
+
+        reference operator*() const { return packed_detail::get<Bits>(words, idx); }
+
+        reference operator[](difference_type n) const { return packed_detail::get<Bits>(words, idx + n); }
+
+        const_iterator& operator++() { idx ++ ; return *this; }
+
+        const_iterator operator++(int) { auto res = *this; idx ++ ; return res; }
+
+        const_iterator& operator--() { idx -- ; return *this; }
+
+        const_iterator operator--(int) { auto res = *this; idx -- ; return res; }
+
+        const_iterator& operator+=(difference_type n) { idx += n; return *this; }
+
+        const_iterator& operator-=(difference_type n) { idx -= n; return *this; }
+
+        const_iterator operator+(difference_type n) const { return const_iterator(words, idx + n); }
+
+        const_iterator operator-(difference_type n) const { return const_iterator(words, idx - n); }
+
+        difference_type operator-(const const_iterator& rhs) const {
+            return difference_type(idx) - difference_type(rhs.idx);
+        }
+
+        bool operator==(const const_iterator& rhs) const { return idx == rhs.idx; }
+
+        bool operator!=(const const_iterator& rhs) const { return idx != rhs.idx; }
+
+        bool operator<(const const_iterator& rhs) const { return idx < rhs.idx; }
+    };
+
+    const_iterator begin() const noexcept { return const_iterator(words.begin(), 0); }
+
+    const_iterator end() const noexcept { return const_iterator(words.begin(), count); }
+};
+
+namespace packed_detail
+{
+
+constexpr size_t block_size = 128;
+
+// fixed width decoder of one block of deltas, chosen per block from a table
+using block_decoder = void (*)(const uint64_t*, uint64_t*);
+
+template<unsigned Bits>
+void decode_block(const uint64_t* words, uint64_t* out) {
+    for (size_t i = 0; i < block_size; i ++ ) out[i] = get<Bits>(words, i);
+}
+
+template<>
+inline void decode_block<0>(const uint64_t*, uint64_t* out) {
+    for (size_t i = 0; i < block_size; i ++ ) out[i] = 0;
+}
+
+template<size_t... Widths>
+constexpr auto make_decoders(std::index_sequence<Widths...>) {
+    struct table {
+        block_decoder fns[sizeof... (Widths)];
+    };
+    return table {{&decode_block<Widths>...}};
+}
+
+inline constexpr auto block_decoders = make_decoders(std::make_index_sequence<65>());
+
+inline unsigned bit_width(uint64_t val) noexcept { return val ? 64 - __builtin_clzll(val) : 0; }
+
+}
+
+/**
+ * compressed vector of non-decreasing uint64 values.
+ *
+ * values are cut into blocks of 128. a block keeps its first value in the
+ * skip index and the 128 deltas to the previous value bit packed at the
+ * width of its largest delta (2 words per bit of width), so dense sorted
+ * ids cost a few bits each. the last, unfinished block stays uncompressed.
+ *
+ * lower_bound binary searches the skip index and decodes one block;
+ * iteration decodes deltas in sequence; random access decodes a block
+ * prefix, up to 127 deltas.
+ */
+class packed_sorted_vector {
+public:
+    using value_type = uint64_t;
+    using size_type = size_t;
+    constexpr static size_type block_size = packed_detail::block_size;
+
+private:
+    struct block_header {
+        uint64_t first;
+        uint64_t offset;  // of the block's packed deltas in words
+        unsigned width;
+    };
+
+    ministl::vector<block_header> blocks;
+    ministl::vector<uint64_t> words;
+    ministl::inplace_vector<uint64_t, block_size> tail;
+
+    void seal_tail() {
+        uint64_t max_delta = 0;
+        for (size_type i = 1; i < block_size; i ++ ) {
+            auto delta = tail[i] - tail[i - 1];
+            if (delta > max_delta) max_delta = delta;
+        }
+        auto width = packed_detail::bit_width(max_delta);
+        // pad words of the previous block become the start of this one
+        auto offset = words.size() - packed_detail::pad_words;
+        auto needed = offset + 2 * width + packed_detail::pad_words;
+        while (words.size() < needed) words.push_back(0);
+        blocks.push_back({tail[0], offset, width});
+        auto base = words.begin() + offset;
+        for (size_type i = 1; i < block_size; i ++ ) {
+            auto delta = tail[i] - tail[i - 1];
+            if (width == 0) break;
+            auto bit = i * width, offset = bit & 63;
+            base[bit >> 6] |= delta << offset;
+            if (offset + width > 64) base[(bit >> 6) + 1] |= delta >> (64 - offset);
+        }
+        tail.clear();
+    }
+
+    // value at position pos of sealed block b
+    value_type block_value(size_type b, size_type pos) const {
+        auto& header = blocks[b];
+        auto base = words.begin() + header.offset;
+        auto val = header.first;
+        if (header.width == 0) return val;
+        auto mask = header.width >= 64 ? ~uint64_t(0) : (uint64_t(1) << header.width) - 1;
+        for (size_type i = 1; i <= pos; i ++ ) val += read_bits(base, i * header.width, header.width) & mask;
+        return val;
+    }
+
+    static uint64_t read_bits(const uint64_t* base, size_type bit, unsigned width) noexcept {
+        auto word = bit >> 6, offset = bit & 63;
+        auto res = base[word] >> offset;
+        if (offset + width > 64) res |= base[word + 1] << (64 - offset);
+        return res;
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    packed_sorted_vector() {
+        for (size_type i = 0; i < packed_detail::pad_words; i ++ ) words.push_back(0);
+    }
+
+    packed_sorted_vector(const std::initializer_list<value_type>& init) : packed_sorted_vector() {
+        for (auto val : init) push_back(val);
+    }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return blocks.size() * block_size + tail.size(); }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    size_type memory_bytes() const noexcept {
+        return words.size() * sizeof (uint64_t) + blocks.size() * sizeof (block_header) + sizeof (tail);
+    }
+
+    // values must come in non-decreasing order
+    void push_back(value_type val) {
+        assert(empty() || val >= back());
+        tail.push_back(val);
+        if (tail.size() == block_size) seal_tail();
+    }
+
+    value_type back() const {
+        return tail.empty() ? (*this)[size() - 1] : tail.back();
+    }
+
+    value_type operator[](size_type idx) const {
+        auto b = idx / block_size;
+        if (b == blocks.size()) return tail[idx % block_size];
+        return block_value(b, idx % block_size);
+    }
+
+    value_type at(size_type idx) const {
+        if (idx >= size())
+            throw std::out_of_range("index outof bound");
+        return (*this)[idx];
+    }
+
+    /**
+     * decode all 128 values of block b into out; the tail block yields tail.size() values
+     */
+    size_type decode_block(size_type b, uint64_t* out) const {
+        if (b == blocks.size()) {
+            for (size_type i = 0; i < tail.size(); i ++ ) out[i] = tail[i];
+            return tail.size();
+        }
+        auto& header = blocks[b];
+        packed_detail::block_decoders.fns[header.width](words.begin() + header.offset, out);
+        out[0] = header.first;
+        for (size_type i = 1; i < block_size; i ++ ) out[i] += out[i - 1];
+        return block_size;
+    }
+
+    size_type block_count() const noexcept { return blocks.size() + (tail.empty() ? 0 : 1); }
+
+    /**
+     * Iterator: forward, decodes one delta per step
+     */
+    class const_iterator {
+    public:
+        using iterator_category = ministl::forward_iterator_tag;
+        using value_type = uint64_t;
+        using pointer = const uint64_t*;
+        using reference = const uint64_t&;
+        using difference_type = ptrdiff_t;
+
+    private:
+        const packed_sorted_vector* vec;
+        size_type idx;
+        uint64_t cur;
+
+        void load() {
+            if (idx >= vec->size()) return;
+            auto b = idx / block_size;
+            cur = b == vec->blocks.size() ? vec->tail[idx % block_size] : vec->block_value(b, idx % block_size);
+        }
+
+    public:
+        const_iterator() : vec(nullptr), idx(0), cur(0) {}
+
+        const_iterator(const packed_sorted_vector* vec, size_type idx) : vec(vec), idx(idx), cur(0) { load(); }
+
+        size_type index() const noexcept { return idx; }
+
+        reference operator*() const { return cur; }
+
+        pointer operator->() const { return &cur; }
+
+        const_iterator& operator++() {
+            idx ++ ;
+            auto b = idx / block_size, pos = idx % block_size;
+            if (pos == 0 || b == vec->blocks.size()) {
+                load();
+            } else {
+                auto& header = vec->blocks[b];
+                if (header.width) {
+                    auto mask = header.width >= 64 ? ~uint64_t(0) : (uint64_t(1) << header.width) - 1;
+                    cur += read_bits(vec->words.begin() + header.offset, pos * header.width, header.width) & mask;
+                }
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto res = *this;
+            ++ *this;
+            return res;
+        }
+
+        bool operator==(const const_iterator& rhs) const { return idx == rhs.idx; }
+
+        bool operator!=(const const_iterator& rhs) const { return idx != rhs.idx; }
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    /**
+     * first position whose value is not less than val
+     */
+    const_iterator lower_bound(value_type val) const {
+        // last sealed block starting below val; the answer is in it or right after it
+        auto it = ministl::partition_point(blocks.begin(), blocks.end(),
+                [val](const block_header& header) { return header.first < val; });
+        size_type b = it - blocks.begin();
+        if (b == 0 && !blocks.empty()) return begin();
+        if (b -- == 0) {
+            auto tail_pos = ministl::lower_bound(tail.begin(), tail.end(), val) - tail.begin();
+            return const_iterator(this, tail_pos);
+        }
+        uint64_t decoded[block_size];
+        decode_block(b, decoded);
+        auto pos = ministl::lower_bound(decoded, decoded + block_size, val) - decoded;
+        if (pos < ptrdiff_t(block_size)) return const_iterator(this, b * block_size + pos);
+        if (b + 1 < blocks.size()) return const_iterator(this, (b + 1) * block_size);
+        auto tail_pos = ministl::lower_bound(tail.begin(), tail.end(), val) - tail.begin();
+        return const_iterator(this, blocks.size() * block_size + tail_pos);
+    }
+};
+
+}
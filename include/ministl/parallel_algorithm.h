@@ -0,0 +1,123 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/vector.h>
+#include <cstddef>
+#include <thread>
+
+namespace ministl
+{
+
+/**
+ * below this many elements threads cost more than they save
+ */
+constexpr ptrdiff_t parallel_min_size = ptrdiff_t(1) << 17;
+
+inline unsigned default_thread_count() {
+    auto n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+/**
+ * run fn(0) ... fn(n - 1), each on its own thread; fn(0) runs on the caller
+ */
+template<typename Fn>
+void parallel_for_each_index(unsigned n, Fn fn) {
+    ministl::vector<std::thread> workers;
+    for (unsigned i = 1; i < n; i ++ ) workers.emplace_back(fn, i);
+    fn(0u);
+    for (auto& t : workers) t.join();
+}
+
+/**
+ * merge path co-rank: how many elements of the first range are among the
+ * first diag elements of the stable merge of both ranges
+ */
+template<typename Iter1, typename Iter2, typename Compare>
+ptrdiff_t merge_path_split(Iter1 first1, ptrdiff_t len1, Iter2 first2, ptrdiff_t len2,
+        ptrdiff_t diag, Compare cmp) {
+    ptrdiff_t lo = diag > len2 ? diag - len2 : 0, hi = diag < len1 ? diag : len1;
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        // first1[mid] still belongs to the prefix if first2[diag - mid - 1] does not precede it
+        if (!cmp(*(first2 + (diag - mid - 1)), *(first1 + mid))) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * merge with the output split into equal slices along the merge path,
+ * so every thread merges an independent piece. same result as ministl::merge
+ */
+template<typename Iter1, typename Iter2, typename OutIter, typename Compare>
+OutIter parallel_merge(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out,
+        Compare cmp, unsigned threads = 0) {
+    ptrdiff_t len1 = last1 - first1, len2 = last2 - first2, total = len1 + len2;
+    if (threads == 0) threads = default_thread_count();
+    if (threads <= 1 || total < parallel_min_size) {
+        return ministl::merge(first1, last1, first2, last2, out, cmp);
+    }
+    parallel_for_each_index(threads, [&](unsigned t) {
+        ptrdiff_t diag_lo = total * t / threads, diag_hi = total * (t + 1) / threads;
+        auto i_lo = merge_path_split(first1, len1, first2, len2, diag_lo, cmp);
+        auto i_hi = merge_path_split(first1, len1, first2, len2, diag_hi, cmp);
+        ministl::merge(first1 + i_lo, first1 + i_hi,
+                first2 + (diag_lo - i_lo), first2 + (diag_hi - i_hi), out + diag_lo, cmp);
+    });
+    return out + total;
+}
+
+template<typename Iter1, typename Iter2, typename OutIter>
+OutIter parallel_merge(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter out) {
+    return ministl::parallel_merge(first1, last1, first2, last2, out, ministl::less<> {});
+}
+
+/**
+ * stable sort for very large ranges: each thread stable sorts one chunk,
+ * then chunks are merged pairwise with parallel_merge through a buffer of
+ * the full length. falls back to ministl::stable_sort for small inputs or
+ * when that buffer can not be allocated.
+ */
+template<typename Iter, typename Compare>
+void parallel_stable_sort(Iter first, Iter last, Compare cmp, unsigned threads = 0) {
+    ptrdiff_t n = last - first;
+    if (threads == 0) threads = default_thread_count();
+    if (threads <= 1 || n < parallel_min_size) {
+        ministl::stable_sort(first, last, cmp);
+        return;
+    }
+    using value_type = typename ministl::iterator_traits<Iter>::value_type;
+    temporary_buffer<value_type> buf(n, *first);
+    if (buf.size() < size_t(n)) {
+        ministl::stable_sort(first, last, buf.begin(), buf.size(), cmp);
+        return;
+    }
+    auto buffer = buf.begin();
+
+    // chunk t is [t * chunk, (t + 1) * chunk), its scratch is the same slice of buffer
+    ptrdiff_t chunk = (n + threads - 1) / threads;
+    parallel_for_each_index(threads, [&](unsigned t) {
+        ptrdiff_t lo = chunk * t, hi = lo + chunk < n ? lo + chunk : n;
+        if (lo < hi) ministl::stable_sort(first + lo, first + hi, buffer + lo, size_t(hi - lo), cmp);
+    });
+
+    for (ptrdiff_t width = chunk; width < n; width *= 2) {
+        for (ptrdiff_t lo = 0; lo + width < n; lo += 2 * width) {
+            ptrdiff_t mid = lo + width, hi = mid + width < n ? mid + width : n;
+            ministl::parallel_merge(first + lo, first + mid, first + mid, first + hi,
+                    buffer + lo, cmp, threads);
+            parallel_for_each_index(threads, [&](unsigned t) {
+                ptrdiff_t len = hi - lo;
+                ptrdiff_t from = lo + len * t / threads, to = lo + len * (t + 1) / threads;
+                ministl::move(buffer + from, buffer + to, first + from);
+            });
+        }
+    }
+}
+
+template<typename Iter>
+void parallel_stable_sort(Iter first, Iter last) {
+    ministl::parallel_stable_sort(first, last, ministl::less<> {});
+}
+
+}
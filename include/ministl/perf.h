@@ -0,0 +1,275 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ministl
+{
+
+/**
+ * hardware performance counters around a region of code.
+ *
+ * every counter is opened on its own, so a machine (or container, or VM)
+ * that lacks some of them still reports the rest; a counter that could not
+ * be opened reads as unavailable. wall time is always measured.
+ *
+ * counters follow the calling thread and the threads it creates after the
+ * counters are opened (perf inherit), so threaded code is counted in full
+ * as long as its workers are spawned inside the measured region and have
+ * exited when stop() reads. threads that already existed are not counted.
+ */
+enum perf_metric {
+    perf_cycles,
+    perf_instructions,
+    perf_cache_misses,
+    perf_branch_misses,
+    perf_dtlb_misses,
+    perf_metric_count
+};
+
+inline const char* perf_metric_name(int metric) {
+    constexpr const char* names[] = {"cycles", "instructions", "cache-misses", "branch-misses", "dtlb-misses"};
+    return names[metric];
+}
+
+struct perf_sample {
+    double values[perf_metric_count] = {};
+    bool valid[perf_metric_count] = {};
+    double nanoseconds = 0;
+};
+
+class perf_counters {
+private:
+    int fds[perf_metric_count];
+    std::chrono::steady_clock::time_point start_time;
+
+#ifdef __linux__
+    static int open_counter(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof (attr));
+        attr.size = sizeof (attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+public:
+    perf_counters() {
+        for (auto& fd : fds) fd = -1;
+#ifdef __linux__
+        fds[perf_cycles] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[perf_instructions] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[perf_cache_misses] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[perf_branch_misses] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds[perf_dtlb_misses] = open_counter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    ~perf_counters() {
+#ifdef __linux__
+        for (auto fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    bool available(int metric) const { return fds[metric] >= 0; }
+
+    bool any_available() const {
+        for (auto fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    void start() {
+#ifdef __linux__
+        for (auto fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    perf_sample stop() {
+        perf_sample res;
+        auto end_time = std::chrono::steady_clock::now();
+        res.nanoseconds = std::chrono::duration<double, std::nano>(end_time - start_time).count();
+#ifdef __linux__
+        for (int i = 0; i < perf_metric_count; i ++ ) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            // value, time enabled, time running; scale up when the pmu was multiplexed
+            uint64_t buf[3];
+            if (read(fds[i], buf, sizeof (buf)) != sizeof (buf) || buf[2] == 0) continue;
+            res.values[i] = double(buf[0]) * double(buf[1]) / double(buf[2]);
+            res.valid[i] = true;
+        }
+#endif
+        return res;
+    }
+};
+
+/**
+ * per operation rates of one measured region
+ */
+struct perf_report {
+    std::string name;
+    double ops = 1;
+    perf_sample sample;
+
+    double ns_per_op() const { return sample.nanoseconds / ops; }
+
+    bool has(int metric) const { return sample.valid[metric]; }
+
+    double per_op(int metric) const { return sample.values[metric] / ops; }
+
+    double ipc() const {
+        return has(perf_cycles) && has(perf_instructions) && sample.values[perf_cycles] > 0 ?
+            sample.values[perf_instructions] / sample.values[perf_cycles] : 0;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const perf_report& rhs) {
+        os << rhs.name << ": " << rhs.ns_per_op() << " ns/op";
+        for (int i = 0; i < perf_metric_count; i ++ ) {
+            if (rhs.has(i)) os << ", " << rhs.per_op(i) << " " << perf_metric_name(i) << "/op";
+        }
+        if (rhs.ipc() > 0) os << ", ipc " << rhs.ipc();
+        return os;
+    }
+};
+
+/**
+ * run fn once under the counters, ops is the number of operations it does
+ */
+template<typename Fn>
+perf_report measure(const std::string& name, double ops, Fn&& fn) {
+    perf_counters counters;
+    counters.start();
+    fn();
+    return {name, ops > 0 ? ops : 1, counters.stop()};
+}
+
+/**
+ * best of several runs (lowest ns/op), to damp scheduler and cache noise
+ */
+template<typename Fn>
+perf_report measure_best(const std::string& name, double ops, int runs, Fn&& fn) {
+    auto best = measure(name, ops, fn);
+    for (int i = 1; i < runs; i ++ ) {
+        auto cur = measure(name, ops, fn);
+        if (cur.ns_per_op() < best.ns_per_op()) best = cur;
+    }
+    return best;
+}
+
+/**
+ * stored per operation numbers of earlier runs, one "name metric value" per line.
+ * metric is ns or one of perf_metric_name(). comparisons only look at
+ * metrics present on both sides, so a baseline recorded with counters can
+ * be checked on a machine without them (wall time only) and vice versa.
+ */
+class perf_baseline {
+private:
+    struct entry {
+        std::string name;
+        std::string metric;
+        double value;
+    };
+
+    std::vector<entry> entries;
+
+    const entry* find(const std::string& name, const std::string& metric) const {
+        for (auto& cur : entries) {
+            if (cur.name == name && cur.metric == metric) return &cur;
+        }
+        return nullptr;
+    }
+
+    void set(const std::string& name, const std::string& metric, double value) {
+        for (auto& cur : entries) {
+            if (cur.name == name && cur.metric == metric) {
+                cur.value = value;
+                return;
+            }
+        }
+        entries.push_back({name, metric, value});
+    }
+
+public:
+    bool load(const char* path) {
+        std::FILE* file = std::fopen(path, "r");
+        if (!file) return false;
+        char name[256], metric[64];
+        double value;
+        while (std::fscanf(file, "%255s %63s %lf", name, metric, &value) == 3) set(name, metric, value);
+        std::fclose(file);
+        return true;
+    }
+
+    bool save(const char* path) const {
+        std::FILE* file = std::fopen(path, "w");
+        if (!file) return false;
+        for (auto& cur : entries) std::fprintf(file, "%s %s %.6g\n", cur.name.c_str(), cur.metric.c_str(), cur.value);
+        std::fclose(file);
+        return true;
+    }
+
+    size_t size() const { return entries.size(); }
+
+    void record(const perf_report& report) {
+        set(report.name, "ns", report.ns_per_op());
+        for (int i = 0; i < perf_metric_count; i ++ ) {
+            if (report.has(i)) set(report.name, perf_metric_name(i), report.per_op(i));
+        }
+    }
+
+    /**
+     * false when any shared metric grew by more than threshold (0.1 = 10%)
+     * over the baseline; each regression is described in os
+     */
+    bool check(const perf_report& report, double threshold, std::ostream& os) const {
+        bool ok = true;
+        auto check_one = [&](const char* metric, double value) {
+            auto base = find(report.name, metric);
+            if (!base || base->value <= 0) return;
+            auto ratio = value / base->value;
+            if (ratio > 1 + threshold) {
+                os << report.name << ": " << metric << "/op " << value << " vs baseline " << base->value
+                   << " (+" << (ratio - 1) * 100 << "%)\n";
+                ok = false;
+            }
+        };
+        check_one("ns", report.ns_per_op());
+        for (int i = 0; i < perf_metric_count; i ++ ) {
+            if (report.has(i)) check_one(perf_metric_name(i), report.per_op(i));
+        }
+        return ok;
+    }
+};
+
+}
@@ -0,0 +1,572 @@
+#pragma once
+#include <ministl/iterator.h>
+#include <ministl/algorithm.h>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace ministl
+{
+
+namespace persistent_detail
+{
+
+constexpr unsigned bits = 5;
+constexpr size_t width = size_t(1) << bits;
+constexpr size_t mask = width - 1;
+
+/**
+ * trie node, shared between versions and reference counted.
+ * a node reachable from more than one version is never modified.
+ */
+struct node {
+    std::atomic<uint32_t> refs {1};
+    bool is_leaf;
+
+    explicit node(bool is_leaf) : is_leaf(is_leaf) {}
+
+    void retain() noexcept { refs.fetch_add(1, std::memory_order_relaxed); }
+
+    bool unique() const noexcept { return refs.load(std::memory_order_acquire) == 1; }
+};
+
+struct branch : node {
+    node* children[width] = {};
+
+    branch() : node(false) {}
+};
+
+template<typename T>
+struct leaf : node {
+    uint32_t count = 0;
+    alignas(T) unsigned char storage[width * sizeof (T)];
+
+    leaf() : node(true) {}
+
+    T* values() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+
+    const T* values() const noexcept { return std::launder(reinterpret_cast<const T*>(storage)); }
+
+    ~leaf() {
+        for (uint32_t i = 0; i < count; i ++ ) values()[i].~T();
+    }
+};
+
+template<typename T>
+void release(node* ptr) noexcept {
+    if (!ptr) return;
+    if (ptr->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    if (ptr->is_leaf) {
+        delete static_cast<leaf<T>*>(ptr);
+    } else {
+        auto cur = static_cast<branch*>(ptr);
+        for (auto child : cur->children) release<T>(child);
+        delete cur;
+    }
+}
+
+// a fresh unshared copy; children are shared with the original
+inline branch* copy_branch(const branch* src) {
+    auto res = new branch();
+    if (!src) return res;
+    for (size_t i = 0; i < width; i ++ ) {
+        res->children[i] = src->children[i];
+        if (res->children[i]) res->children[i]->retain();
+    }
+    return res;
+}
+
+template<typename T>
+leaf<T>* copy_leaf(const leaf<T>* src, uint32_t count) {
+    auto res = new leaf<T>();
+    try {
+        for (; res->count < count; res->count ++ ) ::new (res->values() + res->count) T(src->values()[res->count]);
+    } catch (...) {
+        delete res;
+        throw;
+    }
+    return res;
+}
+
+}
+
+/**
+ * immutable vector with structural sharing, a 32-way trie plus a tail
+ * leaf (the layout of Clojure's PersistentVector).
+ *
+ * copying a version is O(1) and shares every node. set / push_back /
+ * pop_back leave the version alone and return a new one that copies only
+ * the O(log32 n) nodes on one root-to-leaf path. nodes are reference
+ * counted atomically, so versions can be handed to other threads and read
+ * there without locks. a single persistent_vector object is still a plain
+ * value: don't assign to it while another thread copies it.
+ *
+ * for bulk building use transient(): it mutates nodes it owns exclusively
+ * in place, then persistent() freezes the result.
+ */
+template<typename T>
+class persistent_vector {
+private:
+    using node = persistent_detail::node;
+    using branch = persistent_detail::branch;
+    using leaf = persistent_detail::leaf<T>;
+    constexpr static unsigned bits = persistent_detail::bits;
+    constexpr static size_t width = persistent_detail::width;
+    constexpr static size_t mask = persistent_detail::mask;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    class transient_vector;
+
+private:
+    size_type count;
+    unsigned shift;
+    branch* root; // nullptr while everything fits in the tail
+    leaf* tail;   // nullptr when empty
+
+    persistent_vector(size_type count, unsigned shift, branch* root, leaf* tail) :
+        count(count), shift(shift), root(root), tail(tail) {}
+
+    size_type tail_offset() const noexcept {
+        return count < width ? 0 : ((count - 1) >> bits) << bits;
+    }
+
+    const leaf* leaf_for(size_type idx) const noexcept {
+        if (idx >= tail_offset()) return tail;
+        const node* cur = root;
+        for (unsigned level = shift; level > 0; level -= bits) {
+            cur = static_cast<const branch*>(cur)->children[(idx >> level) & mask];
+        }
+        return static_cast<const leaf*>(cur);
+    }
+
+    // a chain of single-child branches from level down to leaf
+    static node* new_path(unsigned level, node* leaf_node) {
+        if (level == 0) return leaf_node;
+        auto res = new branch();
+        res->children[0] = new_path(level - bits, leaf_node);
+        return res;
+    }
+
+    /**
+     * path copy of parent with leaf_node hung at position size_before - 1.
+     * with InPlace parents that are not shared are modified directly
+     */
+    template<bool InPlace>
+    static branch* push_tail(size_type size_before, unsigned level, branch* parent, node* leaf_node) {
+        branch* res;
+        if (InPlace && parent && parent->unique()) {
+            res = parent;
+        } else {
+            res = persistent_detail::copy_branch(parent);
+            if (InPlace) persistent_detail::release<T>(parent);
+        }
+        auto sub = ((size_before - 1) >> level) & mask;
+        node* child = res->children[sub];
+        if (level == bits) {
+            res->children[sub] = leaf_node;
+        } else if (child) {
+            auto next = push_tail<InPlace>(size_before, level - bits, static_cast<branch*>(child), leaf_node);
+            if (!InPlace) persistent_detail::release<T>(child);
+            res->children[sub] = next;
+        } else {
+            res->children[sub] = new_path(level - bits, leaf_node);
+        }
+        return res;
+    }
+
+    /**
+     * hang a full tail into the trie, growing the root when it is full
+     */
+    template<bool InPlace>
+    static void push_tail_into(size_type size_before, unsigned& shift, branch*& root, leaf* full_tail) {
+        if (!root) {
+            root = new branch();
+            root->children[0] = full_tail;
+            shift = bits;
+        } else if ((size_before >> bits) > (size_type(1) << shift)) {
+            auto res = new branch();
+            res->children[0] = root;
+            if (!InPlace) root->retain();
+            res->children[1] = new_path(shift, full_tail);
+            root = res;
+            shift += bits;
+        } else {
+            root = push_tail<InPlace>(size_before, shift, root, full_tail);
+        }
+    }
+
+    static node* assoc(unsigned level, node* cur, size_type idx, const T& val) {
+        if (level == 0) {
+            auto src = static_cast<leaf*>(cur);
+            auto res = persistent_detail::copy_leaf(src, src->count);
+            res->values()[idx & mask] = val;
+            return res;
+        }
+        auto res = persistent_detail::copy_branch(static_cast<branch*>(cur));
+        auto sub = (idx >> level) & mask;
+        auto old = res->children[sub];
+        res->children[sub] = assoc(level - bits, old, idx, val);
+        persistent_detail::release<T>(old);
+        return res;
+    }
+
+    // path copy of cur without the last leaf; nullptr when nothing is left
+    branch* pop_tail(unsigned level, branch* cur) const {
+        auto sub = ((count - 2) >> level) & mask;
+        if (level > bits) {
+            auto child = pop_tail(level - bits, static_cast<branch*>(cur->children[sub]));
+            if (!child && sub == 0) return nullptr;
+            auto res = persistent_detail::copy_branch(cur);
+            persistent_detail::release<T>(res->children[sub]);
+            res->children[sub] = child;
+            return res;
+        }
+        if (sub == 0) return nullptr;
+        auto res = persistent_detail::copy_branch(cur);
+        persistent_detail::release<T>(res->children[sub]);
+        res->children[sub] = nullptr;
+        return res;
+    }
+
+    void retain_all() const noexcept {
+        if (root) root->retain();
+        if (tail) tail->retain();
+    }
+
+    void release_all() noexcept {
+        persistent_detail::release<T>(root);
+        persistent_detail::release<T>(tail);
+        root = nullptr;
+        tail = nullptr;
+        count = 0;
+        shift = 0;
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    persistent_vector() noexcept : count(0), shift(0), root(nullptr), tail(nullptr) {}
+
+    persistent_vector(const std::initializer_list<value_type>& init) : persistent_vector() {
+        auto t = transient();
+        for (auto& val : init) t.push_back(val);
+        *this = t.persistent();
+    }
+
+    // snapshot: O(1)
+    persistent_vector(const persistent_vector& rhs) noexcept :
+        count(rhs.count), shift(rhs.shift), root(rhs.root), tail(rhs.tail) {
+        retain_all();
+    }
+
+    persistent_vector(persistent_vector&& rhs) noexcept :
+        count(rhs.count), shift(rhs.shift), root(rhs.root), tail(rhs.tail) {
+        rhs.root = nullptr;
+        rhs.tail = nullptr;
+        rhs.count = rhs.shift = 0;
+    }
+
+    persistent_vector& operator=(const persistent_vector& rhs) noexcept {
+        if (this == &rhs) return *this;
+        rhs.retain_all();
+        release_all();
+        count = rhs.count, shift = rhs.shift, root = rhs.root, tail = rhs.tail;
+        return *this;
+    }
+
+    persistent_vector& operator=(persistent_vector&& rhs) noexcept {
+        if (this == &rhs) return *this;
+        release_all();
+        count = rhs.count, shift = rhs.shift, root = rhs.root, tail = rhs.tail;
+        rhs.root = nullptr;
+        rhs.tail = nullptr;
+        rhs.count = rhs.shift = 0;
+        return *this;
+    }
+
+    ~persistent_vector() { release_all(); }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept { return count; }
+
+    bool empty() const noexcept { return count == 0; }
+
+    const value_type& operator[](size_type idx) const {
+        return leaf_for(idx)->values()[idx & mask];
+    }
+
+    const value_type& at(size_type idx) const {
+        if (idx >= count)
+            throw std::out_of_range("index outof bound");
+        return (*this)[idx];
+    }
+
+    const value_type& back() const { return (*this)[count - 1]; }
+
+    persistent_vector push_back(const value_type& val) const {
+        if (count - tail_offset() < width) {
+            auto new_tail = tail ? persistent_detail::copy_leaf(tail, tail->count) : new leaf();
+            ::new (new_tail->values() + new_tail->count) T(val);
+            new_tail->count ++ ;
+            if (root) root->retain();
+            return persistent_vector(count + 1, shift, root, new_tail);
+        }
+        auto new_shift = shift;
+        auto new_root = root;
+        tail->retain();
+        push_tail_into<false>(count, new_shift, new_root, tail);
+        auto new_tail = new leaf();
+        ::new (new_tail->values()) T(val);
+        new_tail->count = 1;
+        return persistent_vector(count + 1, new_shift, new_root, new_tail);
+    }
+
+    persistent_vector set(size_type idx, const value_type& val) const {
+        if (idx >= count)
+            throw std::out_of_range("index outof bound");
+        if (idx >= tail_offset()) {
+            auto new_tail = persistent_detail::copy_leaf(tail, tail->count);
+            new_tail->values()[idx & mask] = val;
+            if (root) root->retain();
+            return persistent_vector(count, shift, root, new_tail);
+        }
+        auto new_root = static_cast<branch*>(assoc(shift, root, idx, val));
+        tail->retain();
+        return persistent_vector(count, shift, new_root, tail);
+    }
+
+    persistent_vector pop_back() const {
+        assert(count);
+        if (count == 1) return persistent_vector();
+        if (count - tail_offset() > 1) {
+            auto new_tail = persistent_detail::copy_leaf(tail, tail->count - 1);
+            if (root) root->retain();
+            return persistent_vector(count - 1, shift, root, new_tail);
+        }
+        // the tail empties, the last trie leaf becomes the new tail
+        auto new_tail = const_cast<leaf*>(leaf_for(count - 2));
+        new_tail->retain();
+        auto new_root = pop_tail(shift, root);
+        auto new_shift = shift;
+        if (new_root && new_shift > bits && !new_root->children[1]) {
+            auto child = static_cast<branch*>(new_root->children[0]);
+            child->retain();
+            persistent_detail::release<T>(new_root);
+            new_root = child;
+            new_shift -= bits;
+        }
+        if (!new_root) new_shift = 0;
+        return persistent_vector(count - 1, new_shift, new_root, new_tail);
+    }
+
+    transient_vector transient() const {
+        retain_all();
+        return transient_vector(count, shift, root, tail);
+    }
+
+    bool operator==(const persistent_vector& rhs) const {
+        if (count != rhs.count) return false;
+        for (size_type i = 0; i < count; i ++ ) {
+            if (!((*this)[i] == rhs[i])) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Iterator: caches the current leaf, so a scan does one trie walk per 32 elements
+     */
+    class const_iterator {
+    public:
+        using iterator_category = ministl::random_access_iterator_tag;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using difference_type = ptrdiff_t;
+
+    private:
+        const persistent_vector* vec;
+        size_type idx;
+        mutable const leaf* cached;
+        mutable size_type cached_base;
+
+    public:
+        const_iterator() : vec(nullptr), idx(0), cached(nullptr), cached_base(0) {}
+
+        const_iterator(const persistent_vector* vec, size_type idx) :
+            vec(vec), idx(idx), cached(nullptr), cached_base(0) {}
+
+        reference operator*() const {
+            auto base = idx & ~mask;
+            if (!cached || cached_base != base) {
+                cached = vec->leaf_for(idx);
+                cached_base = base;
+            }
+            return cached->values()[idx & mask];
+        }
+
+        pointer operator->() const { return &operator*(); }
+
+        reference operator[](difference_type n) const { return (*vec)[idx + n]; }
+
+        const_iterator& operator++() { idx ++ ; return *this; }
+
+        const_iterator operator++(int) { auto res = *this; idx ++ ; return res; }
+
+        const_iterator& operator--() { idx -- ; return *this; }
+
+        const_iterator operator--(int) { auto res = *this; idx -- ; return res; }
+
+        const_iterator& operator+=(difference_type n) { idx += n; return *this; }
+
+        const_iterator& operator-=(difference_type n) { idx -= n; return *this; }
+
+        const_iterator operator+(difference_type n) const { auto res = *this; res.idx += n; return res; }
+
+        const_iterator operator-(difference_type n) const { auto res = *this; res.idx -= n; return res; }
+
+        difference_type operator-(const const_iterator& rhs) const {
+            return difference_type(idx) - difference_type(rhs.idx);
+        }
+
+        bool operator==(const const_iterator& rhs) const { return idx == rhs.idx; }
+
+        bool operator!=(const const_iterator& rhs) const { return idx != rhs.idx; }
+
+        bool operator<(const const_iterator& rhs) const { return idx < rhs.idx; }
+    };
+
+    using iterator = const_iterator;
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+    const_iterator end() const noexcept { return const_iterator(this, count); }
+
+    /**
+     * single owner, mutable builder. nodes referenced only by the transient
+     * are modified in place, shared ones are copied on first write.
+     */
+    class transient_vector {
+    private:
+        friend class persistent_vector;
+
+        size_type count;
+        unsigned shift;
+        branch* root;
+        leaf* tail;
+
+        transient_vector(size_type count, unsigned shift, branch* root, leaf* tail) :
+            count(count), shift(shift), root(root), tail(tail) {}
+
+        size_type tail_offset() const noexcept {
+            return count < width ? 0 : ((count - 1) >> bits) << bits;
+        }
+
+        // make the tail writable
+        void own_tail() {
+            if (tail && !tail->unique()) {
+                auto copy = persistent_detail::copy_leaf(tail, tail->count);
+                persistent_detail::release<T>(tail);
+                tail = copy;
+            }
+        }
+
+        // make every node on the path to idx writable, return its leaf
+        leaf* own_path(size_type idx) {
+            if (!root->unique()) {
+                auto copy = persistent_detail::copy_branch(root);
+                persistent_detail::release<T>(root);
+                root = copy;
+            }
+            branch* cur = root;
+            for (unsigned level = shift; ; level -= bits) {
+                auto& slot = cur->children[(idx >> level) & mask];
+                if (!slot->unique()) {
+                    node* copy = level == bits ?
+                        static_cast<node*>(persistent_detail::copy_leaf(static_cast<leaf*>(slot),
+                                    static_cast<leaf*>(slot)->count)) :
+                        static_cast<node*>(persistent_detail::copy_branch(static_cast<branch*>(slot)));
+                    persistent_detail::release<T>(slot);
+                    slot = copy;
+                }
+                if (level == bits) return static_cast<leaf*>(slot);
+                cur = static_cast<branch*>(slot);
+            }
+        }
+
+    public:
+        transient_vector(const transient_vector&) = delete;
+
+        transient_vector& operator=(const transient_vector&) = delete;
+
+        transient_vector(transient_vector&& rhs) noexcept :
+            count(rhs.count), shift(rhs.shift), root(rhs.root), tail(rhs.tail) {
+            rhs.root = nullptr;
+            rhs.tail = nullptr;
+            rhs.count = rhs.shift = 0;
+        }
+
+        ~transient_vector() {
+            persistent_detail::release<T>(root);
+            persistent_detail::release<T>(tail);
+        }
+
+        size_type size() const noexcept { return count; }
+
+        const value_type& operator[](size_type idx) const {
+            persistent_vector view(count, shift, root, tail);
+            auto& res = view[idx];
+            view.root = nullptr, view.tail = nullptr;
+            return res;
+        }
+
+        void push_back(const value_type& val) {
+            if (!tail) tail = new leaf();
+            if (count - tail_offset() < width) {
+                own_tail();
+                ::new (tail->values() + tail->count) T(val);
+                tail->count ++ ;
+                count ++ ;
+                return;
+            }
+            persistent_vector::push_tail_into<true>(count, shift, root, tail);
+            tail = new leaf();
+            ::new (tail->values()) T(val);
+            tail->count = 1;
+            count ++ ;
+        }
+
+        void set(size_type idx, const value_type& val) {
+            if (idx >= count)
+                throw std::out_of_range("index outof bound");
+            if (idx >= tail_offset()) {
+                own_tail();
+                tail->values()[idx & mask] = val;
+            } else {
+                own_path(idx)->values()[idx & mask] = val;
+            }
+        }
+
+        /**
+         * freeze into a persistent version, the transient is left empty
+         */
+        persistent_vector persistent() {
+            persistent_vector res(count, shift, root, tail);
+            root = nullptr;
+            tail = nullptr;
+            count = shift = 0;
+            return res;
+        }
+    };
+};
+
+}
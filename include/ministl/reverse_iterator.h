@@ -1,26 +1,40 @@
 #pragma once
 
 #include <ministl/iterator.h>
+#include <type_traits>
 
 namespace ministl
 {
 
 template<typename Iter>
 class reverse_iterator {
+private:
+    using base_category = typename ministl::iterator_traits<Iter>::iterator_category;
+
 public:
-    // any used defined iterator must implement 5 associated types
-    using iterator_category = typename ministl::iterator_traits<Iter>::iterator_category;
+    // any used defined iterator must implement 5 associated types.
+    // walking memory backwards is no longer contiguous, only random access
+    using iterator_category = std::conditional_t<std::is_convertible_v<base_category, contiguous_iterator_tag>,
+                                                 random_access_iterator_tag, base_category>;
     using value_type = typename ministl::iterator_traits<Iter>::value_type;
     using pointer = typename ministl::iterator_traits<Iter>::pointer;
     using reference = typename ministl::iterator_traits<Iter>::reference;
     using difference_type = typename ministl::iterator_traits<Iter>::difference_type;
+    using iterator_type = Iter;
 
 private:
     Iter current;
 
 public: // constructor
+    reverse_iterator() : current() {}
+
     reverse_iterator(Iter forward_iter) : current(forward_iter) {}
 
+    // e.g. iterator to const_iterator
+    template<typename Other>
+        requires std::is_convertible_v<Other, Iter>
+    reverse_iterator(const reverse_iterator<Other>& rhs) : current(rhs.base()) {}
+
 
 public: // basic operation
     Iter base() const {
@@ -59,15 +73,21 @@ public: // basic operation
         return &(operator*());
     }
 
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
     reverse_iterator& operator+=(difference_type dist) {
         current -= dist;
         return *this;
     }
 
     reverse_iterator operator+(difference_type dist) const {
-        auto res = *this;
-        res.current -= dist;
-        return *this;
+        return reverse_iterator(current - dist);
+    }
+
+    friend reverse_iterator operator+(difference_type dist, const reverse_iterator& iter) {
+        return iter + dist;
     }
 
     reverse_iterator& operator-=(difference_type dist) {
@@ -76,12 +96,14 @@ public: // basic operation
     }
 
     reverse_iterator operator-(difference_type dist) const {
-        auto res = *this;
-        res.current += dist;
-        return *this;
+        return reverse_iterator(current + dist);
     }
 
-    bool operator=(const reverse_iterator& rhs) const {
+    difference_type operator-(const reverse_iterator& rhs) const {
+        return rhs.current - current;
+    }
+
+    bool operator==(const reverse_iterator& rhs) const {
         return current == rhs.current;
     }
 
@@ -89,6 +111,28 @@ public: // basic operation
         return current != rhs.current;
     }
 
+    // the order is the opposite of the base iterators
+    bool operator<(const reverse_iterator& rhs) const {
+        return rhs.current < current;
+    }
+
+    bool operator>(const reverse_iterator& rhs) const {
+        return current < rhs.current;
+    }
+
+    bool operator<=(const reverse_iterator& rhs) const {
+        return !(current < rhs.current);
+    }
+
+    bool operator>=(const reverse_iterator& rhs) const {
+        return !(rhs.current < current);
+    }
+
 };
 
+template<typename Iter>
+reverse_iterator<Iter> make_reverse_iterator(Iter iter) {
+    return reverse_iterator<Iter>(iter);
+}
+
 }
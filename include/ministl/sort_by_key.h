@@ -0,0 +1,143 @@
+#pragma once
+#include <ministl/vector.h>
+#include <ministl/algorithm.h>
+#include <ministl/functional.h>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace ministl
+{
+
+namespace sort_by_key_detail
+{
+
+template<typename Key, typename Index>
+struct key_index {
+    Key key;
+    Index index;
+};
+
+template<typename Iter, typename KeyFn>
+using key_type = std::decay_t<std::invoke_result_t<KeyFn&,
+      const typename ministl::iterator_traits<Iter>::value_type&>>;
+
+/**
+ * (key, index) of every element, sorted stably by key
+ */
+template<typename Index, typename Iter, typename KeyFn, typename Compare>
+ministl::vector<key_index<key_type<Iter, KeyFn>, Index>>
+sorted_keys(Iter first, Iter last, KeyFn& key_fn, Compare& cmp) {
+    ministl::vector<key_index<key_type<Iter, KeyFn>, Index>> entries;
+    Index n = Index(last - first);
+    for (Index i = 0; i < n; i ++ ) entries.push_back({key_fn(first[i]), i});
+    ministl::stable_sort(entries.begin(), entries.end(),
+            [&cmp](const auto& lhs, const auto& rhs) { return cmp(lhs.key, rhs.key); });
+    return entries;
+}
+
+/**
+ * element source(i) moves to position i. every cycle of the permutation is
+ * walked once, each element is moved once plus one extra move per cycle.
+ * mark(i) records that position i is final, done(i) tests it
+ */
+template<typename Iter, typename Source, typename Mark, typename Done>
+void permute_cycles(Iter first, size_t n, Source source, Mark mark, Done done) {
+    for (size_t i = 0; i < n; i ++ ) {
+        if (done(i)) continue;
+        auto next = source(i);
+        if (next == i) {
+            mark(i);
+            continue;
+        }
+        auto tmp = std::move(first[i]);
+        size_t cur = i;
+        while (next != i) {
+            first[cur] = std::move(first[next]);
+            mark(cur);
+            cur = next;
+            next = source(cur);
+        }
+        first[cur] = std::move(tmp);
+        mark(cur);
+    }
+}
+
+template<typename Index, typename Iter, typename KeyFn, typename Compare>
+void sort_by_key(Iter first, Iter last, KeyFn& key_fn, Compare& cmp) {
+    auto entries = sorted_keys<Index>(first, last, key_fn, cmp);
+    // the index field doubles as the visited mark: a finished slot points at itself
+    auto data = entries.begin();
+    permute_cycles(first, entries.size(),
+            [data](size_t i) { return size_t(data[i].index); },
+            [data](size_t i) { data[i].index = Index(i); },
+            [data](size_t i) { return size_t(data[i].index) == i; });
+}
+
+}
+
+/**
+ * indirect sorting for wide elements.
+ *
+ * sort_by_key extracts key_fn(element) once per element, sorts compact
+ * (key, index) pairs and then moves every element into place by following
+ * the cycles of the permutation: about n + cycles element moves in total,
+ * instead of the O(n log n) swaps a direct sort does on the records.
+ * stable: equal keys keep their input order.
+ */
+template<typename Iter, typename KeyFn, typename Compare>
+void sort_by_key(Iter first, Iter last, KeyFn key_fn, Compare cmp) {
+    if (last - first < 2) return;
+    if (size_t(last - first) <= UINT32_MAX) {
+        sort_by_key_detail::sort_by_key<uint32_t>(first, last, key_fn, cmp);
+    } else {
+        sort_by_key_detail::sort_by_key<size_t>(first, last, key_fn, cmp);
+    }
+}
+
+template<typename Iter, typename KeyFn>
+void sort_by_key(Iter first, Iter last, KeyFn key_fn) {
+    ministl::sort_by_key(first, last, key_fn, ministl::less<> {});
+}
+
+/**
+ * the sorting permutation: element first[res[i]] belongs at position i.
+ * the range itself is not modified. stable like sort_by_key
+ */
+template<typename Iter, typename KeyFn, typename Compare>
+ministl::vector<size_t> argsort(Iter first, Iter last, KeyFn key_fn, Compare cmp) {
+    auto n = size_t(last - first);
+    ministl::vector<size_t> res(n);
+    auto fill_from = [&res](const auto& entries) {
+        for (size_t i = 0; i < entries.size(); i ++ ) res[i] = entries[i].index;
+    };
+    if (n <= UINT32_MAX) {
+        fill_from(sort_by_key_detail::sorted_keys<uint32_t>(first, last, key_fn, cmp));
+    } else {
+        fill_from(sort_by_key_detail::sorted_keys<size_t>(first, last, key_fn, cmp));
+    }
+    return res;
+}
+
+template<typename Iter, typename KeyFn>
+ministl::vector<size_t> argsort(Iter first, Iter last, KeyFn key_fn) {
+    return ministl::argsort(first, last, key_fn, ministl::less<> {});
+}
+
+/**
+ * reorder [first, first + perm.size()) so position i gets the element that
+ * was at perm[i] (the layout argsort returns). perm is left untouched.
+ * one bit of scratch per element.
+ */
+template<typename Iter>
+void apply_permutation(Iter first, const ministl::vector<size_t>& perm) {
+    auto n = perm.size();
+    ministl::vector<uint64_t> visited((n + 63) / 64, 0);
+    sort_by_key_detail::permute_cycles(first, n,
+            [&perm](size_t i) { return perm[i]; },
+            [&visited](size_t i) { visited[i >> 6] |= uint64_t(1) << (i & 63); },
+            [&visited](size_t i) { return bool(visited[i >> 6] >> (i & 63) & 1); });
+}
+
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/functional.h>
+#include <ministl/iterator.h>
+#include <ministl/vector.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace ministl
+{
+
+namespace sort_small_detail
+{
+
+// largest range the sorting networks cover
+constexpr size_t max_size = 64;
+
+/**
+ * batcher's odd-even merge sort network for N = 2^k keys, as comparator
+ * pairs (lo[c], hi[c]) with lo < hi, run in order. a network for n < N
+ * keys is the same list without the pairs that touch an index >= n: think
+ * of the missing keys as +infinity parked at the top, comparators never
+ * move them down, so those pairs never do anything.
+ */
+constexpr size_t network_size(size_t n) {
+    size_t count = 0;
+    for (size_t p = 1; p < n; p <<= 1) {
+        for (size_t k = p; k >= 1; k >>= 1) {
+            for (size_t j = k % p; j + k < n; j += 2 * k) {
+                for (size_t i = 0; i < k && i + j + k < n; i ++ ) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) count ++ ;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+template<size_t N>
+struct network {
+    constexpr static size_t size = network_size(N);
+    uint8_t lo[size], hi[size];
+
+    constexpr network() : lo(), hi() {
+        size_t count = 0;
+        for (size_t p = 1; p < N; p <<= 1) {
+            for (size_t k = p; k >= 1; k >>= 1) {
+                for (size_t j = k % p; j + k < N; j += 2 * k) {
+                    for (size_t i = 0; i < k && i + j + k < N; i ++ ) {
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                            lo[count] = uint8_t(i + j);
+                            hi[count] = uint8_t(i + j + k);
+                            count ++ ;
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+inline constexpr network<4> network4 {};
+inline constexpr network<8> network8 {};
+inline constexpr network<16> network16 {};
+inline constexpr network<32> network32 {};
+inline constexpr network<64> network64 {};
+
+/**
+ * the comparators of the network for n keys, 2 <= n <= 64
+ */
+struct comparators {
+    uint8_t lo[network<64>::size], hi[network<64>::size];
+    size_t size = 0;
+
+    explicit comparators(size_t n) {
+        auto copy = [this, n](const auto& net) {
+            for (size_t c = 0; c < net.size; c ++ ) {
+                if (net.hi[c] >= n) continue;
+                lo[size] = net.lo[c], hi[size] = net.hi[c];
+                size ++ ;
+            }
+        };
+        if (n <= 2) lo[0] = 0, hi[0] = 1, size = n == 2;
+        else if (n <= 4) copy(network4);
+        else if (n <= 8) copy(network8);
+        else if (n <= 16) copy(network16);
+        else if (n <= 32) copy(network32);
+        else copy(network64);
+    }
+};
+
+// comparators for every n, built on first use
+inline const comparators& network_for(size_t n) {
+    static const ministl::vector<comparators> table = [] {
+        ministl::vector<comparators> res;
+        for (size_t i = 0; i <= max_size; i ++ ) res.push_back(comparators(i));
+        return res;
+    }();
+    return table[n];
+}
+
+template<typename T>
+constexpr bool is_key_type_v = std::is_same_v<T, float> || std::is_same_v<T, double> ||
+    std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
+    std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>;
+
+template<typename Compare, typename T>
+constexpr bool is_less_v = std::is_same_v<Compare, ministl::less<>> || std::is_same_v<Compare, ministl::less<T>> ||
+    std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+
+template<typename Compare, typename T>
+constexpr bool is_greater_v = std::is_same_v<Compare, ministl::greater<>> ||
+    std::is_same_v<Compare, ministl::greater<T>> ||
+    std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<T>>;
+
+/**
+ * one key range through the network. trivially copyable keys are loaded
+ * into a local array and compare-exchanged without branches, the select
+ * becomes min/max or cmov; other types swap when out of order.
+ */
+template<typename Iter, typename Compare>
+void run_network(Iter first, size_t n, const comparators& net, Compare& cmp) {
+    using value_type = typename ministl::iterator_traits<Iter>::value_type;
+    if constexpr (std::is_trivially_copyable_v<value_type> && std::is_default_constructible_v<value_type> &&
+                  ministl::is_contiguous_iterator<Iter>::value) {
+        value_type keys[max_size];
+        auto data = ministl::to_address(first);
+        std::memcpy(keys, data, n * sizeof (value_type));
+        for (size_t c = 0; c < net.size; c ++ ) {
+            auto a = keys[net.lo[c]], b = keys[net.hi[c]];
+            bool swapped = cmp(b, a);
+            keys[net.lo[c]] = swapped ? b : a;
+            keys[net.hi[c]] = swapped ? a : b;
+        }
+        std::memcpy(data, keys, n * sizeof (value_type));
+    } else {
+        for (size_t c = 0; c < net.size; c ++ ) {
+            auto& a = *(first + net.lo[c]);
+            auto& b = *(first + net.hi[c]);
+            if (cmp(b, a)) ministl::swap(a, b);
+        }
+    }
+}
+
+/**
+ * sort_many kernel: one segment per vector lane. a block of lanes
+ * segments is transposed so row i holds key i of every segment, the
+ * network then runs on whole rows with vector min/max, and the block is
+ * transposed back. returns how many segments it sorted, a multiple of
+ * lanes.
+ */
+template<typename T, size_t Bytes, bool Descending>
+[[gnu::always_inline]] inline size_t sort_columns_body(T* data, size_t seg, size_t count, const comparators& net) {
+    using vec [[gnu::vector_size(Bytes)]] = T;
+    constexpr size_t lanes = Bytes / sizeof (T);
+    alignas(64) T rows[max_size * lanes];
+    size_t s = 0;
+    for (; s + lanes <= count; s += lanes) {
+        T* block = data + s * seg;
+        for (size_t l = 0; l < lanes; l ++ ) {
+            for (size_t i = 0; i < seg; i ++ ) rows[i * lanes + l] = block[l * seg + i];
+        }
+        for (size_t c = 0; c < net.size; c ++ ) {
+            vec a, b;
+            std::memcpy(&a, rows + net.lo[c] * lanes, Bytes);
+            std::memcpy(&b, rows + net.hi[c] * lanes, Bytes);
+            vec small = Descending ? (b < a ? a : b) : (b < a ? b : a);
+            vec large = Descending ? (b < a ? b : a) : (b < a ? a : b);
+            std::memcpy(rows + net.lo[c] * lanes, &small, Bytes);
+            std::memcpy(rows + net.hi[c] * lanes, &large, Bytes);
+        }
+        for (size_t l = 0; l < lanes; l ++ ) {
+            for (size_t i = 0; i < seg; i ++ ) block[l * seg + i] = rows[i * lanes + l];
+        }
+    }
+    return s;
+}
+
+#if defined(__x86_64__)
+
+// 2: avx-512, 1: avx2, 0: none
+inline int simd_level() {
+    static const int res = __builtin_cpu_supports("avx512f") ? 2 : __builtin_cpu_supports("avx2") ? 1 : 0;
+    return res;
+}
+
+template<typename T, bool Descending>
+__attribute__((target("avx512f")))
+size_t sort_columns_avx512(T* data, size_t seg, size_t count, const comparators& net) {
+    return sort_columns_body<T, 64, Descending>(data, seg, count, net);
+}
+
+template<typename T, bool Descending>
+__attribute__((target("avx2")))
+size_t sort_columns_avx2(T* data, size_t seg, size_t count, const comparators& net) {
+    return sort_columns_body<T, 32, Descending>(data, seg, count, net);
+}
+
+#endif
+
+// segments the simd kernel sorted, from the front; 0 without avx2
+template<typename T, bool Descending>
+size_t sort_columns(T* data, size_t seg, size_t count, const comparators& net) {
+#if defined(__x86_64__)
+    if (simd_level() == 2) return sort_columns_avx512<T, Descending>(data, seg, count, net);
+    if (simd_level() == 1) return sort_columns_avx2<T, Descending>(data, seg, count, net);
+#endif
+    return 0;
+}
+
+}
+
+/**
+ * sort a range of at most 64 elements with a sorting network: a fixed
+ * sequence of compare-exchanges with no data dependent branches, so the
+ * cost does not depend on the input order and nothing mispredicts. not
+ * stable. larger ranges fall back to ministl::stable_sort.
+ */
+template<typename Iter, typename Compare>
+void sort_small(Iter first, Iter last, Compare cmp) {
+    size_t n = last - first;
+    if (n < 2) return;
+    if (n > sort_small_detail::max_size) {
+        ministl::stable_sort(first, last, cmp);
+        return;
+    }
+    sort_small_detail::run_network(first, n, sort_small_detail::network_for(n), cmp);
+}
+
+template<typename Iter>
+void sort_small(Iter first, Iter last) {
+    ministl::sort_small(first, last, ministl::less<> {});
+}
+
+/**
+ * sort each segment [first + i * segment_size, first + (i + 1) * segment_size)
+ * of a range made of equally sized segments, e.g. per row candidate lists
+ * stored back to back.
+ *
+ * all segments run the same network. float, double and 32/64 bit integer
+ * keys under less or greater sort one segment per simd lane (8 or 16
+ * segments at a time with avx2 or avx-512), the rest and the leftover
+ * segments go through the network one by one. segments longer than 64 are
+ * stable sorted.
+ */
+template<typename Iter, typename Compare>
+void sort_many(Iter first, Iter last, size_t segment_size, Compare cmp) {
+    size_t n = last - first;
+    if (segment_size < 2 || n == 0) return;
+    assert(n % segment_size == 0);
+    size_t count = n / segment_size;
+    if (segment_size > sort_small_detail::max_size) {
+        for (size_t s = 0; s < count; s ++ ) {
+            ministl::stable_sort(first + s * segment_size, first + (s + 1) * segment_size, cmp);
+        }
+        return;
+    }
+    auto& net = sort_small_detail::network_for(segment_size);
+    size_t done = 0;
+    using value_type = typename ministl::iterator_traits<Iter>::value_type;
+    if constexpr (ministl::is_contiguous_iterator<Iter>::value && sort_small_detail::is_key_type_v<value_type> &&
+                  !std::is_const_v<std::remove_pointer_t<typename ministl::iterator_traits<Iter>::pointer>>) {
+        if constexpr (sort_small_detail::is_less_v<Compare, value_type>) {
+            done = sort_small_detail::sort_columns<value_type, false>(ministl::to_address(first), segment_size, count, net);
+        } else if constexpr (sort_small_detail::is_greater_v<Compare, value_type>) {
+            done = sort_small_detail::sort_columns<value_type, true>(ministl::to_address(first), segment_size, count, net);
+        }
+    }
+    for (size_t s = done; s < count; s ++ ) {
+        sort_small_detail::run_network(first + s * segment_size, segment_size, net, cmp);
+    }
+}
+
+template<typename Iter>
+void sort_many(Iter first, Iter last, size_t segment_size) {
+    ministl::sort_many(first, last, segment_size, ministl::less<> {});
+}
+
+}
@@ -0,0 +1,380 @@
+#pragma once
+#include <ministl/string_view.h>
+#include <ministl/reverse_iterator.h>
+#include <ministl/algorithm.h>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace ministl
+{
+
+/**
+ * string with small string optimization.
+ *
+ * the object is 24 bytes. short strings (up to 23 chars) live inline:
+ * bytes [0, 23) hold the chars and byte 23 holds (23 - size), so a full
+ * short string uses that byte as its own '\0' terminator.
+ * long strings store {pointer, size, capacity}; the top bit of capacity
+ * lands in byte 23 on little endian and marks the long mode.
+ */
+class string {
+public:
+    using value_type = char;
+    using size_type = size_t;
+    using iterator = char*;
+    using const_iterator = const char*;
+    using pointer = char*;
+
+    constexpr static size_type npos = static_cast<size_type>(-1);
+
+private:
+    static_assert(std::endian::native == std::endian::little,
+            "sso layout relies on little endian capacity field");
+
+    struct long_rep {
+        char* ptr;
+        size_type size;
+        size_type cap; // top bit is the long flag
+    };
+
+    constexpr static size_type rep_bytes = sizeof (long_rep);
+    constexpr static size_type short_capacity = rep_bytes - 1;
+    constexpr static size_type long_flag = size_type(1) << (sizeof (size_type) * 8 - 1);
+    constexpr static unsigned char long_flag_byte = 0x80;
+
+    union {
+        long_rep l;
+        char s[rep_bytes];
+    } rep;
+
+    bool is_long() const noexcept {
+        return static_cast<unsigned char>(rep.s[short_capacity]) & long_flag_byte;
+    }
+
+    void set_short_size(size_type n) noexcept {
+        // callers only get here for short sizes; tells -Warray-bounds as much
+        if (n > short_capacity) __builtin_unreachable();
+        rep.s[short_capacity] = static_cast<char>(short_capacity - n);
+        rep.s[n] = '\0';
+    }
+
+    void set_long(char* ptr, size_type n, size_type cap) noexcept {
+        rep.l.ptr = ptr;
+        rep.l.size = n;
+        rep.l.cap = cap | long_flag;
+        ptr[n] = '\0';
+    }
+
+    static char* allocate(size_type cap) {
+        return ::new char[cap + 1];
+    }
+
+    void release() noexcept {
+        if (is_long()) ::delete[] rep.l.ptr;
+    }
+
+    /**
+     * make room for at least new_cap chars, keeping the current content.
+     * the buffer at least doubles, so a sequence of appends grows geometrically
+     */
+    void grow_to(size_type new_cap) {
+        auto old_cap = capacity();
+        if (new_cap <= old_cap) return;
+        if (new_cap < old_cap * 2) new_cap = old_cap * 2;
+        auto n = size();
+        char* buf = allocate(new_cap);
+        std::memcpy(buf, data(), n);
+        release();
+        set_long(buf, n, new_cap);
+    }
+
+    void init(const char* str, size_type n) {
+        if (n <= short_capacity) {
+            std::memcpy(rep.s, str, n);
+            set_short_size(n);
+        } else {
+            char* buf = allocate(n);
+            std::memcpy(buf, str, n);
+            set_long(buf, n, n);
+        }
+    }
+
+    void set_size(size_type n) noexcept {
+        if (is_long()) {
+            rep.l.size = n;
+            rep.l.ptr[n] = '\0';
+        } else {
+            set_short_size(n);
+        }
+    }
+
+public:
+    /**
+     * Constructor
+     */
+    string() noexcept { set_short_size(0); }
+
+    string(const char* str) { init(str, std::strlen(str)); }
+
+    string(const char* str, size_type n) { init(str, n); }
+
+    explicit string(string_view sv) { init(sv.data(), sv.size()); }
+
+    string(size_type n, char ch) {
+        if (n <= short_capacity) {
+            std::memset(rep.s, ch, n);
+            set_short_size(n);
+        } else {
+            char* buf = allocate(n);
+            std::memset(buf, ch, n);
+            set_long(buf, n, n);
+        }
+    }
+
+    string(const string& rhs) { init(rhs.data(), rhs.size()); }
+
+    string(string&& rhs) noexcept : rep(rhs.rep) {
+        rhs.set_short_size(0);
+    }
+
+    string& operator=(const string& rhs) {
+        if (this == &rhs) return *this;
+        return assign(rhs.data(), rhs.size());
+    }
+
+    string& operator=(string&& rhs) noexcept {
+        if (this == &rhs) return *this;
+        release();
+        rep = rhs.rep;
+        rhs.set_short_size(0);
+        return *this;
+    }
+
+    string& operator=(const char* str) { return assign(str, std::strlen(str)); }
+
+    string& operator=(string_view sv) { return assign(sv.data(), sv.size()); }
+
+    ~string() { release(); }
+
+    /**
+     * reuse the current buffer when it is large enough
+     */
+    string& assign(const char* str, size_type n) {
+        if (n > capacity()) {
+            string tmp(str, n);
+            swap(tmp);
+        } else {
+            std::memmove(data(), str, n);
+            set_size(n);
+        }
+        return *this;
+    }
+
+    /**
+     * Operation
+     */
+    size_type size() const noexcept {
+        return is_long() ? rep.l.size : short_capacity - static_cast<unsigned char>(rep.s[short_capacity]);
+    }
+
+    size_type length() const noexcept { return size(); }
+
+    size_type capacity() const noexcept {
+        return is_long() ? (rep.l.cap & ~long_flag) : short_capacity;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    char* data() noexcept { return is_long() ? rep.l.ptr : rep.s; }
+
+    const char* data() const noexcept { return is_long() ? rep.l.ptr : rep.s; }
+
+    const char* c_str() const noexcept { return data(); }
+
+    char& operator[](size_type idx) { return data()[idx]; }
+
+    const char& operator[](size_type idx) const { return data()[idx]; }
+
+    char& at(size_type idx) {
+        return const_cast<char&> (static_cast<const string *>(this)->at(idx));
+    }
+
+    const char& at(size_type idx) const {
+        if (idx >= size())
+            throw std::out_of_range("index outof bound");
+        return data()[idx];
+    }
+
+    char& front() { return data()[0]; }
+
+    char& back() { return data()[size() - 1]; }
+
+    void reserve(size_type n) {
+        if (n <= capacity()) return;
+        auto sz = size();
+        char* buf = allocate(n);
+        std::memcpy(buf, data(), sz);
+        release();
+        set_long(buf, sz, n);
+    }
+
+    void clear() noexcept { set_size(0); }
+
+    void resize(size_type n, char ch = '\0') {
+        auto sz = size();
+        if (n > sz) {
+            grow_to(n);
+            std::memset(data() + sz, ch, n - sz);
+        }
+        set_size(n);
+    }
+
+    void push_back(char ch) {
+        auto sz = size();
+        if (sz == capacity()) [[unlikely]] grow_to(sz + 1);
+        data()[sz] = ch;
+        set_size(sz + 1);
+    }
+
+    void pop_back() {
+        assert(size());
+        set_size(size() - 1);
+    }
+
+    /**
+     * the final size is known up front, so append grows at most once
+     */
+    string& append(const char* str, size_type n) {
+        auto sz = size();
+        if (sz + n > capacity()) {
+            // str may point into ourself, copy it out before releasing the buffer
+            if (str >= data() && str < data() + sz) {
+                string tmp(str, n);
+                return append(tmp.data(), n);
+            }
+            grow_to(sz + n);
+        }
+        std::memcpy(data() + sz, str, n);
+        set_size(sz + n);
+        return *this;
+    }
+
+    string& append(string_view sv) { return append(sv.data(), sv.size()); }
+
+    string& append(const string& rhs) { return append(rhs.data(), rhs.size()); }
+
+    string& append(const char* str) { return append(str, std::strlen(str)); }
+
+    string& append(size_type n, char ch) {
+        resize(size() + n, ch);
+        return *this;
+    }
+
+    string& operator+=(const string& rhs) { return append(rhs); }
+
+    string& operator+=(string_view sv) { return append(sv); }
+
+    string& operator+=(const char* str) { return append(str); }
+
+    string& operator+=(char ch) {
+        push_back(ch);
+        return *this;
+    }
+
+    string substr(size_type pos = 0, size_type n = npos) const {
+        return string(string_view(*this).substr(pos, n));
+    }
+
+    size_type find(char ch, size_type pos = 0) const {
+        return string_view(*this).find(ch, pos);
+    }
+
+    size_type find(string_view target, size_type pos = 0) const {
+        return string_view(*this).find(target, pos);
+    }
+
+    size_type rfind(char ch, size_type pos = npos) const {
+        return string_view(*this).rfind(ch, pos);
+    }
+
+    int compare(string_view rhs) const {
+        return string_view(*this).compare(rhs);
+    }
+
+    bool starts_with(string_view prefix) const {
+        return string_view(*this).starts_with(prefix);
+    }
+
+    bool ends_with(string_view suffix) const {
+        return string_view(*this).ends_with(suffix);
+    }
+
+    void swap(string& rhs) noexcept {
+        auto tmp = rep;
+        rep = rhs.rep;
+        rhs.rep = tmp;
+    }
+
+    operator string_view() const noexcept {
+        return string_view(data(), size());
+    }
+
+    /**
+     * Iterator
+     */
+    iterator begin() noexcept { return data(); }
+
+    iterator end() noexcept { return data() + size(); }
+
+    const_iterator begin() const noexcept { return data(); }
+
+    const_iterator end() const noexcept { return data() + size(); }
+
+    ministl::reverse_iterator<iterator> rbegin() {
+        return reverse_iterator<iterator> (end());
+    }
+
+    ministl::reverse_iterator<iterator> rend() {
+        return reverse_iterator<iterator> (begin());
+    }
+
+    ministl::reverse_iterator<const_iterator> rbegin() const {
+        return reverse_iterator<const_iterator> (end());
+    }
+
+    ministl::reverse_iterator<const_iterator> rend() const {
+        return reverse_iterator<const_iterator> (begin());
+    }
+
+    friend string operator+(string_view lhs, string_view rhs) {
+        string res;
+        res.reserve(lhs.size() + rhs.size());
+        res.append(lhs).append(rhs);
+        return res;
+    }
+
+    friend string operator+(string&& lhs, string_view rhs) {
+        lhs.append(rhs);
+        return std::move(lhs);
+    }
+
+    friend bool operator==(const string& lhs, const string& rhs) {
+        return string_view(lhs) == string_view(rhs);
+    }
+
+    friend bool operator!=(const string& lhs, const string& rhs) { return !(lhs == rhs); }
+
+    friend bool operator<(const string& lhs, const string& rhs) {
+        return string_view(lhs) < string_view(rhs);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const string& rhs) {
+        return os << string_view(rhs);
+    }
+};
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <ministl/algorithm.h>
+#include <ministl/reverse_iterator.h>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace ministl
+{
+
+/**
+ * non-owning view over a contiguous char sequence
+ */
+class string_view {
+public:
+    using value_type = char;
+    using size_type = size_t;
+    using iterator = const char*;
+    using const_iterator = const char*;
+    using pointer = const char*;
+
+    constexpr static size_type npos = static_cast<size_type>(-1);
+
+private:
+    const char* data_ptr;
+    size_type len;
+
+public:
+    /**
+     * Constructor
+     */
+    constexpr string_view() noexcept : data_ptr(nullptr), len(0) {}
+
+    constexpr string_view(const char* str, size_type n) noexcept : data_ptr(str), len(n) {}
+
+    string_view(const char* str) : data_ptr(str), len(std::strlen(str)) {}
+
+    /**
+     * Operation
+     */
+    constexpr const char* data() const noexcept { return data_ptr; }
+
+    constexpr size_type size() const noexcept { return len; }
+
+    constexpr size_type length() const noexcept { return len; }
+
+    constexpr bool empty() const noexcept { return len == 0; }
+
+    constexpr const char& operator[](size_type idx) const { return data_ptr[idx]; }
+
+    const char& at(size_type idx) const {
+        if (idx >= len)
+            throw std::out_of_range("index outof bound");
+        return data_ptr[idx];
+    }
+
+    const char& front() const { return data_ptr[0]; }
+
+    const char& back() const { return data_ptr[len - 1]; }
+
+    void remove_prefix(size_type n) { data_ptr += n, len -= n; }
+
+    void remove_suffix(size_type n) { len -= n; }
+
+    string_view substr(size_type pos = 0, size_type n = npos) const {
+        if (pos > len)
+            throw std::out_of_range("substr position outof bound");
+        return {data_ptr + pos, n < len - pos ? n : len - pos};
+    }
+
+    size_type find(char ch, size_type pos = 0) const {
+        if (pos >= len) return npos;
+        auto it = ministl::find(begin() + pos, end(), ch);
+        return it == end() ? npos : it - begin();
+    }
+
+    size_type find(string_view target, size_type pos = 0) const {
+        if (pos > len) return npos;
+        if (target.empty()) return pos;
+        auto it = ministl::search(begin() + pos, end(), target.begin(), target.end());
+        return it == end() ? npos : it - begin();
+    }
+
+    size_type rfind(char ch, size_type pos = npos) const {
+        if (len == 0) return npos;
+        size_type i = pos < len ? pos + 1 : len;
+        while (i -- ) {
+            if (data_ptr[i] == ch) return i;
+        }
+        return npos;
+    }
+
+    // bytes compare as unsigned char, like std::char_traits<char>
+    int compare(string_view rhs) const {
+        auto lhs_bytes = reinterpret_cast<const unsigned char*>(data_ptr);
+        auto rhs_bytes = reinterpret_cast<const unsigned char*>(rhs.data_ptr);
+        return ministl::lexicographical_compare_three_way(lhs_bytes, lhs_bytes + len, rhs_bytes, rhs_bytes + rhs.len);
+    }
+
+    bool starts_with(string_view prefix) const {
+        return len >= prefix.len && ministl::equal(prefix.begin(), prefix.end(), begin());
+    }
+
+    bool ends_with(string_view suffix) const {
+        return len >= suffix.len && ministl::equal(suffix.begin(), suffix.end(), end() - suffix.len);
+    }
+
+    /**
+     * Iterator
+     */
+    constexpr iterator begin() const noexcept { return data_ptr; }
+
+    constexpr iterator end() const noexcept { return data_ptr + len; }
+
+    ministl::reverse_iterator<iterator> rbegin() const {
+        return reverse_iterator<iterator> (end());
+    }
+
+    ministl::reverse_iterator<iterator> rend() const {
+        return reverse_iterator<iterator> (begin());
+    }
+
+    friend bool operator==(string_view lhs, string_view rhs) {
+        return lhs.len == rhs.len && ministl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(string_view lhs, string_view rhs) { return !(lhs == rhs); }
+
+    friend bool operator<(string_view lhs, string_view rhs) { return lhs.compare(rhs) < 0; }
+
+    friend bool operator>(string_view lhs, string_view rhs) { return lhs.compare(rhs) > 0; }
+
+    friend bool operator<=(string_view lhs, string_view rhs) { return lhs.compare(rhs) <= 0; }
+
+    friend bool operator>=(string_view lhs, string_view rhs) { return lhs.compare(rhs) >= 0; }
+
+    friend std::ostream& operator<<(std::ostream& os, string_view rhs) {
+        return os.write(rhs.data_ptr, rhs.len);
+    }
+};
+
+}
@@ -5,3 +5,17 @@ using test_result = std::pair<int, int>; // score, full score
 
 test_result vector_test();
 test_result iterator_traits_test();
+test_result string_test();
+test_result algorithm_test();
+test_result list_test();
+test_result log_test();
+test_result perf_test();
+test_result persistent_vector_test();
+test_result inplace_vector_test();
+test_result packed_vector_test();
+test_result concurrent_hash_map_test();
+test_result external_sort_test();
+test_result numeric_test();
+test_result deque_test();
+test_result lru_cache_test();
+test_result filter_test();
@@ -0,0 +1,95 @@
+#pragma once
+#include <ministl/vector.h>
+#include <ministl/algorithm.h>
+#include <ministl/functional.h>
+#include <cstddef>
+
+namespace ministl
+{
+
+/**
+ * streaming top-k accumulator.
+ *
+ * keeps the k greatest values (w.r.t. Compare) seen so far in a bounded heap
+ * whose root is the smallest kept value, so a value that does not make it
+ * costs a single comparison and an accepted one O(log k).
+ */
+template<typename T, typename Compare = ministl::less<T>>
+class top_k {
+public:
+    using value_type = T;
+    using size_type = size_t;
+
+private:
+    // heap comparator: the root must be the *smallest* kept value
+    struct heap_compare {
+        Compare cmp;
+        bool operator()(const T& lhs, const T& rhs) const {
+            return cmp(rhs, lhs);
+        }
+    };
+
+    size_type k;
+    ministl::vector<T> heap;
+    heap_compare heap_cmp;
+
+public:
+    /**
+     * Constructor
+     */
+    explicit top_k(size_type k, Compare cmp = Compare {}) : k(k), heap(), heap_cmp {cmp} {}
+
+    /**
+     * Operation
+     */
+    void push(const value_type& val) {
+        if (k == 0) return;
+        if (heap.size() < k) {
+            heap.push_back(val);
+            ministl::push_heap(heap.begin(), heap.end(), heap_cmp);
+        } else if (heap_cmp.cmp(heap[0], val)) {
+            heap[0] = val;
+            ministl::sift_down(heap.begin(), heap.end() - heap.begin(), ptrdiff_t {0}, heap_cmp);
+        }
+    }
+
+    template<typename Iter>
+    void push(Iter first, Iter last) {
+        for (; first != last; ++ first) push(*first);
+    }
+
+    size_type size() const noexcept { return heap.size(); }
+
+    size_type capacity() const noexcept { return k; }
+
+    bool empty() const noexcept { return heap.size() == 0; }
+
+    /**
+     * the smallest kept value, i.e. what a new value has to beat once full
+     */
+    const value_type& threshold() const {
+        assert(heap.size());
+        return heap[0];
+    }
+
+    void clear() {
+        ministl::vector<T> tmp;
+        heap.swap(tmp);
+    }
+
+    /**
+     * kept values, greatest first
+     */
+    ministl::vector<T> sorted() const {
+        auto res = heap;
+        ministl::sort_heap(res.begin(), res.end(), heap_cmp);
+        return res;
+    }
+
+    /**
+     * kept values in heap order
+     */
+    const ministl::vector<T>& values() const noexcept { return heap; }
+};
+
+}
@@ -2,6 +2,7 @@
 #include <ministl/log.h>
 #include <ministl/reverse_iterator.h>
 #include <ministl/algorithm.h>
+#include <ministl/allocator.h>
 #include <cstdlib>
 #include <cstdint>
 #include <algorithm>
@@ -13,7 +14,7 @@
 namespace ministl
 {
 
-template <typename T>
+template <typename T, typename Alloc = ministl::default_allocator>
 class vector {
 public:
     using value_type = T;
@@ -31,26 +32,30 @@ private:
 
     constexpr static size_type value_size = sizeof (T);
 
-    void release_vector(pointer& begin_pointer, pointer& end_pointer) {
+    static iterator allocate(size_type n) {
+        return reinterpret_cast<iterator>(Alloc::allocate(value_size * n));
+    }
+
+    void release_vector(pointer& begin_pointer, pointer& end_pointer, size_type cap) {
         // destruct object
         for (pointer cur = begin_pointer; cur != end_pointer; cur ++ )
             cur->~T();
         // release memory
-        byte *raw = reinterpret_cast<byte *>(begin_pointer);
-        ::delete[] raw;
+        if (begin_pointer) Alloc::deallocate(begin_pointer, value_size * cap);
         begin_pointer = end_pointer = nullptr;
     }
 
     void grow() {
         auto old_begin = begin_iter, old_end = end_iter;
-        auto old_size = size();
+        auto old_size = size(), old_capacity = capacity;
         capacity <<= 1;
-        begin_iter = reinterpret_cast<iterator>(::new byte[value_size * capacity]);
+        begin_iter = allocate(capacity);
         end_iter = begin_iter + old_size;
+        // the new buffer is raw memory, move construct instead of move assign
         for (int i = 0; i < old_size; i ++ ) {
-            begin_iter[i] = std::move(old_begin[i]);
+            ::new (begin_iter + i) T(std::move(old_begin[i]));
         }
-        release_vector(old_begin, old_end);
+        release_vector(old_begin, old_end, old_capacity);
     }
 
 public:
@@ -61,11 +66,11 @@ public:
 
     vector(size_type n) :
         capacity(std::max(min_capacity, n)),
-        begin_iter(reinterpret_cast<iterator>(::new byte[value_size * capacity])),
+        begin_iter(allocate(capacity)),
         end_iter(begin_iter + n) {}
 
     vector(size_type n, const value_type& init_val) : vector(n) {
-        for (int i = 0; i < n; i ++ ) begin_iter[i] = init_val;
+        Alloc::uninitialized_fill(begin_iter, n, init_val);
     }
 
     vector(iterator first, iterator second) : 
@@ -83,7 +88,7 @@ public:
         }
     }
 
-    vector(const vector& rhs) : vector(rhs.capacity) {
+    vector(const vector& rhs) : vector(rhs.size()) {
         assert(size() == rhs.size());
         auto n = size();
         for (int i = 0; i < n; i ++ ) begin_iter[i] = rhs.begin_iter[i];
@@ -94,9 +99,9 @@ public:
      */
     vector& operator=(const vector& rhs) {
         if (this == &rhs) return *this;
-        release_vector(begin_iter, end_iter);
+        release_vector(begin_iter, end_iter, capacity);
         capacity = rhs.capacity;
-        begin_iter = reinterpret_cast<iterator>(::new byte[rhs.capacity * value_size]);
+        begin_iter = allocate(capacity);
         end_iter = begin_iter + rhs.size();
         auto n = size();
         for (int i = 0; i < n; i ++ ) begin_iter[i] = rhs.begin_iter[i];
@@ -104,9 +109,9 @@ public:
     }
 
     vector& operator=(const std::initializer_list<value_type>& list) {
-        release_vector(begin_iter, end_iter);
+        release_vector(begin_iter, end_iter, capacity);
         capacity = std::max(min_capacity, list.size());
-        begin_iter = reinterpret_cast<iterator>(::new byte[capacity * value_size]);
+        begin_iter = allocate(capacity);
         end_iter = begin_iter + list.size();
         auto n = size(), i = 0;
         for (auto val : list) begin_iter[i ++ ] = val;
@@ -120,7 +125,7 @@ public:
 
     vector& operator=(vector&& rhs) {
         assert(this != &rhs);
-        release_vector(begin_iter, end_iter);
+        release_vector(begin_iter, end_iter, capacity);
         capacity = rhs.capacity;
         begin_iter = rhs.begin_iter;
         end_iter = rhs.end_iter;
@@ -131,7 +136,7 @@ public:
 
     ~vector() {
         try {
-            release_vector(begin_iter, end_iter);
+            release_vector(begin_iter, end_iter, capacity);
         } catch (const std::exception& err) {
             debug(err.what());
             std::abort();
@@ -171,7 +176,7 @@ public:
         return (end_iter - begin_iter);
     }
 
-    bool empty() noexcept {
+    bool empty() const noexcept {
         return begin_iter == end_iter;
     }
 
@@ -248,24 +253,24 @@ public:
     }
 };
 
-template<typename T>
-void vector<T>::push_back(const value_type& rhs) {
+template<typename T, typename Alloc>
+void vector<T, Alloc>::push_back(const value_type& rhs) {
     if (size() >= capacity) [[unlikely]] { 
         grow();
     }
-    *end_iter = rhs;
+    ::new (end_iter) value_type(rhs);
     end_iter ++ ;
 }
 
-template<typename T>
-void vector<T>::push_back(value_type&& rhs) {
+template<typename T, typename Alloc>
+void vector<T, Alloc>::push_back(value_type&& rhs) {
     // TODO: use ministl:move
     emplace_back(std::move(rhs));
 }
 
-template<typename T>
+template<typename T, typename Alloc>
 template<typename... Args>
-void vector<T>::emplace_back(Args&&... args) {
+void vector<T, Alloc>::emplace_back(Args&&... args) {
     if (size() >= capacity) [[unlikely]] {
         grow();
     }
@@ -274,10 +279,10 @@ void vector<T>::emplace_back(Args&&... args) {
     end_iter ++ ;
 }
 
-template<typename T>
-void vector<T>::assign(size_type n, const value_type &val) {
+template<typename T, typename Alloc>
+void vector<T, Alloc>::assign(size_type n, const value_type &val) {
     if (n > capacity) {
-        auto tmp = vector<T> (n, val);
+        auto tmp = vector (n, val);
         swap(tmp);
     } else {
         auto new_end_iter = begin_iter + n;
@@ -287,9 +292,9 @@ void vector<T>::assign(size_type n, const value_type &val) {
     } 
 }
 
-template<typename T>
+template<typename T, typename Alloc>
 template<typename... Args>
-void vector<T>::emplace(const iterator iter, Args&&... args) {
+void vector<T, Alloc>::emplace(const iterator iter, Args&&... args) {
     // FIXME: need to find target position first
     auto offset = ministl::distance(begin_iter, iter);
     if (size() >= capacity) [[unlikely]] {
@@ -9,6 +9,48 @@ int main() {
     auto [it_traits_score, it_trais_full_score] = iterator_traits_test();
     assert(it_traits_score == it_trais_full_score);
 
+    auto [str_score, str_full_score] = string_test();
+    assert(str_score == str_full_score);
+
+    auto [algo_score, algo_full_score] = algorithm_test();
+    assert(algo_score == algo_full_score);
+
+    auto [list_score, list_full_score] = list_test();
+    assert(list_score == list_full_score);
+
+    auto [log_score, log_full_score] = log_test();
+    assert(log_score == log_full_score);
+
+    auto [perf_score, perf_full_score] = perf_test();
+    assert(perf_score == perf_full_score);
+
+    auto [pvec_score, pvec_full_score] = persistent_vector_test();
+    assert(pvec_score == pvec_full_score);
+
+    auto [ivec_score, ivec_full_score] = inplace_vector_test();
+    assert(ivec_score == ivec_full_score);
+
+    auto [packed_score, packed_full_score] = packed_vector_test();
+    assert(packed_score == packed_full_score);
+
+    auto [chm_score, chm_full_score] = concurrent_hash_map_test();
+    assert(chm_score == chm_full_score);
+
+    auto [external_score, external_full_score] = external_sort_test();
+    assert(external_score == external_full_score);
+
+    auto [numeric_score, numeric_full_score] = numeric_test();
+    assert(numeric_score == numeric_full_score);
+
+    auto [deque_score, deque_full_score] = deque_test();
+    assert(deque_score == deque_full_score);
+
+    auto [cache_score, cache_full_score] = lru_cache_test();
+    assert(cache_score == cache_full_score);
+
+    auto [filter_score, filter_full_score] = filter_test();
+    assert(filter_score == filter_full_score);
+
     debug("Pass All Test :)");
     return 0;
 }
@@ -0,0 +1,623 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ministl/algorithm.h>
+#include <ministl/functional.h>
+#include <ministl/list.h>
+#include <ministl/parallel_algorithm.h>
+#include <ministl/reverse_iterator.h>
+#include <ministl/sort_by_key.h>
+#include <ministl/sort_small.h>
+#include <ministl/top_k.h>
+#include <ministl/vector.h>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <ministl/test.h>
+
+static ministl::vector<int> random_vector(int n, int range) {
+    ministl::vector<int> vec;
+    for (int i = 0; i < n; i ++ ) vec.push_back(std::rand() % range);
+    return vec;
+}
+
+static test_result test_heap() {
+    int score = 0, full_score = 0;
+    auto vec = random_vector(1000, 100);
+    ministl::make_heap(vec.begin(), vec.end());
+    for (int i = 1; i < vec.size(); i ++ ) {
+        assert(!(vec[(i - 1) / 2] < vec[i]));
+    }
+    ministl::sort_heap(vec.begin(), vec.end());
+    for (int i = 1; i < vec.size(); i ++ ) {
+        assert(vec[i - 1] <= vec[i]);
+    }
+    score ++ , full_score ++ ;
+    return {score, full_score};
+}
+
+static test_result test_nth_element() {
+    int score = 0, full_score = 0;
+    for (int n : {1, 2, 17, 100, 1000, 5000}) {
+        for (int range : {3, 1000000}) {
+            auto vec = random_vector(n, range);
+            auto sorted = vec;
+            ministl::partial_sort(sorted.begin(), sorted.end(), sorted.end());
+            for (int k : {0, n / 2, n * 99 / 100, n - 1}) {
+                auto cur = vec;
+                ministl::nth_element(cur.begin(), cur.begin() + k, cur.end());
+                assert(cur[k] == sorted[k]);
+                for (int i = 0; i < k; i ++ ) assert(!(cur[k] < cur[i]));
+                for (int i = k + 1; i < n; i ++ ) assert(!(cur[i] < cur[k]));
+            }
+            score ++ , full_score ++ ;
+        }
+    }
+
+    { // median of medians on its own
+        auto vec = random_vector(3000, 50);
+        auto sorted = vec;
+        ministl::partial_sort(sorted.begin(), sorted.end(), sorted.end());
+        ministl::select_median_of_medians(vec.begin(), vec.begin() + 1234, vec.end(), ministl::less<> {});
+        assert(vec[1234] == sorted[1234]);
+        score ++ , full_score ++ ;
+    }
+
+    { // sorted and reversed inputs
+        ministl::vector<int> vec;
+        for (int i = 0; i < 4096; i ++ ) vec.push_back(i);
+        ministl::nth_element(vec.begin(), vec.begin() + 100, vec.end(), ministl::greater<> {});
+        assert(vec[100] == 4095 - 100);
+        score ++ , full_score ++ ;
+    }
+
+    return {score, full_score};
+}
+
+static test_result test_partial_sort() {
+    int score = 0, full_score = 0;
+    auto vec = random_vector(500, 1000);
+    auto sorted = vec;
+    ministl::sort(sorted.begin(), sorted.end());
+
+    auto cur = vec;
+    ministl::partial_sort(cur.begin(), cur.begin() + 10, cur.end());
+    for (int i = 0; i < 10; i ++ ) assert(cur[i] == sorted[i]);
+    score ++ , full_score ++ ;
+
+    ministl::vector<int> out(20, 0);
+    auto out_end = ministl::partial_sort_copy(vec.begin(), vec.end(), out.begin(), out.end());
+    assert(out_end == out.end());
+    for (int i = 0; i < 20; i ++ ) assert(out[i] == sorted[i]);
+    score ++ , full_score ++ ;
+
+    ministl::vector<int> big(1000, 0);
+    out_end = ministl::partial_sort_copy(vec.begin(), vec.end(), big.begin(), big.end());
+    assert(out_end == big.begin() + 500);
+    for (int i = 0; i < 500; i ++ ) assert(big[i] == sorted[i]);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_top_k() {
+    int score = 0, full_score = 0;
+    auto vec = random_vector(10000, 1000000);
+    auto sorted = vec;
+    ministl::sort(sorted.begin(), sorted.end());
+
+    ministl::top_k<int> acc(16);
+    acc.push(vec.begin(), vec.end());
+    assert(acc.size() == 16 && acc.threshold() == sorted[10000 - 16]);
+    auto res = acc.sorted();
+    for (int i = 0; i < 16; i ++ ) assert(res[i] == sorted[10000 - 1 - i]);
+    score ++ , full_score ++ ;
+
+    ministl::top_k<int, ministl::greater<int>> smallest(3);
+    smallest.push(vec.begin(), vec.end());
+    res = smallest.sorted();
+    for (int i = 0; i < 3; i ++ ) assert(res[i] == sorted[i]);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+struct keyed {
+    int key, seq;
+};
+
+static bool keyed_less(const keyed& a, const keyed& b) {
+    return a.key < b.key;
+}
+
+static bool is_stably_sorted(const ministl::vector<keyed>& vec) {
+    for (int i = 1; i < vec.size(); i ++ ) {
+        if (vec[i].key < vec[i - 1].key) return false;
+        if (vec[i].key == vec[i - 1].key && vec[i].seq < vec[i - 1].seq) return false;
+    }
+    return true;
+}
+
+static ministl::vector<keyed> keyed_vector(int n, int range, int pattern) {
+    ministl::vector<keyed> vec;
+    for (int i = 0; i < n; i ++ ) {
+        switch (pattern) {
+            case 0: // random
+                vec.push_back({std::rand() % range, i});
+                break;
+            case 1: // ascending with noise
+                vec.push_back({i / 3 + (std::rand() % 8 == 0 ? std::rand() % range : 0), i});
+                break;
+            case 2: // descending runs
+                vec.push_back({(n - i) % (range + 1), i});
+                break;
+        }
+    }
+    return vec;
+}
+
+// movable only; counts live objects and can make the n-th move throw
+struct tracked {
+    int value;
+    static inline long long live = 0;
+    static inline int throw_after = -1;
+
+    explicit tracked(int value) : value(value) { live ++ ; }
+
+    tracked(tracked&& rhs) : value(rhs.value) {
+        if (throw_after >= 0 && throw_after -- == 0) throw std::runtime_error("move");
+        live ++ ;
+    }
+
+    tracked& operator=(tracked&& rhs) noexcept {
+        value = rhs.value;
+        return *this;
+    }
+
+    ~tracked() { live -- ; }
+};
+
+static test_result test_stable_sort() {
+    int score = 0, full_score = 0;
+    for (int n : {0, 1, 5, 63, 64, 65, 1000, 20000}) {
+        for (int pattern = 0; pattern < 3; pattern ++ ) {
+            auto vec = keyed_vector(n, 50, pattern);
+            ministl::stable_sort(vec.begin(), vec.end(), keyed_less);
+            assert(is_stably_sorted(vec) && vec.size() == n);
+            score ++ , full_score ++ ;
+        }
+    }
+
+    { // caller supplied buffers, including none at all
+        ministl::vector<keyed> buffer(64, {0, 0});
+        for (size_t buffer_size : {size_t(0), size_t(3), size_t(64)}) {
+            for (int round = 0; round < 3; round ++ ) {
+                auto vec = keyed_vector(5000, 100, round);
+                ministl::stable_sort(vec.begin(), vec.end(), buffer.begin(), buffer_size, keyed_less);
+                assert(is_stably_sorted(vec));
+            }
+            score ++ , full_score ++ ;
+        }
+    }
+
+    { // default comparator
+        auto vec = random_vector(3000, 10);
+        ministl::stable_sort(vec.begin(), vec.end());
+        for (int i = 1; i < vec.size(); i ++ ) assert(vec[i - 1] <= vec[i]);
+        score ++ , full_score ++ ;
+    }
+
+    { // move only elements, and a move that throws while the scratch buffer is built
+        int n = 2000;
+        ministl::vector<tracked> items;
+        for (int i = 0; i < n; i ++ ) items.push_back(tracked(std::rand() % 100));
+        auto live = tracked::live;
+        auto by_value = [](const tracked& a, const tracked& b) { return a.value < b.value; };
+        ministl::stable_sort(items.begin(), items.end(), by_value);
+        for (int i = 1; i < n; i ++ ) assert(items[i - 1].value <= items[i].value);
+        ministl::inplace_merge(items.begin(), items.begin() + n / 2, items.end(), by_value);
+        assert(tracked::live == live);
+
+        tracked::throw_after = 10;
+        bool thrown = false;
+        try {
+            ministl::stable_sort(items.begin(), items.end(), by_value);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        tracked::throw_after = -1;
+        assert(thrown && tracked::live == live && items.size() == size_t(n));
+        for (int i = 1; i < n; i ++ ) assert(items[i - 1].value <= items[i].value);
+        score ++ , full_score ++ ;
+    }
+
+    return {score, full_score};
+}
+
+static test_result test_merge() {
+    int score = 0, full_score = 0;
+    ministl::vector<keyed> a, b;
+    for (int i = 0; i < 100; i ++ ) a.push_back({i / 2, i});
+    for (int i = 0; i < 77; i ++ ) b.push_back({i / 3, 100 + i});
+
+    ministl::vector<keyed> out(177, {0, 0});
+    auto out_end = ministl::merge(a.begin(), a.end(), b.begin(), b.end(), out.begin(), keyed_less);
+    assert(out_end == out.end() && is_stably_sorted(out));
+    score ++ , full_score ++ ;
+
+    ministl::vector<keyed> joined(a.begin(), a.end());
+    for (int i = 0; i < b.size(); i ++ ) joined.push_back(b[i]);
+    ministl::inplace_merge(joined.begin(), joined.begin() + 100, joined.end(), keyed_less);
+    assert(is_stably_sorted(joined));
+    score ++ , full_score ++ ;
+
+    ministl::vector<int> x = {1, 3, 5, 7, 2, 4, 6};
+    ministl::inplace_merge(x.begin(), x.begin() + 4, x.end());
+    assert((x == ministl::vector<int> {1, 2, 3, 4, 5, 6, 7}));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_parallel_stable_sort() {
+    int score = 0, full_score = 0;
+    int n = 300000;
+
+    auto vec = keyed_vector(n, 1000, 0);
+    ministl::parallel_stable_sort(vec.begin(), vec.end(), keyed_less, 4);
+    assert(is_stably_sorted(vec) && vec.size() == n);
+    score ++ , full_score ++ ;
+
+    auto a = keyed_vector(n / 2, 1000, 0), b = keyed_vector(n / 3, 1000, 0);
+    for (int i = 0; i < b.size(); i ++ ) b[i].seq += n;
+    ministl::stable_sort(a.begin(), a.end(), keyed_less);
+    ministl::stable_sort(b.begin(), b.end(), keyed_less);
+    ministl::vector<keyed> out(a.size() + b.size(), {0, 0});
+    ministl::parallel_merge(a.begin(), a.end(), b.begin(), b.end(), out.begin(), keyed_less, 3);
+    assert(is_stably_sorted(out));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+// a wide record that counts how often it is moved or copied
+struct wide_record {
+    int key, seq;
+    char payload[192];
+
+    static inline long long transfers = 0;
+
+    wide_record(int key = 0, int seq = 0) : key(key), seq(seq) { payload[0] = char(seq); }
+
+    wide_record(const wide_record& rhs) { *this = rhs; }
+
+    wide_record& operator=(const wide_record& rhs) {
+        key = rhs.key, seq = rhs.seq;
+        std::memcpy(payload, rhs.payload, sizeof (payload));
+        transfers ++ ;
+        return *this;
+    }
+};
+
+static test_result test_sort_by_key() {
+    int score = 0, full_score = 0;
+    int n = 5000;
+    ministl::vector<wide_record> records;
+    for (int i = 0; i < n; i ++ ) records.push_back(wide_record(std::rand() % 100, i));
+    auto original = records;
+
+    auto perm = ministl::argsort(records.begin(), records.end(), [](const wide_record& r) { return r.key; });
+    assert(perm.size() == n);
+    for (int i = 1; i < n; i ++ ) {
+        auto& prev = records[perm[i - 1]];
+        auto& cur = records[perm[i]];
+        assert(prev.key < cur.key || (prev.key == cur.key && prev.seq < cur.seq));
+    }
+    score ++ , full_score ++ ;
+
+    // every record moves about once, plus one per permutation cycle
+    wide_record::transfers = 0;
+    ministl::sort_by_key(records.begin(), records.end(), [](const wide_record& r) { return r.key; });
+    assert(wide_record::transfers <= n + n / 2);
+    for (int i = 0; i < n; i ++ ) {
+        assert(records[i].seq == original[perm[i]].seq && records[i].payload[0] == char(records[i].seq));
+    }
+    score ++ , full_score ++ ;
+
+    auto again = original;
+    ministl::apply_permutation(again.begin(), perm);
+    for (int i = 0; i < n; i ++ ) assert(again[i].seq == records[i].seq);
+    score ++ , full_score ++ ;
+
+    // custom order on a non-trivial key
+    ministl::vector<int> values = {5, 3, 9, 1, 7};
+    ministl::sort_by_key(values.begin(), values.end(), [](int x) { return -x; }, ministl::less<> {});
+    assert((values == ministl::vector<int> {9, 7, 5, 3, 1}));
+    ministl::sort_by_key(values.begin(), values.end(), [](int x) { return x; }, ministl::greater<> {});
+    assert((values == ministl::vector<int> {9, 7, 5, 3, 1}));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+// sorted random uint32 values; distinct ones when dups is false
+static ministl::vector<uint32_t> sorted_u32(int n, uint32_t range, bool dups) {
+    ministl::vector<uint32_t> vec;
+    for (int i = 0; i < n; i ++ ) vec.push_back(uint32_t(std::rand()) % range);
+    ministl::stable_sort(vec.begin(), vec.end());
+    if (!dups) {
+        auto end = ministl::unique(vec.begin(), vec.end());
+        while (vec.end() != end) vec.pop_back();
+    }
+    return vec;
+}
+
+static test_result test_set_operations() {
+    int score = 0, full_score = 0;
+    ministl::vector<int> x = {1, 1, 2, 2, 2, 3, 1, 1};
+    auto end = ministl::unique(x.begin(), x.end());
+    assert(end - x.begin() == 4 && x[0] == 1 && x[1] == 2 && x[2] == 3 && x[3] == 1);
+    score ++ , full_score ++ ;
+
+    // against std on simd sized, skewed (galloping) and duplicate heavy inputs
+    struct shape {
+        int n1, n2;
+        uint32_t range;
+        bool dups;
+    };
+    for (auto [n1, n2, range, dups] : {shape {5000, 4000, 20000, false}, shape {3, 9000, 20000, false},
+            shape {9000, 50, 20000, false}, shape {3000, 3000, 500, true}, shape {0, 100, 100, false},
+            shape {7, 5, 10, false}}) {
+        auto a = sorted_u32(n1, range, dups), b = sorted_u32(n2, range, dups);
+        std::vector<uint32_t> expect;
+        ministl::vector<uint32_t> out(a.size() + b.size());
+
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+        auto out_end = ministl::set_intersection(a.begin(), a.end(), b.begin(), b.end(), out.begin());
+        assert(size_t(out_end - out.begin()) == expect.size());
+        assert(ministl::equal(expect.begin(), expect.end(), out.begin()));
+        assert(ministl::set_intersection_size(a.begin(), a.end(), b.begin(), b.end()) == expect.size());
+        assert(ministl::set_intersection_size(b.begin(), b.end(), a.begin(), a.end()) == expect.size());
+
+        expect.clear();
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+        out_end = ministl::set_union(a.begin(), a.end(), b.begin(), b.end(), out.begin());
+        assert(size_t(out_end - out.begin()) == expect.size());
+        assert(ministl::equal(expect.begin(), expect.end(), out.begin()));
+        assert(ministl::set_union_size(a.begin(), a.end(), b.begin(), b.end()) == expect.size());
+
+        expect.clear();
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect));
+        out_end = ministl::set_difference(a.begin(), a.end(), b.begin(), b.end(), out.begin());
+        assert(size_t(out_end - out.begin()) == expect.size());
+        assert(ministl::equal(expect.begin(), expect.end(), out.begin()));
+        assert(ministl::set_difference_size(b.begin(), b.end(), a.begin(), a.end()) ==
+                size_t(std::set_difference(b.begin(), b.end(), a.begin(), a.end(), out.begin()) - out.begin()));
+
+        assert(ministl::includes(a.begin(), a.end(), b.begin(), b.end()) ==
+                std::includes(a.begin(), a.end(), b.begin(), b.end()));
+        score ++ , full_score ++ ;
+    }
+
+    { // includes of a real subset, and a custom order
+        auto a = sorted_u32(5000, 100000, false);
+        ministl::vector<uint32_t> sub;
+        for (size_t i = 0; i < a.size(); i += 97) sub.push_back(a[i]);
+        assert(ministl::includes(a.begin(), a.end(), sub.begin(), sub.end()));
+        sub.push_back(200000);
+        assert(!ministl::includes(a.begin(), a.end(), sub.begin(), sub.end()));
+
+        ministl::vector<int> p = {9, 7, 5, 3}, q = {8, 7, 3, 1};
+        ministl::vector<int> r(4);
+        auto r_end = ministl::set_intersection(p.begin(), p.end(), q.begin(), q.end(), r.begin(), ministl::greater<> {});
+        assert(r_end - r.begin() == 2 && r[0] == 7 && r[1] == 3);
+        score ++ , full_score ++ ;
+    }
+
+    return {score, full_score};
+}
+
+// a class iterator over contiguous memory, like a checked iterator
+struct span_iterator {
+    using iterator_category = ministl::random_access_iterator_tag;
+    using iterator_concept = ministl::contiguous_iterator_tag;
+    using value_type = int;
+    using pointer = int*;
+    using reference = int&;
+    using difference_type = ptrdiff_t;
+
+    int* ptr;
+
+    int& operator*() const { return *ptr; }
+    int* operator->() const { return ptr; }
+    span_iterator& operator++() { ++ ptr; return *this; }
+    span_iterator operator+(ptrdiff_t n) const { return {ptr + n}; }
+    ptrdiff_t operator-(const span_iterator& rhs) const { return ptr - rhs.ptr; }
+    bool operator==(const span_iterator& rhs) const { return ptr == rhs.ptr; }
+};
+
+static test_result test_contiguous_unwrap() {
+    int score = 0, full_score = 0;
+    static_assert(ministl::contiguous_iterator<int*> && ministl::contiguous_iterator<span_iterator>);
+    static_assert(!ministl::contiguous_iterator<ministl::reverse_iterator<int*>>);
+    static_assert(ministl::is_random_access_iterator<ministl::reverse_iterator<int*>>::value);
+
+    // the simd paths of every element size, with tails, both directions
+    for (int n : {0, 1, 15, 64, 100, 1001}) {
+        ministl::vector<uint16_t> small;
+        ministl::vector<int> mid;
+        ministl::vector<int64_t> wide;
+        for (int i = 0; i < n; i ++ ) small.push_back(uint16_t(i % 7)), mid.push_back(i % 7), wide.push_back(i % 7);
+        std::vector<int> expect(mid.begin(), mid.end());
+
+        auto hit = ministl::find(mid.rbegin(), mid.rend(), 3);
+        auto std_hit = std::find(expect.rbegin(), expect.rend(), 3);
+        assert(hit - mid.rbegin() == std_hit - expect.rbegin());
+        assert(ministl::find(small.rbegin(), small.rend(), 3) - small.rbegin() == std_hit - expect.rbegin());
+        assert(ministl::find(wide.rbegin(), wide.rend(), 3) - wide.rbegin() == std_hit - expect.rbegin());
+        assert(ministl::find(wide.begin(), wide.end(), 6) - wide.begin() ==
+                std::find(expect.begin(), expect.end(), 6) - expect.begin());
+        assert(ministl::find_last(small.begin(), small.end(), 9) == small.end());
+        assert(ministl::find(small.begin(), small.end(), -1) == small.end());
+
+        ministl::reverse(mid.begin(), mid.end());
+        ministl::reverse(small.rbegin(), small.rend());
+        std::reverse(expect.begin(), expect.end());
+        for (int i = 0; i < n; i ++ ) assert(mid[i] == expect[i] && small[i] == expect[i]);
+        score ++ , full_score ++ ;
+    }
+
+    // mixed signedness compares after promotion, like the element loop and std::find
+    {
+        uint16_t u16[40] = {};
+        int16_t s16[40] = {};
+        uint8_t u8[40] = {};
+        int8_t s8[40] = {};
+        u16[30] = 0xffff, s16[30] = -1, u8[30] = 0xff, s8[30] = -1;
+        assert(ministl::find(u16, u16 + 40, short(-1)) == u16 + 40 && ministl::find_last(u16, u16 + 40, short(-1)) == u16 + 40);
+        assert(ministl::find(s16, s16 + 40, uint16_t(0xffff)) == s16 + 40 && ministl::find_last(s16, s16 + 40, uint16_t(0xffff)) == s16 + 40);
+        assert(ministl::find(u8, u8 + 40, char(-1)) == u8 + 40 && ministl::find_last(u8, u8 + 40, int8_t(-1)) == u8 + 40);
+        assert(ministl::find(s8, s8 + 40, uint8_t(0xff)) == s8 + 40 && ministl::find_last(s8, s8 + 40, uint8_t(0xff)) == s8 + 40);
+        assert(ministl::find(u16, u16 + 40, uint16_t(0xffff)) == u16 + 30 && ministl::find_last(s16, s16 + 40, short(-1)) == s16 + 30);
+        assert(ministl::find(u8, u8 + 40, 255) == u8 + 30 && ministl::find_last(s8, s8 + 40, -1) == s8 + 30);
+        assert(ministl::find(u16, u16 + 40, short(-1)) - u16 == std::find(u16, u16 + 40, short(-1)) - u16);
+        score ++ , full_score ++ ;
+    }
+
+    ministl::vector<int> vec = random_vector(3000, 100);
+    std::vector<int> expect(vec.begin(), vec.end());
+    ministl::sort(vec.rbegin(), vec.rend());
+    std::sort(expect.rbegin(), expect.rend());
+    assert(ministl::equal(expect.begin(), expect.end(), vec.begin()));
+    auto rit = vec.rbegin();
+    assert(rit[10] == *(rit + 10) && (rit + 10) - rit == 10 && rit < rit + 1 && (3 + rit) - 3 == rit);
+    score ++ , full_score ++ ;
+
+    // a wrapped range, forwards and through reverse_iterator
+    span_iterator first {vec.begin()}, last {vec.end()};
+    ministl::reverse_iterator<span_iterator> rfirst(last), rlast(first);
+    ministl::fill(first, first + 5, -1);
+    ministl::fill(first + 5, last, 7);
+    assert(ministl::find(first, last, 7) - first == 5 && ministl::find_last(first, last, -1) - first == 4);
+    ministl::reverse(rfirst, rlast);
+    assert(vec[0] == 7 && vec[2994] == 7 && vec[2995] == -1);
+    assert(ministl::find(rfirst, rlast, 7).base() - first == 2995);
+    ministl::fill(vec.rbegin(), vec.rend(), 1);
+    ministl::sort(first, last);
+    assert(ministl::find(vec.begin(), vec.end(), 2) == vec.end() && vec[0] == 1 && vec[2999] == 1);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+template<typename T, typename Compare>
+static bool check_sort_many(size_t segment, size_t count, Compare cmp) {
+    ministl::vector<T> keys;
+    for (size_t i = 0; i < segment * count; i ++ ) keys.push_back(T(std::rand() % 1000) - T(300));
+    std::vector<T> expect(keys.begin(), keys.end());
+    for (size_t s = 0; s < count; s ++ ) std::sort(expect.begin() + s * segment, expect.begin() + (s + 1) * segment, cmp);
+    ministl::sort_many(keys.begin(), keys.end(), segment, cmp);
+    return ministl::equal(expect.begin(), expect.end(), keys.begin());
+}
+
+static test_result test_lexicographical_compare() {
+    int score = 0, full_score = 0;
+    // memcmp orders bytes as unsigned: signed and plain char ranges must agree with std
+    int8_t neg[] = {-1, 5}, pos[] = {1, 5};
+    char char_neg[] = {-1, 'a'}, char_pos[] = {1, 'a'};
+    unsigned char high[] = {0xff, 0}, low[] = {1, 0};
+    assert(ministl::lexicographical_compare(neg, neg + 2, pos, pos + 2));
+    assert(!ministl::lexicographical_compare(pos, pos + 2, neg, neg + 2));
+    assert(ministl::lexicographical_compare(char_neg, char_neg + 2, char_pos, char_pos + 2) ==
+            std::lexicographical_compare(char_neg, char_neg + 2, char_pos, char_pos + 2));
+    assert(ministl::lexicographical_compare(low, low + 2, high, high + 2));
+    assert(ministl::lexicographical_compare_three_way(high, high + 2, high, high + 1) > 0);
+    score ++ , full_score ++ ;
+
+    // pointers and other iterators over the same chars order alike
+    ministl::list<char> list_neg = {char(-1), 'a'}, list_pos = {char(1), 'a'};
+    assert(ministl::lexicographical_compare(list_neg.begin(), list_neg.end(), list_pos.begin(), list_pos.end()) ==
+            ministl::lexicographical_compare(char_neg, char_neg + 2, char_pos, char_pos + 2));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_sort_small() {
+    int score = 0, full_score = 0;
+    // every size the networks cover, and the fallback beyond
+    for (int n = 0; n <= 70; n ++ ) {
+        auto vec = random_vector(n, n / 2 + 1);
+        std::vector<int> expect(vec.begin(), vec.end());
+        std::sort(expect.begin(), expect.end());
+        ministl::sort_small(vec.begin(), vec.end());
+        assert(ministl::equal(expect.begin(), expect.end(), vec.begin()));
+
+        ministl::vector<std::string> names;
+        for (int i = 0; i < n; i ++ ) names.push_back(std::to_string(std::rand() % 100));
+        std::vector<std::string> expect_names(names.begin(), names.end());
+        std::sort(expect_names.begin(), expect_names.end(), std::greater<> {});
+        ministl::sort_small(names.begin(), names.end(), ministl::greater<> {});
+        assert(ministl::equal(expect_names.begin(), expect_names.end(), names.begin()));
+    }
+    score ++ , full_score ++ ;
+
+    // simd columns with leftover segments, every key type, both orders, and a custom order
+    for (size_t segment : {2, 3, 8, 13, 16, 33, 64, 65}) {
+        assert(check_sort_many<int32_t>(segment, 37, ministl::less<> {}));
+        assert(check_sort_many<uint32_t>(segment, 20, ministl::greater<uint32_t> {}));
+        assert(check_sort_many<float>(segment, 17, ministl::less<float> {}));
+        assert(check_sort_many<double>(segment, 9, ministl::greater<> {}));
+        assert(check_sort_many<int64_t>(segment, 11, ministl::less<> {}));
+        assert(check_sort_many<uint64_t>(segment, 8, ministl::less<> {}));
+        assert(check_sort_many<int>(segment, 5, [](int a, int b) { return a % 10 < b % 10 || (a % 10 == b % 10 && a < b); }));
+    }
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result algorithm_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_heap();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_nth_element();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_partial_sort();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_top_k();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_stable_sort();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_merge();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_parallel_stable_sort();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_sort_by_key();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_set_operations();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_contiguous_unwrap();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_lexicographical_compare();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_sort_small();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
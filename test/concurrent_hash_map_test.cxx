@@ -0,0 +1,183 @@
+#include <cassert>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <ministl/concurrent_hash_map.h>
+#include <ministl/vector.h>
+#include <ministl/test.h>
+
+static test_result test_map_basic() {
+    int score = 0, full_score = 0;
+    ministl::concurrent_hash_map<int, int> map(4);
+    assert(map.empty() && map.shard_count() == 4);
+    assert(map.insert(1, 10) && !map.insert(1, 11));
+    int val = 0;
+    assert(map.find(1, val) && val == 10 && !map.find(2, val));
+    assert(!map.insert_or_assign(1, 12) && map.insert_or_assign(2, 20));
+    assert(map.find(1, val) && val == 12 && map.size() == 2);
+    score ++ , full_score ++ ;
+
+    // counters: insert the initial value, then update in place
+    for (int i = 0; i < 10; i ++ ) map.upsert(3, 1, [](int& cur) { cur ++ ; });
+    assert(map.find(3, val) && val == 10);
+    assert(map.erase(3) && !map.erase(3) && !map.contains(3));
+    score ++ , full_score ++ ;
+
+    // many incremental resizes, interleaved with erases
+    int n = 100000;
+    ministl::vector<int> erased(n, 0);
+    for (int i = 0; i < n; i ++ ) {
+        map.insert_or_assign(i, i * 2);
+        if (i % 3 == 0) map.erase(i / 2), erased[i / 2] = 1;
+    }
+    int present = 0;
+    for (int i = 0; i < n; i ++ ) {
+        if (map.find(i, val)) {
+            assert(!erased[i] && val == i * 2);
+            present ++ ;
+        } else {
+            assert(erased[i]);
+        }
+    }
+    assert(size_t(present) == map.size());
+    long long seen = 0;
+    map.for_each([&seen](int key, const int& value) { seen ++ ; assert(value == key * 2); });
+    assert(seen == present);
+    map.reclaim();
+    score ++ , full_score ++ ;
+
+    // a table at the edge of its load limit, then heavy erasing: the next table
+    // is small, and the inserts made while it drains the big one must still fit
+    ministl::concurrent_hash_map<int, int> one(1);
+    for (int i = 0; i < 3072; i ++ ) one.insert(i, i);
+    for (int i = 15; i < 3072; i ++ ) assert(one.erase(i));
+    for (int i = 3072; i < 6144; i ++ ) assert(one.insert(i, i));
+    assert(one.size() == 15 + 3072);
+    for (int i = 0; i < 6144; i ++ ) assert(one.find(i, val) == (i < 15 || i >= 3072));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+struct pair_value {
+    uint64_t a, b;
+};
+
+static test_result test_map_concurrent() {
+    int score = 0, full_score = 0;
+    ministl::concurrent_hash_map<uint64_t, pair_value> map(8);
+    const uint64_t keys = 5000;
+    for (uint64_t k = 0; k < keys; k ++ ) map.insert(k, {k, k * 2});
+
+    // writers keep b == 2 * a and grow the map; readers must never see a torn pair
+    std::atomic<bool> stop {false};
+    std::atomic<long long> torn {0}, missing {0};
+    ministl::vector<std::thread> readers, writers;
+    for (int t = 0; t < 3; t ++ ) {
+        readers.push_back(std::thread([&, t] {
+            uint64_t k = t;
+            while (!stop.load(std::memory_order_relaxed)) {
+                pair_value val;
+                if (!map.find(k % keys, val)) missing ++ ;
+                else if (val.b != val.a * 2) torn ++ ;
+                k += 7;
+            }
+        }));
+    }
+    for (int t = 0; t < 3; t ++ ) {
+        writers.push_back(std::thread([&, t] {
+            for (uint64_t i = 0; i < 20000; i ++ ) {
+                uint64_t k = (i * 13 + t) % keys;
+                map.upsert(k, {0, 0}, [i](pair_value& cur) { cur = {i, i * 2}; });
+                map.insert(keys + t * 20000 + i, {i, i * 2});
+            }
+        }));
+    }
+    // whole map rewrites in place race with the same readers
+    writers.push_back(std::thread([&] {
+        for (uint64_t r = 1; r <= 20; r ++ ) {
+            map.update_each([r](uint64_t, pair_value& cur) { cur.a += r, cur.b = cur.a * 2; });
+        }
+    }));
+    for (auto& w : writers) w.join();
+    stop = true;
+    for (auto& r : readers) r.join();
+    assert(torn == 0 && missing == 0);
+    assert(map.size() == keys + 3 * 20000);
+    score ++ , full_score ++ ;
+
+    // concurrent counting with upsert loses no increments
+    ministl::concurrent_hash_map<int, long long> counts;
+    ministl::vector<std::thread> counters;
+    for (int t = 0; t < 4; t ++ ) {
+        counters.push_back(std::thread([&counts] {
+            for (int i = 0; i < 10000; i ++ ) counts.upsert(i % 100, 1, [](long long& cur) { cur ++ ; });
+        }));
+    }
+    for (auto& c : counters) c.join();
+    long long total = 0;
+    counts.for_each([&total](int, const long long& cur) { total += cur; });
+    assert(total == 40000 && counts.size() == 100);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_map_reclaim() {
+    int score = 0, full_score = 0;
+    // churn at a steady size: every resize drains a table, and with no
+    // reader around the next write frees it, so at most one is ever kept
+    ministl::concurrent_hash_map<int, int> map(1);
+    const int live = 1000;
+    for (int i = 0; i < live; i ++ ) map.insert(i, i);
+    size_t most = 0;
+    for (int i = live; i < 200000; i ++ ) {
+        map.insert(i, i);
+        map.erase(i - live);
+        auto retired = map.retired_tables();
+        if (retired > most) most = retired;
+    }
+    assert(most <= 1 && map.size() == size_t(live));
+    score ++ , full_score ++ ;
+
+    // the same with readers: drained tables wait for a quiet moment, the
+    // readers never see a freed one, and nothing is left once they stop
+    std::atomic<bool> stop {false};
+    std::atomic<long long> wrong {0};
+    ministl::vector<std::thread> readers;
+    for (int t = 0; t < 2; t ++ ) {
+        readers.push_back(std::thread([&, t] {
+            int k = t, val = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (map.find(k, val) && val != k) wrong ++ ;
+                k = (k + 7) % 400000;
+            }
+        }));
+    }
+    for (int i = 200000; i < 400000; i ++ ) {
+        map.insert(i, i);
+        map.erase(i - live);
+    }
+    stop = true;
+    for (auto& r : readers) r.join();
+    map.insert(-1, -1);
+    assert(wrong == 0 && map.retired_tables() == 0);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result concurrent_hash_map_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_map_basic();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_map_concurrent();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_map_reclaim();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
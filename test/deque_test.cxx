@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <ministl/algorithm.h>
+#include <ministl/allocator.h>
+#include <ministl/deque.h>
+#include <ministl/iterator.h>
+#include <ministl/test.h>
+
+// default_allocator that counts calls and live bytes
+struct counting_allocator {
+    static inline size_t allocations = 0;
+    static inline size_t live_bytes = 0;
+
+    static void* allocate(size_t bytes) {
+        allocations ++ , live_bytes += bytes;
+        return ministl::default_allocator::allocate(bytes);
+    }
+
+    static void deallocate(void* ptr, size_t bytes) noexcept {
+        live_bytes -= bytes;
+        ministl::default_allocator::deallocate(ptr, bytes);
+    }
+};
+
+static test_result test_deque_basic() {
+    int score = 0, full_score = 0;
+    ministl::deque<int> dq = {2, 3};
+    dq.push_front(1);
+    dq.emplace_front(0);
+    dq.push_back(4);
+    assert(dq.size() == 5 && dq.front() == 0 && dq.back() == 4 && dq[2] == 2);
+    int expect = 0;
+    for (auto val : dq) assert(val == expect ++ );
+    for (auto it = dq.rbegin(); it != dq.rend(); it ++ ) assert(*it == -- expect);
+    score ++ , full_score ++ ;
+
+    dq.pop_front();
+    dq.pop_back();
+    assert((dq == ministl::deque<int> {1, 2, 3}));
+    auto copy = dq;
+    auto moved = std::move(dq);
+    assert(copy == moved && dq.empty());
+    bool thrown = false;
+    try {
+        copy.at(3);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_deque_iterator() {
+    int score = 0, full_score = 0;
+    using iterator = ministl::deque<int>::iterator;
+    static_assert(ministl::is_random_access_iterator<iterator>::value);
+    static_assert(ministl::is_random_access_iterator<ministl::deque<int>::const_iterator>::value);
+    static_assert(!ministl::is_contiguous_iterator<iterator>::value);
+
+    // grown at the front, so it spans several chunks and starts mid chunk
+    int n = 5 * ministl::deque<int>::chunk_size + 7;
+    ministl::deque<int> dq;
+    for (int i = n - 1; i >= 0; i -- ) dq.push_front(i);
+    auto it = dq.begin();
+    ministl::advance(it, n - 3);
+    assert(*it == n - 3 && ministl::distance(dq.begin(), it) == n - 3);
+    ministl::advance(it, -(n - 5));
+    assert(*it == 2 && it[n - 3] == n - 1 && *(it - 2) == 0);
+    assert(ministl::distance(dq.begin(), dq.end()) == n && dq.end() - it == n - 2);
+    assert(dq.begin() < it && it <= dq.end() && dq.end() > it);
+    ministl::deque<int>::const_iterator cit = it;
+    assert(cit == it && *(cit + 100) == 102);
+    for (int i = 0; i < n; i ++ ) assert(dq.begin()[i] == i && *(dq.end() - (n - i)) == i);
+    score ++ , full_score ++ ;
+
+    // generic algorithms through the random access iterators
+    for (int i = 0; i < n; i ++ ) dq[i] = std::rand() % 1000;
+    ministl::sort(dq.begin(), dq.end());
+    assert(std::is_sorted(dq.begin(), dq.end()));
+    ministl::reverse(dq.begin(), dq.end());
+    for (int i = 1; i < n; i ++ ) assert(dq[i - 1] >= dq[i]);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_deque_model() {
+    int score = 0, full_score = 0;
+    // random pushes and pops at both ends against std::deque, on a type that owns memory
+    ministl::deque<std::string> dq;
+    std::deque<std::string> model;
+    for (int round = 0; round < 200000; round ++ ) {
+        int op = std::rand() % 9;
+        if (op < 3) {
+            auto val = std::to_string(round) + std::string(round % 40, 'x');
+            dq.push_back(val), model.push_back(val);
+        } else if (op < 6) {
+            auto val = std::to_string(round);
+            dq.emplace_front(val), model.push_front(val);
+        } else if (op < 8 && !model.empty()) {
+            if (op == 6) dq.pop_back(), model.pop_back();
+            else dq.pop_front(), model.pop_front();
+        } else if (op == 8 && round % 5000 == 0) {
+            dq.clear(), model.clear();
+        }
+        assert(dq.size() == model.size());
+        if (!model.empty()) assert(dq.front() == model.front() && dq.back() == model.back());
+    }
+    assert(ministl::equal(dq.begin(), dq.end(), model.begin()));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_deque_chunks() {
+    int score = 0, full_score = 0;
+    {
+        // a work queue at a steady depth: after warm up no chunk is allocated
+        ministl::deque<int, counting_allocator> queue;
+        int depth = 10000;
+        for (int i = 0; i < depth; i ++ ) queue.push_back(i);
+        for (int i = depth; i < 2 * depth; i ++ ) queue.push_back(i), queue.pop_front();
+        auto warm = counting_allocator::allocations;
+        for (int i = 2 * depth; i < 200 * depth; i ++ ) {
+            queue.push_back(i);
+            assert(queue.front() == i - depth);
+            queue.pop_front();
+        }
+        assert(counting_allocator::allocations == warm);
+        score ++ , full_score ++ ;
+
+        // draining leaves idle chunks until shrink_to_fit releases them
+        auto chunk_bytes = ministl::deque<int>::chunk_size * sizeof (int);
+        while (queue.size() > 10) queue.pop_back();
+        assert(queue.idle_chunks() >= size_t(depth) / ministl::deque<int>::chunk_size);
+        auto before = counting_allocator::live_bytes;
+        queue.shrink_to_fit();
+        assert(queue.idle_chunks() == 0 && counting_allocator::live_bytes < before);
+        assert(counting_allocator::live_bytes <= 2 * chunk_bytes + 8 * sizeof (int*));
+        for (int i = 0; i < 10; i ++ ) assert(queue[i] == 200 * depth - depth + i);
+        queue.clear();
+        queue.shrink_to_fit();
+        assert(counting_allocator::live_bytes == 0);
+        queue.push_front(1);
+        assert(queue.size() == 1 && queue.back() == 1);
+    }
+    assert(counting_allocator::live_bytes == 0);
+    score ++ , full_score ++ ;
+
+    // deques without a map: never used, released by shrink_to_fit, moved from
+    {
+        ministl::deque<int> a, b, c;
+        a.clear();
+        a.push_back(1);
+        b.clear();
+        b.push_front(2);
+        assert(a.size() == 1 && a.front() == 1 && b.size() == 1 && b.back() == 2);
+        c.push_back(3);
+        c.pop_back();
+        c.shrink_to_fit();
+        c.clear();
+        c.push_front(3);
+        c.push_back(4);
+        assert(c.size() == 2 && c[0] == 3 && c[1] == 4);
+        ministl::deque<int> d;
+        d = std::move(a);
+        assert(d.size() == 1 && d[0] == 1);
+        a.push_back(5);
+        a.push_front(6);
+        assert(a.size() == 2 && a[0] == 6 && a[1] == 5);
+        ministl::deque<int> e(std::move(b));
+        b.clear();
+        b.push_front(7);
+        assert(b.size() == 1 && b[0] == 7 && e[0] == 2);
+    }
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result deque_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_deque_basic();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_deque_iterator();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_deque_model();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_deque_chunks();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
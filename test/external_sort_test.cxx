@@ -0,0 +1,172 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <ministl/algorithm.h>
+#include <ministl/external_sort.h>
+#include <ministl/vector.h>
+#include <ministl/test.h>
+
+static std::string temp_path() {
+    char path[] = "/tmp/ministl_external_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    return path;
+}
+
+template<typename T>
+static void write_records(const std::string& path, const ministl::vector<T>& data) {
+    auto fp = std::fopen(path.c_str(), "wb");
+    assert(fp);
+    if (data.size()) std::fwrite(&data[0], sizeof (T), data.size(), fp);
+    std::fclose(fp);
+}
+
+template<typename T>
+static ministl::vector<T> read_records(const std::string& path) {
+    ministl::vector<T> data;
+    auto fp = std::fopen(path.c_str(), "rb");
+    assert(fp);
+    T val;
+    while (std::fread(&val, sizeof (T), 1, fp) == 1) data.push_back(val);
+    std::fclose(fp);
+    return data;
+}
+
+struct keyed_record {
+    uint32_t key;
+    uint32_t seq;
+    char payload[24];
+};
+
+static test_result test_external_sort_runs() {
+    int score = 0, full_score = 0;
+    auto in = temp_path(), out = temp_path();
+
+    // a tiny budget: hundreds of runs and several 2-way merge passes
+    int n = 50000;
+    ministl::vector<keyed_record> data;
+    for (int i = 0; i < n; i ++ ) data.push_back({uint32_t(std::rand() % 1000), uint32_t(i), "x"});
+    write_records(in, data);
+    auto by_key = [](const keyed_record& a, const keyed_record& b) { return a.key < b.key; };
+    ministl::external_sort_options options;
+    options.memory_budget = 16 << 10;
+    auto stats = ministl::external_sort<keyed_record>(in.c_str(), out.c_str(), by_key, options);
+    assert(stats.elements == size_t(n) && stats.runs > 100 && stats.merge_passes > 5);
+
+    // stable: equal keys keep their input order
+    auto sorted = read_records<keyed_record>(out);
+    assert(sorted.size() == size_t(n));
+    for (int i = 1; i < n; i ++ ) {
+        assert(sorted[i - 1].key < sorted[i].key || (sorted[i - 1].key == sorted[i].key && sorted[i - 1].seq < sorted[i].seq));
+    }
+    score ++ , full_score ++ ;
+
+    // the runs share one spill file per pass, so a few free descriptors are enough
+    rlimit saved;
+    getrlimit(RLIMIT_NOFILE, &saved);
+    int highest = dup(0);
+    close(highest);
+    rlimit low = saved;
+    low.rlim_cur = highest + 8;
+    setrlimit(RLIMIT_NOFILE, &low);
+    auto again = ministl::external_sort<keyed_record>(in.c_str(), out.c_str(), by_key, options);
+    setrlimit(RLIMIT_NOFILE, &saved);
+    auto resorted = read_records<keyed_record>(out);
+    assert(again.runs == stats.runs && resorted.size() == sorted.size());
+    for (int i = 0; i < n; i ++ ) assert(resorted[i].seq == sorted[i].seq);
+    score ++ , full_score ++ ;
+
+    // a comparator throwing while the io thread is busy, in pass one and in a merge
+    size_t calls = 0, throw_at = 0;
+    auto counting = [&](const keyed_record& a, const keyed_record& b) {
+        if ( ++ calls == throw_at) throw std::logic_error("comparator");
+        return a.key < b.key;
+    };
+    ministl::external_sort<keyed_record>(in.c_str(), out.c_str(), counting, options);
+    auto total = calls;
+    for (auto at : {size_t(3000), total - 1000}) {
+        calls = 0, throw_at = at;
+        bool thrown = false;
+        try {
+            ministl::external_sort<keyed_record>(in.c_str(), out.c_str(), counting, options);
+        } catch (const std::logic_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    score ++ , full_score ++ ;
+
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+    return {score, full_score};
+}
+
+static test_result test_external_sort_wide_merge() {
+    int score = 0, full_score = 0;
+    auto in = temp_path(), out = temp_path();
+
+    // a budget of a few runs merged in one pass, against the in-memory sort
+    int n = 2000000;
+    ministl::vector<uint32_t> data;
+    for (int i = 0; i < n; i ++ ) data.push_back(uint32_t(std::rand()) * 2654435761u);
+    write_records(in, data);
+    ministl::external_sort_options options;
+    options.memory_budget = 4 << 20;
+    auto stats = ministl::external_sort<uint32_t>(in.c_str(), out.c_str(), options);
+    assert(stats.runs == 5 && stats.merge_passes == 1);
+    ministl::stable_sort(data.begin(), data.end());
+    assert(read_records<uint32_t>(out) == data);
+    score ++ , full_score ++ ;
+
+    // fits in memory, and the empty input
+    write_records(in, ministl::vector<uint32_t> {3, 1, 2});
+    stats = ministl::external_sort<uint32_t>(in.c_str(), out.c_str(), ministl::greater<> {});
+    assert(stats.runs == 1 && stats.merge_passes == 0);
+    assert((read_records<uint32_t>(out) == ministl::vector<uint32_t> {3, 2, 1}));
+    write_records(in, ministl::vector<uint32_t>());
+    stats = ministl::external_sort<uint32_t>(in.c_str(), out.c_str());
+    assert(stats.elements == 0 && read_records<uint32_t>(out).size() == 0);
+    score ++ , full_score ++ ;
+
+    // a partial record and a missing file are reported
+    auto fp = std::fopen(in.c_str(), "wb");
+    std::fputs("abcde", fp);
+    std::fclose(fp);
+    bool thrown = false;
+    try {
+        ministl::external_sort<uint32_t>(in.c_str(), out.c_str());
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        ministl::external_sort<uint32_t>("/nonexistent/ministl_input", out.c_str());
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    score ++ , full_score ++ ;
+
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+    return {score, full_score};
+}
+
+test_result external_sort_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_external_sort_runs();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_external_sort_wide_merge();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
@@ -0,0 +1,202 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <ministl/filter.h>
+#include <ministl/vector.h>
+#include <ministl/test.h>
+
+// 64 byte aligned buffer for a serialized filter
+struct flat_buffer {
+    void* data;
+    size_t size;
+
+    explicit flat_buffer(size_t size) : data(::operator new(size, std::align_val_t(64))), size(size) {}
+
+    ~flat_buffer() { ::operator delete(data, std::align_val_t(64)); }
+};
+
+template<typename Fn>
+static bool throws_runtime_error(Fn fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+static test_result test_bloom() {
+    int score = 0, full_score = 0;
+    int n = 100000, probes = 1000000;
+    ministl::blocked_bloom_filter<uint64_t> filter(n);
+    assert(filter.block_count() == size_t(n) * 10 / 512 + 1);
+    for (uint64_t k = 0; k < uint64_t(n); k ++ ) filter.insert(k * 7919);
+    // no false negatives, about 1% false positives at 10 bits per key
+    for (uint64_t k = 0; k < uint64_t(n); k ++ ) assert(filter.contains(k * 7919));
+    int false_positives = 0;
+    for (uint64_t k = 0; k < uint64_t(probes); k ++ ) false_positives += filter.contains(k * 7919 + 1);
+    assert(false_positives < probes / 50);
+    score ++ , full_score ++ ;
+
+    // the batch paths agree with the single key ones
+    ministl::vector<uint64_t> keys;
+    for (int i = 0; i < 1000; i ++ ) keys.push_back(uint64_t(std::rand()) * (i % 2 ? 7919 : 1));
+    ministl::vector<bool> found(keys.size(), false);
+    auto positives = filter.contains_batch(keys.begin(), keys.end(), found.begin());
+    size_t expect = 0;
+    for (size_t i = 0; i < keys.size(); i ++ ) {
+        assert(found[i] == filter.contains(keys[i]));
+        expect += found[i];
+    }
+    assert(positives == expect);
+    ministl::blocked_bloom_filter<uint64_t> one_by_one(1000), batched(1000);
+    for (auto k : keys) one_by_one.insert(k);
+    batched.insert_batch(keys.begin(), keys.end());
+    flat_buffer a(one_by_one.serialized_size()), b(batched.serialized_size());
+    one_by_one.serialize(a.data);
+    batched.serialize(b.data);
+    assert(a.size == b.size && std::memcmp(a.data, b.data, a.size) == 0 && batched.size() == 1000);
+    score ++ , full_score ++ ;
+
+    // any hashable key
+    ministl::blocked_bloom_filter<std::string> names(100, 16);
+    names.insert("alpha");
+    names.insert("beta");
+    assert(names.contains("alpha") && names.contains("beta") && names.size() == 2);
+    names.clear();
+    assert(!names.contains("alpha") && names.size() == 0);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_cuckoo() {
+    int score = 0, full_score = 0;
+    int n = 100000, probes = 1000000;
+    ministl::cuckoo_filter<uint64_t> filter(n);
+    for (uint64_t k = 0; k < uint64_t(n); k ++ ) assert(filter.insert(k * 7919));
+    assert(filter.size() == size_t(n) && filter.capacity() >= size_t(n) && !filter.full());
+    for (uint64_t k = 0; k < uint64_t(n); k ++ ) assert(filter.contains(k * 7919));
+    int false_positives = 0;
+    for (uint64_t k = 0; k < uint64_t(probes); k ++ ) false_positives += filter.contains(k * 7919 + 1);
+    assert(false_positives < probes / 2000);
+    score ++ , full_score ++ ;
+
+    // erase the even keys: the odd ones stay, the even ones are gone up to false positives
+    for (uint64_t k = 0; k < uint64_t(n); k += 2) assert(filter.erase(k * 7919));
+    assert(filter.size() == size_t(n) / 2);
+    int still_there = 0;
+    for (uint64_t k = 0; k < uint64_t(n); k ++ ) {
+        if (k % 2) assert(filter.contains(k * 7919));
+        else still_there += filter.contains(k * 7919);
+    }
+    assert(still_there < n / 1000);
+    ministl::vector<uint64_t> keys;
+    for (uint64_t k = 0; k < 1000; k ++ ) keys.push_back(k * 7919);
+    ministl::vector<bool> found(keys.size(), false);
+    auto positives = filter.contains_batch(keys.begin(), keys.end(), found.begin());
+    size_t expect = 0;
+    for (size_t i = 0; i < keys.size(); i ++ ) {
+        assert(found[i] == filter.contains(keys[i]));
+        expect += found[i];
+    }
+    assert(positives == expect && expect >= 500);
+    score ++ , full_score ++ ;
+
+    // fill until full: loads above 90%, then no more inserts until a slot frees up
+    ministl::cuckoo_filter<uint64_t> small(1000);
+    ministl::vector<uint64_t> many;
+    for (uint64_t k = 0; k < 4 * small.capacity(); k ++ ) many.push_back(k);
+    auto inserted = small.insert_batch(many.begin(), many.end());
+    assert(small.full() && inserted == small.size() && small.load_factor() > 0.9);
+    for (uint64_t k = 0; k < inserted; k ++ ) assert(small.contains(k));
+    assert(!small.insert(inserted));
+    assert(small.erase(0) && !small.full() && small.insert(inserted));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_filter_serialize() {
+    int score = 0, full_score = 0;
+    ministl::cuckoo_filter<uint64_t> cuckoo(500);
+    uint64_t k = 0;
+    while (cuckoo.insert(k)) k ++ ;
+    flat_buffer flat(cuckoo.serialized_size());
+    cuckoo.serialize(flat.data);
+    // a view answers in place, including for the fingerprint kept aside
+    auto view = ministl::cuckoo_filter<uint64_t>::view(flat.data, flat.size);
+    assert(view.is_view() && view.full() && view.size() == cuckoo.size());
+    for (uint64_t i = 0; i < k; i ++ ) assert(view.contains(i));
+    bool thrown = false;
+    try {
+        view.erase(0);
+    } catch (const std::logic_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    // a loaded copy is writable and independent of the buffer
+    auto copy = ministl::cuckoo_filter<uint64_t>::load(flat.data, flat.size);
+    std::memset(flat.data, 0, flat.size);
+    assert(!copy.is_view() && copy.erase(1) && copy.insert(k));
+    for (uint64_t i = 0; i < k; i ++ ) assert(i == 1 || copy.contains(i));
+    score ++ , full_score ++ ;
+
+    // corrupt buffers are rejected
+    ministl::blocked_bloom_filter<uint64_t> bloom(1000);
+    for (uint64_t i = 0; i < 1000; i ++ ) bloom.insert(i);
+    flat_buffer bloom_flat(bloom.serialized_size());
+    bloom.serialize(bloom_flat.data);
+    using bloom_type = ministl::blocked_bloom_filter<uint64_t>;
+    assert(throws_runtime_error([&] { bloom_type::view(bloom_flat.data, bloom_flat.size - 8); }));
+    assert(throws_runtime_error([&] { bloom_type::view(bloom_flat.data, 10); }));
+    assert(throws_runtime_error([&] { ministl::cuckoo_filter<uint64_t>::view(bloom_flat.data, bloom_flat.size); }));
+    score ++ , full_score ++ ;
+
+    // written to a file and mmapped at startup
+    char path[] = "/tmp/ministl_filter_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    auto written = write(fd, bloom_flat.data, bloom_flat.size);
+    assert(written == ssize_t(bloom_flat.size));
+    auto mapped = mmap(nullptr, bloom_flat.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    assert(mapped != MAP_FAILED);
+    {
+        auto from_file = bloom_type::view(mapped, bloom_flat.size);
+        assert(from_file.size() == 1000 && from_file.block_count() == bloom.block_count());
+        for (uint64_t i = 0; i < 1000; i ++ ) assert(from_file.contains(i));
+        ministl::vector<uint64_t> keys;
+        for (uint64_t i = 0; i < 2000; i ++ ) keys.push_back(i);
+        ministl::vector<bool> found(keys.size(), false);
+        assert(from_file.contains_batch(keys.begin(), keys.end(), found.begin()) == bloom.contains_batch(keys.begin(), keys.end(), found.begin()));
+    }
+    munmap(mapped, bloom_flat.size);
+    close(fd);
+    std::remove(path);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result filter_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_bloom();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_cuckoo();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_filter_serialize();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
@@ -0,0 +1,119 @@
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <ministl/inplace_vector.h>
+#include <ministl/string.h>
+#include <ministl/test.h>
+
+static test_result test_inplace_basic() {
+    int score = 0, full_score = 0;
+    ministl::inplace_vector<int, 8> vec = {1, 2, 3};
+    vec.push_back(4);
+    vec.emplace_back(5);
+    assert(vec.size() == 5 && vec.capacity() == 8 && vec.front() == 1 && vec.back() == 5);
+    int expect = 1;
+    for (auto val : vec) assert(val == expect ++ );
+    expect = 5;
+    for (auto it = vec.rbegin(); it != vec.rend(); it ++ ) assert(*it == expect -- );
+    score ++ , full_score ++ ;
+
+    vec.emplace(vec.begin() + 1, 42);
+    vec.insert(vec.end(), 6);
+    assert((vec == ministl::inplace_vector<int, 8> {1, 42, 2, 3, 4, 5, 6}));
+    auto it = vec.erase(vec.begin() + 1);
+    assert(*it == 2);
+    vec.erase(vec.begin() + 2, vec.begin() + 4);
+    vec.pop_back();
+    assert((vec == ministl::inplace_vector<int, 8> {1, 2, 5}));
+    score ++ , full_score ++ ;
+
+    // full: try_ fails softly, the throwing versions throw
+    ministl::inplace_vector<int, 2> small;
+    assert(small.try_push_back(1) && small.try_push_back(2) && !small.try_push_back(3));
+    assert(small.full() && small.size() == 2);
+    bool thrown = false;
+    try {
+        small.push_back(3);
+    } catch (const std::length_error&) {
+        thrown = true;
+    }
+    assert(thrown && small.size() == 2);
+    thrown = false;
+    try {
+        small.at(2);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+struct packet {
+    int id;
+    char payload[12];
+};
+
+static test_result test_inplace_trivial() {
+    int score = 0, full_score = 0;
+    using batch = ministl::inplace_vector<packet, 16>;
+    static_assert(std::is_trivially_copyable_v<batch>);
+    static_assert(!std::is_trivially_copyable_v<ministl::inplace_vector<ministl::string, 4>>);
+    static_assert(sizeof (batch) == sizeof (size_t) + 16 * sizeof (packet));
+
+    // a byte copy, e.g. through shared memory, is a valid object
+    batch src;
+    for (int i = 0; i < 10; i ++ ) src.push_back({i, "payload"});
+    alignas(batch) unsigned char raw[sizeof (batch)];
+    std::memcpy(raw, &src, sizeof (batch));
+    batch dst;
+    std::memcpy(&dst, raw, sizeof (batch));
+    assert(dst.size() == 10 && dst[7].id == 7 && std::strcmp(dst[9].payload, "payload") == 0);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_inplace_non_trivial() {
+    int score = 0, full_score = 0;
+    ministl::inplace_vector<ministl::string, 4> names;
+    names.push_back("a long string that does not fit the small buffer");
+    names.emplace_back("b");
+    auto copy = names;
+    auto moved = std::move(names);
+    assert(copy == moved && copy[0] == "a long string that does not fit the small buffer");
+    copy.erase(copy.begin());
+    assert(copy.size() == 1 && copy[0] == "b");
+    copy.swap(moved);
+    assert(copy.size() == 2 && moved.size() == 1);
+    score ++ , full_score ++ ;
+
+    // move only elements
+    ministl::inplace_vector<std::unique_ptr<int>, 4> owners;
+    owners.push_back(std::make_unique<int>(1));
+    owners.emplace(owners.begin(), std::make_unique<int>(0));
+    auto taken = std::move(owners);
+    assert(*taken[0] == 0 && *taken[1] == 1);
+    taken.resize(1);
+    assert(taken.size() == 1);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result inplace_vector_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_inplace_basic();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_inplace_trivial();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_inplace_non_trivial();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
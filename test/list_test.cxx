@@ -0,0 +1,236 @@
+#include <cassert>
+#include <ministl/forward_list.h>
+#include <ministl/iterator.h>
+#include <ministl/list.h>
+#include <ministl/node_pool.h>
+#include <ministl/test.h>
+
+static test_result test_node_pool() {
+    int score = 0, full_score = 0;
+    ministl::node_pool pool(24, 8);
+    void* nodes[100];
+    for (int i = 0; i < 100; i ++ ) nodes[i] = pool.allocate();
+    // nodes of one slab are packed back to back
+    assert(static_cast<char *>(nodes[1]) - static_cast<char *>(nodes[0]) == 24);
+    pool.deallocate(nodes[42]);
+    assert(pool.allocate() == nodes[42]);
+    score ++ , full_score ++ ;
+    return {score, full_score};
+}
+
+static test_result test_list_basic() {
+    int score = 0, full_score = 0;
+    ministl::list<int> l = {1, 2, 3};
+    l.push_front(0);
+    l.emplace_back(4);
+    assert(l.size() == 5 && l.front() == 0 && l.back() == 4);
+    int expect = 0;
+    for (auto val : l) assert(val == expect ++ );
+    score ++ , full_score ++ ;
+
+    // bidirectional dispatch of advance and distance
+    static_assert(ministl::is_bidirectional_iterator<ministl::list<int>::iterator>::value);
+    static_assert(!ministl::is_random_access_iterator<ministl::list<int>::iterator>::value);
+    auto it = l.begin();
+    ministl::advance(it, 3);
+    assert(*it == 3 && ministl::distance(l.begin(), it) == 3);
+    assert(ministl::distance(l.begin(), l.end()) == 5);
+    ministl::advance(it, -2);
+    assert(*it == 1);
+    score ++ , full_score ++ ;
+
+    it = l.erase(it);
+    assert(*it == 2 && l.size() == 4);
+    l.insert(it, 42);
+    l.pop_front();
+    l.pop_back();
+    assert((l == ministl::list<int> {42, 2, 3}));
+    score ++ , full_score ++ ;
+
+    expect = 3;
+    for (auto rit = l.rbegin(); rit != l.rend(); rit ++ ) {
+        assert(*rit == (expect == 1 ? 42 : expect));
+        expect -- ;
+    }
+    l.reverse();
+    assert((l == ministl::list<int> {3, 2, 42}));
+    score ++ , full_score ++ ;
+
+    auto copy = l;
+    auto moved = std::move(l);
+    assert(l.empty() && copy == moved);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_list_splice() {
+    int score = 0, full_score = 0;
+
+    { // whole list splice absorbs the other pool
+        ministl::list<int> a = {1, 2}, b = {3, 4, 5};
+        auto node_of_four = &*( ++ b.begin());
+        a.splice(a.end(), b);
+        assert(b.empty() && a.size() == 5);
+        assert(&*ministl::find(a.begin(), a.end(), 4) == node_of_four);
+        score ++ , full_score ++ ;
+    }
+
+    { // part of a list moves between container pools without copying
+        ministl::list<int> a = {1, 2}, b = {3, 4, 5};
+        auto node_of_four = &*( ++ b.begin());
+        a.splice(a.begin(), b, ++ b.begin());
+        assert((a == ministl::list<int> {4, 1, 2}) && (b == ministl::list<int> {3, 5}));
+        assert(&a.front() == node_of_four);
+        score ++ , full_score ++ ;
+    }
+
+    { // spliced nodes outlive the list whose slabs they were carved from
+        ministl::list<ministl::list<int>> a;
+        a.emplace(a.end(), ministl::list<int> {0});
+        {
+            ministl::list<ministl::list<int>> b;
+            for (int i = 1; i <= 100; i ++ ) b.emplace(b.end(), ministl::list<int> {i, i});
+            auto first = b.begin();
+            for (int i = 0; i < 10; i ++ ) ++ first;
+            auto last = first;
+            for (int i = 0; i < 50; i ++ ) ++ last;
+            auto moved = &*first;
+            a.splice(a.end(), b, first, last);
+            assert(a.size() == 51 && b.size() == 50 && &*( ++ a.begin()) == moved);
+            // back and forth, then b takes a node carved by a
+            b.splice(b.begin(), a, a.begin());
+            a.splice(a.begin(), b, b.begin());
+            b.splice(b.end(), a, a.begin());
+            assert(b.back().front() == 0);
+        }
+        int expect = 11;
+        for (auto& inner : a) assert(inner.size() == 2 && inner.front() == expect ++ );
+        assert(expect == 61);
+        // freed foreign nodes are reused by the receiving list
+        a.erase(++ a.begin(), a.end());
+        for (int i = 0; i < 49; i ++ ) a.emplace(a.end(), ministl::list<int> {i});
+        assert(a.size() == 50);
+        score ++ , full_score ++ ;
+    }
+
+    { // thread pool relinks nodes
+        ministl::list<int, ministl::thread_pool> a = {1, 2}, b = {3, 4, 5};
+        auto node_of_four = &*( ++ b.begin());
+        a.splice(a.begin(), b, ++ b.begin(), b.end());
+        assert(a.size() == 4 && b.size() == 1 && &a.front() == node_of_four);
+        score ++ , full_score ++ ;
+    }
+
+    { // move within one list, LRU style
+        ministl::list<int> l = {1, 2, 3, 4};
+        l.splice(l.begin(), l, ministl::find(l.begin(), l.end(), 3));
+        assert((l == ministl::list<int> {3, 1, 2, 4}) && l.size() == 4);
+        // an element spliced before itself or its successor stays put
+        l.splice(l.begin(), l, l.begin());
+        auto second = ++ l.begin();
+        l.splice(second, l, l.begin());
+        assert((l == ministl::list<int> {3, 1, 2, 4}) && l.size() == 4);
+        score ++ , full_score ++ ;
+    }
+
+    return {score, full_score};
+}
+
+struct job {
+    int id;
+    ministl::list_hook lru_hook;
+    ministl::forward_list_hook queue_hook;
+};
+
+static test_result test_intrusive() {
+    int score = 0, full_score = 0;
+    job jobs[4] = {{0, {}, {}}, {1, {}, {}}, {2, {}, {}}, {3, {}, {}}};
+
+    {
+        ministl::intrusive_list<job, &job::lru_hook> lru;
+        for (auto& j : jobs) lru.push_back(j);
+        assert(lru.size() == 4 && lru.front().id == 0 && lru.back().id == 3);
+        lru.splice(lru.begin(), lru, lru.iterator_to(jobs[2]));
+        lru.erase(jobs[1]);
+        int expect[] = {2, 0, 3}, i = 0;
+        for (auto& j : lru) assert(j.id == expect[i ++ ]);
+        assert(i == 3 && lru.size() == 3 && !jobs[1].lru_hook.is_linked());
+        score ++ , full_score ++ ;
+    }
+
+    {
+        ministl::intrusive_forward_list<job, &job::queue_hook> queue, other;
+        queue.push_back(jobs[0]);
+        queue.push_back(jobs[1]);
+        other.push_back(jobs[2]);
+        queue.splice_back(other);
+        queue.push_front(jobs[3]);
+        assert(queue.size() == 4 && other.empty());
+        int expect[] = {3, 0, 1, 2}, i = 0;
+        for (auto& j : queue) assert(j.id == expect[i ++ ]);
+        queue.pop_front();
+        assert(queue.front().id == 0);
+        score ++ , full_score ++ ;
+    }
+
+    return {score, full_score};
+}
+
+static test_result test_forward_list() {
+    int score = 0, full_score = 0;
+    ministl::forward_list<int> l = {1, 2, 3};
+    l.push_front(0);
+    assert(l.size() == 4 && l.front() == 0);
+    static_assert(ministl::is_forward_iterator<ministl::forward_list<int>::iterator>::value);
+    static_assert(!ministl::is_bidirectional_iterator<ministl::forward_list<int>::iterator>::value);
+    assert(ministl::distance(l.begin(), l.end()) == 4);
+    auto it = l.begin();
+    ministl::advance(it, 2);
+    assert(*it == 2);
+    score ++ , full_score ++ ;
+
+    l.erase_after(it);
+    l.insert_after(l.before_begin(), -1);
+    assert((l == ministl::forward_list<int> {-1, 0, 1, 2}));
+    l.reverse();
+    assert((l == ministl::forward_list<int> {2, 1, 0, -1}));
+    score ++ , full_score ++ ;
+
+    ministl::forward_list<int> other = {7, 8};
+    l.splice_after(l.before_begin(), other);
+    assert(other.empty() && (l == ministl::forward_list<int> {7, 8, 2, 1, 0, -1}));
+    l.splice_after(l.before_begin(), l, l.begin());
+    assert((l == ministl::forward_list<int> {8, 7, 2, 1, 0, -1}) && l.size() == 6);
+    {
+        ministl::forward_list<int> donor = {9, 10};
+        auto node_of_nine = &donor.front();
+        l.splice_after(l.before_begin(), donor, donor.before_begin());
+        assert(&l.front() == node_of_nine && donor.size() == 1 && l.size() == 7);
+    }
+    assert((l == ministl::forward_list<int> {9, 8, 7, 2, 1, 0, -1}));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result list_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_node_pool();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_list_basic();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_list_splice();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_intrusive();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_forward_list();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
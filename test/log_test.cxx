@@ -0,0 +1,111 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <ministl/log.h>
+#include <ministl/string.h>
+#include <ministl/vector.h>
+#include <ministl/test.h>
+
+static size_t count_lines(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) count ++ ;
+    return count;
+}
+
+static test_result test_text_sink() {
+    int score = 0, full_score = 0;
+    auto& backend = ministl::log_backend::instance();
+    std::ostringstream out;
+    backend.set_text_sink(&out);
+
+    ministl::string name = "ministl";
+    log_info("answer = ", 42, ", pi = ", 2.5, ", name = ", name, ", ok = ", true, ' ', -7);
+    log_trace("filtered out at compile time");
+    backend.flush();
+    auto text = out.str();
+    assert(text.find("[info] ") == 0);
+    assert(text.find(" [answer = 42, pi = 2.5, name = ministl, ok = 1 -7]\n") != std::string::npos);
+    assert(text.find("filtered") == std::string::npos);
+    score ++ , full_score ++ ;
+
+    { // string arguments are copied, the buffer may die right after the call
+        char buf[16] = "temporary";
+        log_warn(static_cast<const char *>(buf));
+        std::memset(buf, 'x', sizeof (buf) - 1);
+        backend.flush();
+        assert(out.str().find("[warn] ") != std::string::npos);
+        assert(out.str().find("[temporary]") != std::string::npos);
+        score ++ , full_score ++ ;
+    }
+
+    { // a string larger than the ring is cut short instead of waiting forever
+        std::string huge(3 * ministl::log_detail::ring_buffer::capacity, 'y');
+        log_error("huge ", huge, " done");
+        log_error("after huge");
+        backend.flush();
+        auto text = out.str();
+        auto begin = text.find("[huge y"), end = text.find(" done]");
+        assert(begin != std::string::npos && end != std::string::npos);
+        assert(end - begin < ministl::log_detail::ring_buffer::max_record && end - begin > 1000);
+        assert(text.find("[after huge]") != std::string::npos);
+        score ++ , full_score ++ ;
+    }
+
+    backend.set_text_sink(&std::cout);
+    return {score, full_score};
+}
+
+static test_result test_threads_and_binary_file() {
+    int score = 0, full_score = 0;
+    auto& backend = ministl::log_backend::instance();
+    auto path = (std::filesystem::temp_directory_path() / "ministl_log_test.bin").string();
+    std::ostringstream out;
+    backend.set_text_sink(&out);
+    assert(backend.open_binary_file(path.c_str()));
+
+    // more bytes than one ring holds, so producers wrap and wait for the consumer
+    int threads = 4, per_thread = 20000;
+    ministl::vector<std::thread> workers;
+    for (int t = 0; t < threads; t ++ ) {
+        workers.emplace_back([t, per_thread] {
+            for (int i = 0; i < per_thread; i ++ ) log_info("worker ", t, " item ", i);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    log_error("done");
+    backend.flush();
+    assert(count_lines(out.str(), " item ") == size_t(threads * per_thread));
+    score ++ , full_score ++ ;
+
+    backend.open_binary_file(nullptr);
+    backend.set_text_sink(&std::cout);
+
+    ministl::log_decoder decoder(path.c_str());
+    assert(decoder.good());
+    std::ostringstream decoded;
+    assert(decoder.decode(decoded) == size_t(threads * per_thread + 1));
+    auto text = decoded.str();
+    assert(count_lines(text, "[info] ") == size_t(threads * per_thread));
+    assert(text.find(" [worker 3 item 19999]\n") != std::string::npos);
+    assert(text.find("[error] ") != std::string::npos && text.find(" [done]\n") != std::string::npos);
+    std::remove(path.c_str());
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result log_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_text_sink();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_threads_and_binary_file();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
@@ -0,0 +1,212 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <ministl/lru_cache.h>
+#include <ministl/vector.h>
+#include <ministl/test.h>
+
+template<typename Cache>
+static ministl::vector<int> keys_of(const Cache& cache) {
+    ministl::vector<int> res;
+    cache.for_each([&res](int key, const std::string&) { res.push_back(key); });
+    return res;
+}
+
+static test_result test_lru_order() {
+    int score = 0, full_score = 0;
+    ministl::lru_cache<int, std::string> cache(3);
+    for (int i = 1; i <= 3; i ++ ) cache.insert_or_assign(i, std::to_string(i));
+    assert(cache.find(1) && *cache.find(1) == "1");
+    cache.insert_or_assign(4, std::string("4"));
+    // 2 was the least recently used
+    assert(!cache.contains(2) && cache.size() == 3);
+    assert((keys_of(cache) == ministl::vector<int> {4, 1, 3}));
+    // peek is not a use
+    assert(*cache.peek(3) == "3");
+    cache.insert_or_assign(5, std::string("5"));
+    assert(!cache.contains(3));
+    auto& stats = cache.stats();
+    assert(stats.hits == 2 && stats.misses == 0 && stats.insertions == 5 && stats.evictions == 2);
+    score ++ , full_score ++ ;
+
+    // assign is a use, erase frees a slot, get_or_insert calls make on a miss only
+    cache.insert_or_assign(1, std::string("one"));
+    assert(cache.erase(4) && !cache.erase(4) && cache.size() == 2);
+    int made = 0;
+    auto make = [&made] { made ++ ; return std::string("six"); };
+    assert(cache.get_or_insert(6, make) == "six" && cache.get_or_insert(6, make) == "six" && made == 1);
+    std::string out;
+    assert(cache.get(1, out) && out == "one" && !cache.get(42, out));
+    assert((keys_of(cache) == ministl::vector<int> {1, 6, 5}));
+    assert(cache.stats().misses == 2 && cache.stats().evictions == 2);
+    cache.clear();
+    cache.reset_stats();
+    assert(cache.empty() && cache.stats().insertions == 0 && !cache.find(1));
+    score ++ , full_score ++ ;
+
+    bool thrown = false;
+    try {
+        ministl::lru_cache<int, int> empty(0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_lru_model() {
+    int score = 0, full_score = 0;
+    // random traffic against std::list + std::unordered_map, a narrow key range forces long probe runs
+    size_t capacity = 100;
+    ministl::lru_cache<int, int> cache(capacity);
+    std::list<std::pair<int, int>> order;
+    std::unordered_map<int, std::list<std::pair<int, int>>::iterator> where;
+    uint64_t hits = 0, evictions = 0;
+    for (int round = 0; round < 300000; round ++ ) {
+        int key = std::rand() % 300 * 256, op = std::rand() % 10;
+        auto it = where.find(key);
+        if (op < 6) {
+            auto val = cache.find(key);
+            assert((val != nullptr) == (it != where.end()));
+            if (!val) continue;
+            hits ++ ;
+            assert(*val == it->second->second);
+            order.splice(order.begin(), order, it->second);
+        } else if (op < 9) {
+            cache.insert_or_assign(key, round);
+            if (it != where.end()) {
+                it->second->second = round;
+                order.splice(order.begin(), order, it->second);
+                continue;
+            }
+            if (order.size() == capacity) {
+                where.erase(order.back().first);
+                order.pop_back();
+                evictions ++ ;
+            }
+            order.push_front({key, round});
+            where[key] = order.begin();
+        } else {
+            assert(cache.erase(key) == (it != where.end()));
+            if (it == where.end()) continue;
+            order.erase(it->second);
+            where.erase(it);
+        }
+    }
+    assert(cache.size() == order.size() && cache.stats().hits == hits && cache.stats().evictions == evictions);
+    auto expect = order.begin();
+    cache.for_each([&expect](int key, int val) {
+        assert(key == expect->first && val == expect->second);
+        expect ++ ;
+    });
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_sieve() {
+    int score = 0, full_score = 0;
+    ministl::sieve_cache<int, std::string> cache(3);
+    for (int i = 1; i <= 3; i ++ ) cache.insert_or_assign(i, std::to_string(i));
+    // a hit leaves the order alone
+    assert(cache.find(1));
+    assert((keys_of(cache) == ministl::vector<int> {3, 2, 1}));
+    // the hand clears 1 and evicts 2, then continues at 3
+    cache.insert_or_assign(4, std::string("4"));
+    assert((keys_of(cache) == ministl::vector<int> {4, 3, 1}));
+    cache.insert_or_assign(5, std::string("5"));
+    assert((keys_of(cache) == ministl::vector<int> {5, 4, 1}));
+    // the hand keeps moving towards the newest, 1 stays although it is the oldest
+    cache.insert_or_assign(6, std::string("6"));
+    assert((keys_of(cache) == ministl::vector<int> {6, 5, 1}));
+    // past the newest it wraps around to the oldest, whose bit was cleared
+    assert(cache.find(5) && cache.find(6));
+    cache.insert_or_assign(7, std::string("7"));
+    assert((keys_of(cache) == ministl::vector<int> {7, 6, 5}));
+    assert(cache.stats().evictions == 4 && cache.stats().hits == 3);
+    score ++ , full_score ++ ;
+
+    // 30% of the traffic goes to 32 hot keys, the rest are one time keys: sieve
+    // keeps the hot set, lru lets the one time keys push it out
+    ministl::sieve_cache<int, int> sieve(64);
+    ministl::lru_cache<int, int> lru(64);
+    for (int i = 0; i < 100000; i ++ ) {
+        int key = std::rand() % 10 < 3 ? std::rand() % 32 : 1000 + i;
+        sieve.get_or_insert(key, [] { return 0; });
+        lru.get_or_insert(key, [] { return 0; });
+    }
+    assert(sieve.stats().hit_ratio() > 0.28 && lru.stats().hit_ratio() < 0.2);
+    score ++ , full_score ++ ;
+
+    // erasing the entry under the hand
+    for (int i = 0; i < 100; i ++ ) {
+        sieve.insert_or_assign(i % 70, i);
+        if (i % 7 == 0) sieve.find(i % 13);
+        if (i % 5 == 0) sieve.erase(i % 11);
+    }
+    assert(sieve.size() <= 64 && *sieve.peek(99 % 70) == 99);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+template<ministl::cache_policy Policy>
+static bool check_sharded() {
+    ministl::sharded_cache<uint64_t, uint64_t, Policy> cache(1000, 4);
+    assert(cache.shard_count() == 4 && cache.capacity() == 1000);
+    int threads = 4, per_thread = 50000;
+    ministl::vector<std::thread> workers;
+    for (int t = 0; t < threads; t ++ ) {
+        workers.push_back(std::thread([&cache, t, per_thread] {
+            uint64_t x = t * 0x9e3779b97f4a7c15ULL + 1;
+            for (int i = 0; i < per_thread; i ++ ) {
+                x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+                // skewed: most lookups go to a small hot range
+                uint64_t key = x % 8 ? x % 500 : x % 5000;
+                auto val = cache.get_or_insert(key, [key] { return key * 3; });
+                assert(val == key * 3);
+                if (i % 1000 == 0) cache.erase(key);
+            }
+        }));
+    }
+    for (auto& w : workers) w.join();
+    auto stats = cache.stats();
+    assert(stats.hits + stats.misses == uint64_t(threads * per_thread));
+    assert(stats.hit_ratio() > 0.5 && stats.evictions > 0 && cache.size() <= 1000);
+    uint64_t out;
+    cache.clear();
+    return cache.size() == 0 && !cache.get(1, out) && !cache.contains(1);
+}
+
+static test_result test_sharded() {
+    int score = 0, full_score = 0;
+    assert(check_sharded<ministl::cache_policy::lru>());
+    score ++ , full_score ++ ;
+    assert(check_sharded<ministl::cache_policy::sieve>());
+    score ++ , full_score ++ ;
+    return {score, full_score};
+}
+
+test_result lru_cache_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_lru_order();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_lru_model();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_sieve();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_sharded();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
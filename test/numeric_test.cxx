@@ -0,0 +1,171 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <ministl/list.h>
+#include <ministl/numeric.h>
+#include <ministl/vector.h>
+#include <ministl/test.h>
+
+static bool close_to(double x, double expect, double rel) {
+    return std::fabs(x - expect) <= rel * (std::fabs(expect) + 1);
+}
+
+static test_result test_reduce() {
+    int score = 0, full_score = 0;
+    // every kernel tail length, from an unaligned start
+    for (int n : {0, 1, 7, 63, 64, 129, 1000, 100003}) {
+        ministl::vector<int64_t> ints;
+        ministl::vector<uint32_t> words;
+        ministl::vector<double> reals;
+        ministl::vector<float> floats;
+        int64_t int_sum = 0, dot = 0;
+        uint32_t word_sum = 0;
+        long double real_sum = 0, real_dot = 0;
+        for (int i = 0; i < n + 1; i ++ ) {
+            ints.push_back(std::rand() % 2001 - 1000);
+            words.push_back(uint32_t(std::rand()) * 2654435761u);
+            reals.push_back(std::rand() / double(RAND_MAX) - 0.3);
+            floats.push_back(float(reals[i]));
+            if (i == 0) continue;
+            int_sum += ints[i], dot += ints[i] * ints[i], word_sum += words[i];
+            real_sum += reals[i], real_dot += (long double)(reals[i]) * floats[i];
+        }
+        assert(ministl::reduce(ints.begin() + 1, ints.end(), int64_t(5)) == int_sum + 5);
+        assert(ministl::accumulate(ints.begin() + 1, ints.end(), int64_t(0)) == int_sum);
+        assert(ministl::reduce(words.begin() + 1, words.end(), uint32_t(0)) == word_sum);
+        assert(ministl::inner_product(ints.begin() + 1, ints.end(), ints.begin() + 1, int64_t(0)) == dot);
+        assert(ministl::transform_reduce(ints.begin() + 1, ints.end(), ints.begin() + 1, int64_t(0)) == dot);
+        assert(close_to(ministl::reduce(reals.begin() + 1, reals.end(), 0.0), real_sum, 1e-12));
+        assert(close_to(ministl::reduce(floats.begin() + 1, floats.end(), 0.0f), real_sum, 1e-4));
+        ministl::vector<double> widened;
+        for (int i = 1; i <= n; i ++ ) widened.push_back(floats[i]);
+        assert(close_to(ministl::transform_reduce(reals.begin() + 1, reals.end(), widened.begin(), 0.0), real_dot, 1e-12));
+        // reversed ranges are summed forwards
+        assert(ministl::reduce(ints.rbegin(), ints.rend() - 1, int64_t(0)) == int_sum);
+        score ++ , full_score ++ ;
+    }
+
+    // generic paths: a list, an ordered fold and a non simd op
+    ministl::list<int> l;
+    for (int i = 1; i <= 10; i ++ ) l.push_back(i);
+    assert(ministl::reduce(l.begin(), l.end(), 0) == 55);
+    assert(ministl::reduce(l.begin(), l.end(), 1, ministl::multiplies<> {}) == 3628800);
+    ministl::vector<std::string> words;
+    for (char c = 'a'; c <= 'i'; c ++ ) words.push_back(std::string(1, c));
+    assert(ministl::accumulate(words.begin(), words.end(), std::string(">")) == ">abcdefghi");
+    ministl::vector<int> small = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+    auto max = [](int a, int b) { return a < b ? b : a; };
+    assert(ministl::reduce(small.begin(), small.end(), 0, max) == 9);
+    assert(ministl::transform_reduce(small.begin(), small.end(), 0, ministl::plus<> {}, [](int x) { return x * 2; }) == 78);
+    assert(ministl::reduce(small.begin(), small.end()) == 39);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_compensated_sum() {
+    int score = 0, full_score = 0;
+    // 1 is below half an ulp of 1e8 in float: a running sum never moves
+    int n = 1000000;
+    ministl::vector<float> vals(n + 1, 1.0f);
+    vals[0] = 1e8f;
+    float exact = 101000000.0f;
+    assert(ministl::accumulate(vals.begin(), vals.end(), 0.0f) == 1e8f);
+    assert(ministl::reduce(ministl::kahan, vals.begin(), vals.end(), 0.0f) == exact);
+    assert(close_to(ministl::reduce(ministl::pairwise, vals.begin(), vals.end(), 0.0f), exact, 1e-6));
+    // reverse_iterator takes the generic paths
+    assert(ministl::reduce(ministl::kahan, vals.rbegin(), vals.rend(), 0.0f) == exact);
+    assert(close_to(ministl::reduce(ministl::pairwise, vals.rbegin(), vals.rend(), 0.0f), exact, 1e-6));
+    score ++ , full_score ++ ;
+
+    ministl::vector<double> a = {1e16, 1.0, -1e16, 1.0}, b = {1.0, 1.0, 1.0, 1.0};
+    assert(ministl::transform_reduce(ministl::kahan, a.begin(), a.end(), b.begin(), 0.0) == 2.0);
+    ministl::vector<double> tenths(1 << 20, 0.1);
+    auto precise = ministl::transform_reduce(ministl::kahan, tenths.begin(), tenths.end(), tenths.begin(), 0.0);
+    auto halved = ministl::transform_reduce(ministl::pairwise, tenths.begin(), tenths.end(), tenths.begin(), 0.0);
+    assert(close_to(precise, (1 << 20) * 0.01, 1e-15) && close_to(halved, precise, 1e-14));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+// 2x2 matrices under multiplication: associative but not commutative
+struct mat2 {
+    uint32_t a, b, c, d;
+
+    bool operator==(const mat2& rhs) const { return a == rhs.a && b == rhs.b && c == rhs.c && d == rhs.d; }
+};
+
+static mat2 mat_mul(const mat2& x, const mat2& y) {
+    return {x.a * y.a + x.b * y.c, x.a * y.b + x.b * y.d, x.c * y.a + x.d * y.c, x.c * y.b + x.d * y.d};
+}
+
+static test_result test_scan() {
+    int score = 0, full_score = 0;
+    for (int n : {0, 1, 5, 16, 17, 1000, 4099}) {
+        ministl::vector<int32_t> in;
+        for (int i = 0; i < n; i ++ ) in.push_back(std::rand() % 100 - 50);
+        ministl::vector<int32_t> incl(n), excl(n);
+        assert(ministl::inclusive_scan(in.begin(), in.end(), incl.begin()) == incl.end());
+        assert(ministl::exclusive_scan(in.begin(), in.end(), excl.begin(), 7) == excl.end());
+        int32_t run = 0;
+        for (int i = 0; i < n; i ++ ) {
+            assert(excl[i] == run + 7);
+            run += in[i];
+            assert(incl[i] == run);
+        }
+        // in place, and floating point within rounding
+        ministl::vector<double> reals;
+        for (int i = 0; i < n; i ++ ) reals.push_back(in[i] * 0.25);
+        ministl::inclusive_scan(reals.begin(), reals.end(), reals.begin());
+        for (int i = 0; i < n; i ++ ) assert(reals[i] == incl[i] * 0.25);
+        ministl::exclusive_scan(in.begin(), in.end(), in.begin(), 0);
+        for (int i = 0; i < n; i ++ ) assert(in[i] == excl[i] - 7);
+        score ++ , full_score ++ ;
+    }
+
+    // parallel, on ints and on an op that only is associative
+    int n = 1 << 18;
+    ministl::vector<int64_t> in, out(n), expect(n);
+    ministl::vector<mat2> mats, mat_out(n);
+    for (int i = 0; i < n; i ++ ) {
+        in.push_back(std::rand() % 1000);
+        mats.push_back({uint32_t(std::rand() % 3), 1, 1, uint32_t(std::rand() % 2)});
+    }
+    int64_t run = 0;
+    for (int i = 0; i < n; i ++ ) expect[i] = run, run += in[i];
+    for (unsigned threads : {1u, 3u, 4u}) {
+        ministl::parallel_exclusive_scan(in.begin(), in.end(), out.begin(), int64_t(0), ministl::plus<> {}, threads);
+        assert(out == expect);
+        ministl::parallel_inclusive_scan(mats.begin(), mats.end(), mat_out.begin(), mat_mul, mat2 {1, 0, 0, 1}, threads);
+        mat2 prod {1, 0, 0, 1};
+        for (int i = 0; i < n; i += 997) {
+            if (i == 0) prod = mats[0];
+            else for (int j = i - 996; j <= i; j ++ ) prod = mat_mul(prod, mats[j]);
+            assert(mat_out[i] == prod);
+        }
+        score ++ , full_score ++ ;
+    }
+    ministl::inclusive_scan(in.begin(), in.end(), in.begin());
+    assert(in[n - 1] == run && in[n / 2] == expect[n / 2 + 1]);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result numeric_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_reduce();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_compensated_sum();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_scan();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
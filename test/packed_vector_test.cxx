@@ -0,0 +1,120 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <ministl/packed_vector.h>
+#include <ministl/vector.h>
+#include <ministl/test.h>
+
+template<unsigned Bits>
+static bool check_packed(int n) {
+    ministl::packed_vector<Bits> packed;
+    ministl::vector<uint64_t> plain;
+    for (int i = 0; i < n; i ++ ) {
+        uint64_t val = (uint64_t(std::rand()) << 32 | uint64_t(std::rand())) & ministl::packed_vector<Bits>::max_value;
+        packed.push_back(val);
+        plain.push_back(val);
+    }
+    if (packed.size() != size_t(n)) return false;
+    for (int i = 0; i < n; i ++ ) {
+        if (packed[i] != plain[i]) return false;
+    }
+    // bulk decode from an unaligned start
+    ministl::vector<uint64_t> wide(n);
+    packed.unpack(3, n - 3, wide.begin());
+    for (int i = 3; i < n; i ++ ) {
+        if (wide[i - 3] != plain[i]) return false;
+    }
+    if constexpr (Bits <= 32) {
+        ministl::vector<uint32_t> narrow(n);
+        packed.unpack(5, n - 5, narrow.begin());
+        for (int i = 5; i < n; i ++ ) {
+            if (narrow[i - 5] != plain[i]) return false;
+        }
+    }
+    // overwrite in the middle without touching the neighbours
+    packed.set(n / 2, 0);
+    if (packed[n / 2] != 0 || packed[n / 2 - 1] != plain[n / 2 - 1] || packed[n / 2 + 1] != plain[n / 2 + 1]) return false;
+    return true;
+}
+
+static test_result test_packed_vector() {
+    int score = 0, full_score = 0;
+    assert(check_packed<1>(1000) && check_packed<3>(1000) && check_packed<7>(1001));
+    assert(check_packed<13>(777) && check_packed<20>(4096) && check_packed<25>(999));
+    assert(check_packed<31>(500) && check_packed<32>(500) && check_packed<57>(300) && check_packed<64>(300));
+    score ++ , full_score ++ ;
+
+    ministl::packed_vector<20> ids(1 << 16, 12345);
+    assert(ids.size() == 1 << 16 && ids[1000] == 12345);
+    // 20 of 64 bits per value
+    assert(ids.memory_bytes() * 3 < (1 << 16) * sizeof (uint64_t));
+    uint64_t sum = 0;
+    for (auto val : ids) sum += val;
+    assert(sum == uint64_t(12345) << 16);
+    static_assert(ministl::is_random_access_iterator<ministl::packed_vector<20>::const_iterator>::value);
+    score ++ , full_score ++ ;
+
+    ministl::packed_vector<4> nibbles = {1, 15, 16, 7};
+    assert(nibbles[0] == 1 && nibbles[1] == 15 && nibbles[2] == 0 && nibbles[3] == 7);
+    nibbles.pop_back();
+    assert(nibbles.size() == 3 && (nibbles == ministl::packed_vector<4> {1, 15, 0}));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_packed_sorted_vector() {
+    int score = 0, full_score = 0;
+    ministl::packed_sorted_vector sorted;
+    ministl::vector<uint64_t> plain;
+    uint64_t cur = 1000;
+    int n = 100000;
+    for (int i = 0; i < n; i ++ ) {
+        // mostly small gaps, repeats, and the occasional huge jump
+        cur += i % 5000 == 4999 ? (uint64_t(1) << 40) : std::rand() % 16;
+        sorted.push_back(cur);
+        plain.push_back(cur);
+    }
+    assert(sorted.size() == n && sorted.back() == plain[n - 1]);
+    for (int i = 0; i < n; i += 37) assert(sorted[i] == plain[i]);
+    assert(sorted[n - 1] == plain[n - 1] && sorted.at(0) == plain[0]);
+    score ++ , full_score ++ ;
+
+    size_t i = 0;
+    for (auto val : sorted) assert(val == plain[i ++ ]);
+    assert(i == size_t(n));
+    uint64_t block[ministl::packed_sorted_vector::block_size];
+    assert(sorted.decode_block(3, block) == 128 && block[5] == plain[3 * 128 + 5]);
+    score ++ , full_score ++ ;
+
+    // small gaps pack into a handful of bits, far below 64 per value
+    assert(sorted.memory_bytes() * 8 < n * sizeof (uint64_t));
+    score ++ , full_score ++ ;
+
+    for (int round = 0; round < 2000; round ++ ) {
+        uint64_t probe = round == 0 ? 0 : round == 1 ? ~uint64_t(0) : plain[std::rand() % n] + std::rand() % 3 - 1;
+        auto expect = ministl::lower_bound(plain.begin(), plain.end(), probe) - plain.begin();
+        auto it = sorted.lower_bound(probe);
+        assert(it.index() == size_t(expect));
+        if (it != sorted.end()) assert(*it == plain[expect]);
+    }
+    score ++ , full_score ++ ;
+
+    ministl::packed_sorted_vector small = {1, 3, 3, 8};
+    assert(small.lower_bound(3).index() == 1 && small.lower_bound(4).index() == 3 && small.lower_bound(9) == small.end());
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result packed_vector_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_packed_vector();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_packed_sorted_vector();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
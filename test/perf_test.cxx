@@ -0,0 +1,298 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <ministl/algorithm.h>
+#include <ministl/concurrent_hash_map.h>
+#include <ministl/deque.h>
+#include <ministl/filter.h>
+#include <ministl/log.h>
+#include <ministl/lru_cache.h>
+#include <ministl/numeric.h>
+#include <ministl/packed_vector.h>
+#include <ministl/perf.h>
+#include <ministl/sort_by_key.h>
+#include <ministl/sort_small.h>
+#include <ministl/vector.h>
+#include <ministl/test.h>
+
+static test_result test_counters() {
+    int score = 0, full_score = 0;
+    // counters may be missing (containers, VMs), the harness still has wall time
+    volatile uint64_t sink = 0;
+    auto report = ministl::measure("loop", 1000000, [&] {
+        for (int i = 0; i < 1000000; i ++ ) sink = sink + i;
+    });
+    assert(report.ns_per_op() > 0);
+    ministl::perf_counters counters;
+    for (int i = 0; i < ministl::perf_metric_count; i ++ ) {
+        assert(!report.has(i) || counters.available(i));
+    }
+    if (report.has(ministl::perf_instructions)) assert(report.per_op(ministl::perf_instructions) > 1);
+    // threads spawned in the region are counted too
+    auto threaded = ministl::measure("threaded_loop", 1000000, [&] {
+        std::thread worker([&] {
+            for (int i = 0; i < 1000000; i ++ ) sink = sink + i;
+        });
+        worker.join();
+    });
+    if (threaded.has(ministl::perf_instructions)) assert(threaded.per_op(ministl::perf_instructions) > 1);
+    std::ostringstream text;
+    text << report;
+    debug(text.str());
+    score ++ , full_score ++ ;
+    return {score, full_score};
+}
+
+static test_result test_baseline() {
+    int score = 0, full_score = 0;
+    ministl::perf_report fast {"sort", 100, {}}, slow {"sort", 100, {}};
+    fast.sample.nanoseconds = 1000;
+    fast.sample.values[ministl::perf_cycles] = 4000;
+    fast.sample.valid[ministl::perf_cycles] = true;
+    slow.sample.nanoseconds = 1050;
+    slow.sample.values[ministl::perf_cycles] = 6000;
+    slow.sample.valid[ministl::perf_cycles] = true;
+
+    ministl::perf_baseline baseline;
+    baseline.record(fast);
+    assert(baseline.size() == 2);
+    std::ostringstream msg;
+    assert(baseline.check(fast, 0.1, msg) && msg.str().empty());
+    // wall time is within 10%, cycles are not
+    assert(!baseline.check(slow, 0.1, msg));
+    assert(msg.str().find("cycles/op 60 vs baseline 40") != std::string::npos);
+    assert(baseline.check(slow, 0.6, msg));
+    score ++ , full_score ++ ;
+
+    // metrics missing on one side are skipped
+    ministl::perf_report wall_only {"sort", 100, {}};
+    wall_only.sample.nanoseconds = 1000;
+    assert(baseline.check(wall_only, 0.1, msg));
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+/**
+ * benchmarks of hot library paths. set MINISTL_PERF_BASELINE to a file to
+ * compare against it (MINISTL_PERF_THRESHOLD, default 0.2, is the allowed
+ * slowdown), and MINISTL_PERF_RECORD=1 to write the current numbers there.
+ */
+static test_result test_benchmarks() {
+    int score = 0, full_score = 0;
+    ministl::vector<ministl::perf_report> reports;
+
+    int n = 1 << 20;
+    reports.push_back(ministl::measure_best("vector_push_back", n, 3, [n] {
+        ministl::vector<int> vec;
+        for (int i = 0; i < n; i ++ ) vec.push_back(i);
+    }));
+
+    // work queue at a steady depth of 4096
+    reports.push_back(ministl::measure_best("deque_queue_churn", n, 3, [n] {
+        ministl::deque<int> queue;
+        for (int i = 0; i < 4096; i ++ ) queue.push_back(i);
+        for (int i = 0; i < n; i ++ ) queue.push_back(queue.front() + i), queue.pop_front();
+    }));
+
+    int m = 1 << 16;
+    ministl::vector<int> input;
+    for (int i = 0; i < m; i ++ ) input.push_back(std::rand());
+    reports.push_back(ministl::measure_best("sort", m, 3, [&input] {
+        auto vec = input;
+        ministl::sort(vec.begin(), vec.end());
+    }));
+    reports.push_back(ministl::measure_best("stable_sort", m, 3, [&input] {
+        auto vec = input;
+        ministl::stable_sort(vec.begin(), vec.end());
+    }));
+
+    // 4096 rows of 16 candidates: one sort call per row against one batched call
+    int rows = 1 << 12, row_len = 16;
+    ministl::vector<int> candidates;
+    for (int i = 0; i < rows * row_len; i ++ ) candidates.push_back(std::rand());
+    reports.push_back(ministl::measure_best("sort_per_row_16", rows * row_len, 3, [&] {
+        auto vec = candidates;
+        for (int r = 0; r < rows; r ++ ) ministl::sort(vec.begin() + r * row_len, vec.begin() + (r + 1) * row_len);
+    }));
+    reports.push_back(ministl::measure_best("sort_small_per_row_16", rows * row_len, 3, [&] {
+        auto vec = candidates;
+        for (int r = 0; r < rows; r ++ ) ministl::sort_small(vec.begin() + r * row_len, vec.begin() + (r + 1) * row_len);
+    }));
+    reports.push_back(ministl::measure_best("sort_many_16", rows * row_len, 3, [&] {
+        auto vec = candidates;
+        ministl::sort_many(vec.begin(), vec.end(), row_len);
+    }));
+
+    // 200 byte records: direct sort moves whole records, sort_by_key moves keys
+    struct wide {
+        int key;
+        char payload[196];
+    };
+    int w = 1 << 14;
+    ministl::vector<wide> wide_input(w);
+    for (int i = 0; i < w; i ++ ) wide_input[i].key = std::rand();
+    auto wide_less = [](const wide& a, const wide& b) { return a.key < b.key; };
+    reports.push_back(ministl::measure_best("stable_sort_wide", w, 3, [&] {
+        auto vec = wide_input;
+        ministl::stable_sort(vec.begin(), vec.end(), wide_less);
+    }));
+    reports.push_back(ministl::measure_best("sort_by_key_wide", w, 3, [&] {
+        auto vec = wide_input;
+        ministl::sort_by_key(vec.begin(), vec.end(), [](const wide& r) { return r.key; });
+    }));
+
+    // scans from the back through reverse_iterator, unwrapped to the block paths
+    ministl::vector<int> scan(n, 1);
+    scan[0] = 2;
+    reports.push_back(ministl::measure_best("find_reverse", n, 3, [&scan] {
+        auto it = ministl::find(scan.rbegin(), scan.rend(), 2);
+        assert(it.base() == scan.begin() + 1);
+    }));
+    reports.push_back(ministl::measure_best("reverse_reverse", n, 3, [&scan] {
+        ministl::reverse(scan.rbegin(), scan.rend());
+        ministl::reverse(scan.rbegin(), scan.rend());
+    }));
+
+    // column sum, dot product and prefix sum, cache resident
+    int c = 1 << 14;
+    ministl::vector<float> column(c, 0.5f), prefix(c);
+    ministl::vector<double> lhs(c, 0.25), rhs(c, 2.0);
+    reports.push_back(ministl::measure_best("reduce_f32", c, 3, [&column] {
+        volatile float res = ministl::reduce(column.begin(), column.end(), 0.0f);
+        (void)res;
+    }));
+    reports.push_back(ministl::measure_best("dot_f64", c, 3, [&lhs, &rhs] {
+        volatile double res = ministl::transform_reduce(lhs.begin(), lhs.end(), rhs.begin(), 0.0);
+        (void)res;
+    }));
+    reports.push_back(ministl::measure_best("inclusive_scan_f32", c, 3, [&column, &prefix] {
+        ministl::inclusive_scan(column.begin(), column.end(), prefix.begin());
+    }));
+
+    // posting lists of similar size, about a third of the values shared
+    ministl::vector<uint32_t> list1, list2;
+    for (uint32_t i = 0; i < uint32_t(m); i ++ ) {
+        list1.push_back(i * 3 + uint32_t(std::rand()) % 3);
+        list2.push_back(i * 3 + uint32_t(std::rand()) % 3);
+    }
+    ministl::vector<uint32_t> shared(m);
+    reports.push_back(ministl::measure_best("set_intersection_u32", 2 * m, 3, [&] {
+        ministl::set_intersection(list1.begin(), list1.end(), list2.begin(), list2.end(), shared.begin());
+    }));
+
+    // bulk decode of 20 bit values
+    ministl::packed_vector<20> packed;
+    for (int i = 0; i < n; i ++ ) packed.push_back(uint64_t(std::rand()));
+    ministl::vector<uint32_t> unpacked(n);
+    reports.push_back(ministl::measure_best("packed_unpack_20", n, 3, [&] {
+        packed.unpack(0, n, unpacked.begin());
+    }));
+
+    // cache of 4096 entries in front of a lookup, 2 in 3 requests go to 2048 hot keys
+    ministl::vector<uint32_t> requests;
+    for (int i = 0; i < n; i ++ ) requests.push_back(std::rand() % 3 ? std::rand() % 2048 : std::rand());
+    reports.push_back(ministl::measure_best("lru_cache_get_or_insert", n, 3, [&requests] {
+        ministl::lru_cache<uint32_t, uint64_t> cache(4096);
+        for (auto key : requests) cache.get_or_insert(key, [key] { return uint64_t(key) * 7; });
+    }));
+    reports.push_back(ministl::measure_best("sieve_cache_get_or_insert", n, 3, [&requests] {
+        ministl::sieve_cache<uint32_t, uint64_t> cache(4096);
+        for (auto key : requests) cache.get_or_insert(key, [key] { return uint64_t(key) * 7; });
+    }));
+
+    // negative lookups in front of a table: 4M keys inserted (well beyond the caches), half the probes absent
+    {
+        int filter_keys = 1 << 22;
+        ministl::blocked_bloom_filter<uint64_t> bloom(filter_keys);
+        ministl::cuckoo_filter<uint64_t> cuckoo(filter_keys);
+        ministl::vector<uint64_t> inserted;
+        for (int i = 0; i < filter_keys; i ++ ) inserted.push_back(uint64_t(i) * 2);
+        bloom.insert_batch(inserted.begin(), inserted.end());
+        cuckoo.insert_batch(inserted.begin(), inserted.end());
+        ministl::vector<uint64_t> probes;
+        for (int i = 0; i < n; i ++ ) probes.push_back(uint64_t(std::rand()) % (4 * uint64_t(filter_keys)));
+        ministl::vector<bool> found(n, false);
+        reports.push_back(ministl::measure_best("bloom_contains", n, 3, [&] {
+            for (int i = 0; i < n; i ++ ) found[i] = bloom.contains(probes[i]);
+        }));
+        reports.push_back(ministl::measure_best("bloom_contains_batch", n, 3, [&] {
+            bloom.contains_batch(probes.begin(), probes.end(), found.begin());
+        }));
+        reports.push_back(ministl::measure_best("cuckoo_contains", n, 3, [&] {
+            for (int i = 0; i < n; i ++ ) found[i] = cuckoo.contains(probes[i]);
+        }));
+        reports.push_back(ministl::measure_best("cuckoo_contains_batch", n, 3, [&] {
+            cuckoo.contains_batch(probes.begin(), probes.end(), found.begin());
+        }));
+    }
+
+    // shared map, read heavy (95% find) and mixed (50% find, 50% upsert), 1 to 64 threads
+    for (int write_percent : {5, 50}) {
+        for (int threads = 1; threads <= 64; threads *= 2) {
+            ministl::concurrent_hash_map<uint64_t, uint64_t> map;
+            const uint64_t keys = 1 << 16;
+            for (uint64_t k = 0; k < keys; k ++ ) map.insert(k, k);
+            int total = 1 << 18;
+            auto name = std::string(write_percent == 5 ? "chm_read_heavy_t" : "chm_mixed_t") + std::to_string(threads);
+            reports.push_back(ministl::measure_best(name, total, 1, [&] {
+                ministl::vector<std::thread> workers;
+                for (int t = 0; t < threads; t ++ ) {
+                    workers.push_back(std::thread([&map, t, threads, total, write_percent, keys] {
+                        uint64_t x = t * 0x9e3779b97f4a7c15ULL + 1, val;
+                        for (int i = 0; i < total / threads; i ++ ) {
+                            x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+                            if (int(x % 100) < write_percent) {
+                                map.upsert(x % keys, 0, [](uint64_t& cur) { cur ++ ; });
+                            } else {
+                                map.find(x % keys, val);
+                            }
+                        }
+                    }));
+                }
+                for (auto& w : workers) w.join();
+            }));
+        }
+    }
+
+    for (auto& report : reports) {
+        std::ostringstream text;
+        text << report;
+        debug(text.str());
+    }
+
+    auto path = std::getenv("MINISTL_PERF_BASELINE");
+    if (path) {
+        auto threshold_env = std::getenv("MINISTL_PERF_THRESHOLD");
+        double threshold = threshold_env ? std::atof(threshold_env) : 0.2;
+        ministl::perf_baseline baseline;
+        if (std::getenv("MINISTL_PERF_RECORD")) {
+            for (auto& report : reports) baseline.record(report);
+            baseline.save(path);
+        } else if (baseline.load(path)) {
+            for (auto& report : reports) {
+                full_score ++ ;
+                if (baseline.check(report, threshold, std::cerr)) score ++ ;
+            }
+        }
+    }
+    return {score, full_score};
+}
+
+test_result perf_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_counters();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_baseline();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_benchmarks();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
@@ -0,0 +1,137 @@
+#include <cassert>
+#include <ministl/persistent_vector.h>
+#include <ministl/string.h>
+#include <ministl/test.h>
+#include <ministl/vector.h>
+#include <thread>
+
+static test_result test_persistent_push_pop() {
+    int score = 0, full_score = 0;
+    ministl::persistent_vector<int> empty;
+    assert(empty.empty() && empty.begin() == empty.end());
+
+    // cross every level boundary: tail only, one level, two, three
+    const int n = 40000;
+    ministl::vector<ministl::persistent_vector<int>> versions;
+    ministl::persistent_vector<int> cur;
+    for (int i = 0; i < n; i ++ ) {
+        if (i % 997 == 0) versions.push_back(cur);
+        cur = cur.push_back(i);
+    }
+    assert(cur.size() == n);
+    for (int i = 0; i < n; i ++ ) assert(cur[i] == i);
+    // older versions are untouched
+    for (size_t v = 0; v < versions.size(); v ++ ) {
+        auto& old = versions[v];
+        assert(old.size() == v * 997);
+        for (size_t i = 0; i < old.size(); i ++ ) assert(old[i] == int(i));
+    }
+    score ++ , full_score ++ ;
+
+    auto popped = cur;
+    for (int i = n; i > 0; i -- ) {
+        assert(popped.size() == size_t(i) && popped.back() == i - 1);
+        popped = popped.pop_back();
+    }
+    assert(popped.empty() && cur.size() == n && cur[n - 1] == n - 1);
+    score ++ , full_score ++ ;
+
+    int expect = 0;
+    for (auto val : cur) assert(val == expect ++ );
+    assert(expect == n && cur.end() - cur.begin() == n);
+    static_assert(ministl::is_random_access_iterator<ministl::persistent_vector<int>::const_iterator>::value);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_persistent_set() {
+    int score = 0, full_score = 0;
+    ministl::persistent_vector<ministl::string> base;
+    for (int i = 0; i < 2000; i ++ ) base = base.push_back(ministl::string("value"));
+    auto changed = base.set(0, "first").set(1500, "middle").set(1999, "last");
+    assert(changed[0] == "first" && changed[1500] == "middle" && changed[1999] == "last");
+    assert(base[0] == "value" && base[1500] == "value" && base[1999] == "value");
+    assert(!(changed == base) && changed.size() == base.size());
+    assert(changed.set(0, "value").set(1500, "value").set(1999, "value") == base);
+    score ++ , full_score ++ ;
+
+    bool thrown = false;
+    try {
+        base.set(2000, "out");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_persistent_transient() {
+    int score = 0, full_score = 0;
+    ministl::persistent_vector<int> small = {1, 2, 3};
+    assert(small.size() == 3 && small[2] == 3);
+
+    auto t = small.transient();
+    for (int i = 0; i < 5000; i ++ ) t.push_back(i);
+    t.set(0, 100);
+    t.set(100, -1);
+    auto built = t.persistent();
+    assert(t.size() == 0);
+    // the source version shares nodes with the builder but never sees its writes
+    assert((small == ministl::persistent_vector<int> {1, 2, 3}));
+    assert(built.size() == 5003 && built[0] == 100 && built[1] == 2 && built[100] == -1 && built[5002] == 4999);
+    score ++ , full_score ++ ;
+
+    // writes to shared leaves go to private copies
+    auto t2 = built.transient();
+    for (size_t i = 0; i < t2.size(); i ++ ) t2.set(i, 7);
+    auto sevens = t2.persistent();
+    assert(built[0] == 100 && built[4000] == 3997);
+    for (auto val : sevens) assert(val == 7);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_persistent_threads() {
+    int score = 0, full_score = 0;
+    ministl::persistent_vector<int> cur;
+    for (int i = 0; i < 10000; i ++ ) cur = cur.push_back(i);
+
+    // a reader thread keeps its snapshot while the writer derives new versions
+    auto snapshot = cur;
+    bool ok = true;
+    std::thread reader([snapshot, &ok] {
+        for (int round = 0; round < 20; round ++ ) {
+            long long sum = 0;
+            for (auto val : snapshot) sum += val;
+            ok = ok && sum == 10000LL * 9999 / 2;
+        }
+    });
+    for (int i = 0; i < 10000; i ++ ) cur = cur.set(i, 0);
+    reader.join();
+    assert(ok && snapshot[9999] == 9999 && cur[9999] == 0);
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result persistent_vector_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_persistent_push_pop();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_persistent_set();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_persistent_transient();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_persistent_threads();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
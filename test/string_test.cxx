@@ -0,0 +1,134 @@
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <ministl/string.h>
+#include <ministl/test.h>
+
+static test_result test_sso() {
+    int score = 0, full_score = 0;
+    static_assert(sizeof (ministl::string) == 24);
+
+    { // short string stays inline
+        ministl::string s = "hello";
+        assert(s.size() == 5 && s.capacity() == 23);
+        assert(std::strcmp(s.c_str(), "hello") == 0);
+        assert(s.c_str() >= reinterpret_cast<const char *>(&s) &&
+                s.c_str() < reinterpret_cast<const char *>(&s) + sizeof (s));
+        score ++ , full_score ++ ;
+    }
+
+    { // 23 chars is the largest inline string
+        ministl::string s(23, 'x');
+        assert(s.size() == 23 && s.capacity() == 23 && s.c_str()[23] == '\0');
+        s.push_back('y');
+        assert(s.size() == 24 && s.capacity() >= 24 && s.back() == 'y');
+        assert(s[0] == 'x' && s.c_str()[24] == '\0');
+        score ++ , full_score ++ ;
+    }
+
+    { // copy and move in both modes
+        ministl::string a = "short", b(40, 'l');
+        auto c = a, d = b;
+        auto e = std::move(a), f = std::move(b);
+        assert(a.empty() && b.empty());
+        assert(c == e && d == f && f.size() == 40);
+        c = d;
+        assert(c == d);
+        score ++ , full_score ++ ;
+    }
+
+    return {score, full_score};
+}
+
+static test_result test_append() {
+    int score = 0, full_score = 0;
+
+    { // one growth per append
+        ministl::string s = "abc";
+        s.append(ministl::string(100, 'z'));
+        assert(s.size() == 103 && s.capacity() >= 103);
+        assert(s.starts_with("abcz") && s.ends_with("zzz"));
+        score ++ , full_score ++ ;
+    }
+
+    { // self append
+        ministl::string s(20, 'a');
+        s.append(s.data(), s.size());
+        assert(s == ministl::string(40, 'a'));
+        score ++ , full_score ++ ;
+    }
+
+    { // operator+
+        ministl::string a = "foo", b = "bar";
+        auto c = a + b + "baz";
+        assert(c == "foobarbaz");
+        c += '!';
+        assert(c.size() == 10 && c.back() == '!');
+        score ++ , full_score ++ ;
+    }
+
+    return {score, full_score};
+}
+
+static test_result test_find_compare() {
+    int score = 0, full_score = 0;
+    ministl::string s = "the quick brown fox jumps over the lazy dog";
+
+    assert(s.find('q') == 4);
+    assert(s.find('!') == ministl::string::npos);
+    assert(s.find("the") == 0 && s.find("the", 1) == 31);
+    assert(s.find("dog") == s.size() - 3);
+    assert(s.find("cat") == ministl::string::npos);
+    assert(s.rfind('o') == s.size() - 2);
+    score ++ , full_score ++ ;
+
+    assert(ministl::string("abc") < ministl::string("abd"));
+    assert(ministl::string("ab") < ministl::string("abc"));
+    assert(ministl::string("\xff").compare("a") > 0);
+    // plain char is signed here, strings still order bytes as unsigned like std::string
+    assert((ministl::string_view("\x80") > ministl::string_view("\x7f")) == (std::string("\x80") > std::string("\x7f")));
+    assert(ministl::string_view("ab\xff").compare("ab") > 0 && ministl::string_view().compare("") == 0);
+    assert(s.substr(4, 5) == "quick");
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+static test_result test_string_view() {
+    int score = 0, full_score = 0;
+    ministl::string s = "hello world";
+    ministl::string_view sv = s;
+    assert(sv.size() == s.size() && sv.data() == s.data());
+    sv.remove_prefix(6);
+    assert(sv == "world" && sv.find('r') == 2);
+    assert(ministl::string(sv) == "world");
+    score ++ , full_score ++ ;
+
+    // iterators and reverse iterators
+    ministl::string rev;
+    for (auto it = sv.rbegin(); it != sv.rend(); it ++ ) rev.push_back(*it);
+    assert(rev == "dlrow");
+    ministl::reverse(s.begin(), s.end());
+    assert(s == "dlrow olleh");
+    score ++ , full_score ++ ;
+
+    return {score, full_score};
+}
+
+test_result string_test() {
+    int score = 0, full_score = 0;
+
+    auto tmp = test_sso();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_append();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_find_compare();
+    score += tmp.first, full_score += tmp.second;
+
+    tmp = test_string_view();
+    score += tmp.first, full_score += tmp.second;
+
+    return {score, full_score};
+}
@@ -1,8 +1,11 @@
 #include <cassert>
 #include <ministl/log.h>
 #include <ministl/vector.h>
+#include <ministl/large_page_allocator.h>
 #include <ministl/test.h>
 #include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
 
 struct test_struct {
     int field_a, field_b;
@@ -278,6 +281,54 @@ static test_result test_emplace() {
     return {score, full_score};
 }
 
+static test_result test_large_page_allocator() {
+    int score = 0, full_score = 0;
+    constexpr size_t huge_page = size_t(2) << 20;
+
+    { // big buffers are 2 MiB aligned, and growth keeps the content
+        ministl::vector<int, ministl::large_page_allocator<ministl::numa_policy::interleave>> vec(1 << 20, 7);
+        assert(reinterpret_cast<uintptr_t>(vec.begin()) % huge_page == 0);
+        for (int i = 0; i < vec.size(); i ++ ) assert(vec[i] == 7);
+        for (int i = 0; i < (1 << 20); i ++ ) vec.push_back(i);
+        assert(vec.size() == (2 << 20) && vec[(1 << 20) + 42] == 42);
+        score ++ , full_score ++ ;
+    }
+
+    { // explicit hugetlb falls back to transparent huge pages when the pool is empty
+        ministl::vector<char, ministl::large_page_allocator<ministl::numa_policy::local, true>> vec(3 << 20, 'x');
+        assert(reinterpret_cast<uintptr_t>(vec.begin()) % huge_page == 0);
+        assert(vec[0] == 'x' && vec[(3 << 20) - 1] == 'x');
+        score ++ , full_score ++ ;
+    }
+
+    { // parallel first touch, with the threshold lowered: every page is resident and filled
+        using touch_alloc = ministl::large_page_allocator<ministl::numa_policy::none, false, (size_t(4) << 20)>;
+        size_t n = (size_t(9) << 20) + 123, bytes = n * sizeof (int64_t);
+        for (unsigned threads : {2u, 3u, 8u}) {
+            auto buf = static_cast<int64_t*>(touch_alloc::allocate(bytes));
+            touch_alloc::uninitialized_fill(buf, n, int64_t(0), threads);
+            auto page = size_t(sysconf(_SC_PAGESIZE));
+            ministl::vector<unsigned char> resident((bytes + page - 1) / page, 0);
+            assert(mincore(buf, bytes, resident.begin()) == 0);
+            for (auto r : resident) assert(r & 1);
+            for (size_t i = 0; i < n; i ++ ) assert(buf[i] == 0);
+            touch_alloc::uninitialized_fill(buf, n, int64_t(-3), threads);
+            for (size_t i = 0; i < n; i ++ ) assert(buf[i] == -3);
+            touch_alloc::deallocate(buf, bytes);
+        }
+        score ++ , full_score ++ ;
+    }
+
+    { // small buffers come from the default allocator
+        ministl::vector<int, ministl::large_page_allocator<>> vec = {1, 2, 3};
+        auto copy = vec;
+        assert(copy.size() == 3 && copy[2] == 3);
+        score ++ , full_score ++ ;
+    }
+
+    return {score, full_score};
+}
+
 test_result vector_test() {
     int score = 0, full_score = 0;
 
@@ -323,5 +374,8 @@ test_result vector_test() {
     tmp = test_emplace();
     score += tmp.first, full_score += tmp.second;
 
+    tmp = test_large_page_allocator();
+    score += tmp.first, full_score += tmp.second;
+
     return {score, full_score};
 }